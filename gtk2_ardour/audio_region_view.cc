@@ -128,6 +128,7 @@ AudioRegionView::AudioRegionView (ArdourCanvas::Container *parent, RouteTimeAxis
 	, _amplitude_above_axis(1.0)
 	, trim_fade_in_drag_active(false)
 	, trim_fade_out_drag_active(false)
+	, _peak_build_percent (-1)
 {
 }
 
@@ -148,6 +149,7 @@ AudioRegionView::AudioRegionView (ArdourCanvas::Container *parent, RouteTimeAxis
 	, _amplitude_above_axis(1.0)
 	, trim_fade_in_drag_active(false)
 	, trim_fade_out_drag_active(false)
+	, _peak_build_percent (-1)
 {
 }
 
@@ -167,6 +169,7 @@ AudioRegionView::AudioRegionView (const AudioRegionView& other, boost::shared_pt
 	, _amplitude_above_axis (other._amplitude_above_axis)
 	, trim_fade_in_drag_active(false)
 	, trim_fade_out_drag_active(false)
+	, _peak_build_percent (-1)
 {
 	init (true);
 }
@@ -403,6 +406,16 @@ AudioRegionView::region_renamed ()
 		str += tmp;
 	}
 
+	double eta;
+	_peak_build_percent = peak_build_percent (eta);
+	if (_peak_build_percent >= 0) {
+		if (eta >= 0) {
+			str += string_compose (_(" (building peaks %1%%, %2 s left)"), _peak_build_percent, (int) ceil (eta));
+		} else {
+			str += string_compose (_(" (building peaks %1%%)"), _peak_build_percent);
+		}
+	}
+
 	set_item_name (str, this);
 	set_name_text (str);
 }
@@ -1160,6 +1173,7 @@ AudioRegionView::delete_waves ()
 		delete *i;
 	}
 	_data_ready_connections.clear ();
+	_peak_range_connections.drop_connections ();
 
 	for (vector<ArdourWaveView::WaveView*>::iterator w = waves.begin(); w != waves.end(); ++w) {
 		group->remove(*w);
@@ -1199,6 +1213,7 @@ AudioRegionView::create_waves ()
 	}
 
 	_data_ready_connections.clear ();
+	_peak_range_connections.drop_connections ();
 
 	for (uint32_t i = 0; i < nchans.n_audio(); ++i) {
 		_data_ready_connections.push_back (0);
@@ -1221,6 +1236,7 @@ AudioRegionView::create_waves ()
 				// we'll get a PeaksReady signal from the source in the future
 				// and will call create_one_wave(n) then.
 				pending_peak_data->show ();
+				audio_region()->audio_source(n)->PeakRangeReady.connect (_peak_range_connections, invalidator (*this), boost::bind (&AudioRegionView::peak_range_ready_handler, this), gui_context());
 			}
 
 		} else {
@@ -1325,6 +1341,7 @@ AudioRegionView::create_one_wave (uint32_t which, bool /*direct*/)
 
 		/* indicate peak-completed */
 		pending_peak_data->hide ();
+		_peak_range_connections.drop_connections ();
 
 		/* Restore stacked coverage */
 		LayerDisplay layer_display;
@@ -1337,6 +1354,11 @@ AudioRegionView::create_one_wave (uint32_t which, bool /*direct*/)
 	delete _data_ready_connections[which];
 	_data_ready_connections[which] = 0;
 
+	if (_peak_build_percent >= 0) {
+		/* drop the progress from the name once nothing is pending */
+		region_renamed ();
+	}
+
 	maybe_raise_cue_markers ();
 }
 
@@ -1347,6 +1369,47 @@ AudioRegionView::peaks_ready_handler (uint32_t which)
 	// cerr << "AudioRegionView::peaks_ready_handler() called on " << which << " this: " << this << endl;
 }
 
+void
+AudioRegionView::peak_range_ready_handler ()
+{
+	double eta;
+	if (peak_build_percent (eta) != _peak_build_percent) {
+		region_renamed ();
+	}
+}
+
+/** @return the smallest build progress, in percent, of all channels that
+ *  are still waiting for peaks, or -1 if none of them is being built.
+ *  @param[out] eta largest estimated time until completion, in seconds.
+ */
+int
+AudioRegionView::peak_build_percent (double& eta) const
+{
+	float min_fraction = 1.f;
+	bool  building = false;
+
+	eta = -1;
+
+	for (uint32_t n = 0; n < _data_ready_connections.size () && n < audio_region()->n_channels(); ++n) {
+		if (_data_ready_connections[n] == 0) {
+			continue;
+		}
+		float  fraction;
+		double channel_eta;
+		if (!audio_region()->audio_source(n)->peak_build_progress (fraction, channel_eta)) {
+			continue;
+		}
+		building     = true;
+		min_fraction = std::min (min_fraction, fraction);
+		eta          = std::max (eta, channel_eta);
+	}
+
+	if (!building) {
+		return -1;
+	}
+	return (int) floorf (min_fraction * 100.f);
+}
+
 void
 AudioRegionView::add_gain_point_event (ArdourCanvas::Item *item, GdkEvent *ev, bool with_guard_points)
 {
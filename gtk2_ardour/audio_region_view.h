@@ -197,6 +197,8 @@ protected:
 
 	void create_one_wave (uint32_t, bool);
 	void peaks_ready_handler (uint32_t);
+	void peak_range_ready_handler ();
+	int  peak_build_percent (double& eta) const;
 
 	void set_colors ();
 	void set_waveform_colors ();
@@ -222,6 +224,10 @@ private:
 	 */
 	std::vector<PBD::ScopedConnection*> _data_ready_connections;
 
+	/** PeakRangeReady callbacks of sources whose peakfile is still being built */
+	PBD::ScopedConnectionList _peak_range_connections;
+	int _peak_build_percent; ///< last progress shown in the name, or -1
+
 	/** RegionViews that we hid the xfades for at the start of the current drag;
 	 *  first list is for start xfades, second list is for end xfades.
 	 */
@@ -1179,6 +1179,8 @@ AutomationTimeAxisView::cut_copy_clear_one (AutomationLine& line, Selection& sel
 			(*x)->when = when;
 			(*x)->value = val;
 		}
+		/* events were modified in place, invalidate the list's cached index */
+		what_we_got->mark_dirty ();
 	}
 }
 
@@ -18,11 +18,16 @@
 
 #include <gtkmm/frame.h>
 
+#include "pbd/compose.h"
+
 #include "gtkmm2ext/utils.h"
 
 #include "ardour/session.h"
 #include "ardour/audioengine.h"
 #include "ardour/audio_backend.h"
+#include "ardour/disk_reader.h"
+#include "ardour/graph.h"
+#include "ardour/track.h"
 
 #include "widgets/tooltips.h"
 
@@ -39,6 +44,9 @@ using namespace Gtk;
 
 DspStatisticsGUI::DspStatisticsGUI ()
 	: buffer_size_label ("", ALIGN_END, ALIGN_CENTER)
+	, graph_label ("", ALIGN_END, ALIGN_CENTER)
+	, critical_path_label ("", ALIGN_END, ALIGN_CENTER)
+	, disk_refill_label ("", ALIGN_END, ALIGN_CENTER)
 	, reset_button (_("Reset"))
 {
 	const size_t nlabels = Session::NTT + AudioEngine::NTT + AudioBackend::NTT;
@@ -80,6 +88,21 @@ DspStatisticsGUI::DspStatisticsGUI ()
 	table.attach (*labels[AudioEngine::NTT + Session::OverallProcess], 2, 3, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
 	row++;
 
+	Label* right_angle_text3 = manage (new Label ("\xe2\x94\x94", ALIGN_END, ALIGN_CENTER));
+
+	table.attach (*manage (new Gtk::Label (_("Graph: "), ALIGN_END, ALIGN_CENTER)), 1, 2, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	table.attach (*right_angle_text3, 0, 1, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	table.attach (graph_label, 2, 3, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	row++;
+
+	table.attach (*manage (new Gtk::Label (_("Critical path: "), ALIGN_END, ALIGN_CENTER)), 1, 2, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	table.attach (critical_path_label, 2, 3, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	row++;
+
+	table.attach (*manage (new Gtk::Label (_("Disk refill: "), ALIGN_END, ALIGN_CENTER)), 0, 1, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	table.attach (disk_refill_label, 2, 3, row, row+1, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	row++;
+
 	HBox* hbox2 = manage (new HBox);
 	hbox2->pack_start (reset_button, true, true);
 
@@ -259,6 +282,9 @@ DspStatisticsGUI::update ()
 
 		ArdourWidgets::set_tooltip (labels[AudioEngine::ProcessCallback], buf);
 
+		update_graph_stats (bufsize_usecs, bufsize_msecs);
+		update_disk_stats ();
+
 	} else {
 
 		if (max > 1000) {
@@ -282,7 +308,139 @@ DspStatisticsGUI::update ()
 
 		labels[AudioEngine::NTT + Session::OverallProcess]->set_text (_("No session loaded"));
 		ArdourWidgets::set_tooltip (labels[AudioEngine::NTT + Session::OverallProcess], "");
+
+		graph_label.set_text ("");
+		ArdourWidgets::set_tooltip (graph_label, "");
+		critical_path_label.set_text ("");
+		ArdourWidgets::set_tooltip (critical_path_label, "");
+		disk_refill_label.set_text ("");
+		ArdourWidgets::set_tooltip (disk_refill_label, "");
+	}
+}
+
+void
+DspStatisticsGUI::update_graph_stats (double bufsize_usecs, double bufsize_msecs)
+{
+	boost::shared_ptr<Graph> graph = _session->process_graph ();
+
+	if (!graph) {
+		graph_label.set_text (X_("--"));
+		ArdourWidgets::set_tooltip (graph_label, _("Single threaded processing"));
+		critical_path_label.set_text (X_("--"));
+		ArdourWidgets::set_tooltip (critical_path_label, "");
+		return;
+	}
+
+	std::vector<Graph::SchedulerStats> stats;
+	PBD::TimingStats timing;
+	graph->get_stats (stats, timing);
+
+	PBD::microseconds_t min = 0;
+	PBD::microseconds_t max = 0;
+	double avg = 0.;
+	double dev = 0.;
+	char buf[64];
+
+	if (timing.get_stats (min, max, avg, dev)) {
+		if (max > 1000) {
+			double maxf = max / 1000.0;
+			snprintf (buf, sizeof (buf), "%7.2f %s %5.2f%%", maxf, _("msec"), (100.0 * maxf) / bufsize_msecs);
+		} else {
+			snprintf (buf, sizeof (buf), "%" PRId64 " %s %5.2f%%", max, _("usec"), (100.0 * max) / bufsize_usecs);
+		}
+		graph_label.set_text (buf);
+	} else {
+		graph_label.set_text (X_("--"));
 	}
+
+	Graph::SchedulerStats total;
+	for (std::vector<Graph::SchedulerStats>::const_iterator i = stats.begin (); i != stats.end (); ++i) {
+		total.nodes_run     += i->nodes_run;
+		total.local_pops    += i->local_pops;
+		total.shared_pops   += i->shared_pops;
+		total.steals        += i->steals;
+		total.failed_steals += i->failed_steals;
+		total.sleeps        += i->sleeps;
+	}
+
+	std::string tip = string_compose (_("Scheduler: %1\nThreads: %2\nRoutes processed: %3"),
+	                                  graph->work_stealing () ? _("work-stealing") : _("shared queue"),
+	                                  stats.size (), total.nodes_run);
+
+	if (graph->work_stealing ()) {
+		tip += string_compose (_("\nTaken from own queue: %1\nTaken from shared queue: %2\nStolen: %3\nFailed steal attempts: %4"),
+		                       total.local_pops, total.shared_pops, total.steals, total.failed_steals);
+	}
+
+	tip += string_compose (_("\nThread sleeps: %1"), total.sleeps);
+	ArdourWidgets::set_tooltip (graph_label, tip);
+
+	/* estimated critical path, from measured per route processing time */
+	PBD::microseconds_t path;
+	PBD::microseconds_t work;
+
+	if (graph->critical_path (path, work) && path > 0) {
+		if (path > 1000) {
+			double pathf = path / 1000.0;
+			snprintf (buf, sizeof (buf), "%7.2f %s %5.2f%%", pathf, _("msec"), (100.0 * pathf) / bufsize_msecs);
+		} else {
+			snprintf (buf, sizeof (buf), "%" PRId64 " %s %5.2f%%", path, _("usec"), (100.0 * path) / bufsize_usecs);
+		}
+		critical_path_label.set_text (buf);
+		snprintf (buf, sizeof (buf), "%.1f", (double) work / path);
+		ArdourWidgets::set_tooltip (critical_path_label,
+				string_compose (_("Longest chain of routes that depend on each other.\nTotal route processing time: %1 usec\nMaximum speedup by parallel processing: %2"),
+				                work, buf));
+	} else {
+		critical_path_label.set_text (X_("--"));
+		ArdourWidgets::set_tooltip (critical_path_label, "");
+	}
+}
+
+void
+DspStatisticsGUI::update_disk_stats ()
+{
+	/* worst case time of a single track refill (butler thread),
+	 * and the read throughput of all tracks combined.
+	 */
+	PBD::microseconds_t max_refill = 0;
+	double samples_per_sec = 0;
+	size_t n_tracks = 0;
+
+	boost::shared_ptr<RouteList> rl = _session->get_routes ();
+	for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+		if (!tr || !tr->disk_reader ()) {
+			continue;
+		}
+		PBD::microseconds_t min, max;
+		double avg, dev, sps;
+		if (!tr->disk_reader ()->refill_stats (min, max, avg, dev, sps)) {
+			continue;
+		}
+		max_refill = std::max (max_refill, max);
+		samples_per_sec += sps;
+		++n_tracks;
+	}
+
+	if (n_tracks == 0) {
+		disk_refill_label.set_text (X_("--"));
+		ArdourWidgets::set_tooltip (disk_refill_label, "");
+		return;
+	}
+
+	char buf[64];
+	if (max_refill > 1000) {
+		snprintf (buf, sizeof (buf), "%7.2f %s", max_refill / 1000.0, _("msec"));
+	} else {
+		snprintf (buf, sizeof (buf), "%" PRId64 " %s", max_refill, _("usec"));
+	}
+	disk_refill_label.set_text (buf);
+
+	snprintf (buf, sizeof (buf), "%.1f", samples_per_sec / 1e6);
+	ArdourWidgets::set_tooltip (disk_refill_label,
+			string_compose (_("Longest buffer refill of a single track.\nTracks read from disk: %1\nRead throughput: %2 Msamples/sec"),
+			                n_tracks, buf));
 }
 
 bool
@@ -39,11 +39,16 @@ protected:
 
 private:
 	void update ();
+	void update_graph_stats (double bufsize_usecs, double bufsize_msecs);
+	void update_disk_stats ();
 
 	sigc::connection update_connection;
 
 	Gtk::Table table;
 	Gtk::Label buffer_size_label;
+	Gtk::Label graph_label;
+	Gtk::Label critical_path_label;
+	Gtk::Label disk_refill_label;
 	Gtk::Label** labels;
 	Gtk::Button reset_button;
 	Gtk::Label info_text;
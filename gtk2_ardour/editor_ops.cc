@@ -5340,8 +5340,10 @@ void
 Editor::reset_point_selection ()
 {
 	for (PointSelection::iterator i = selection->points.begin(); i != selection->points.end(); ++i) {
+		boost::shared_ptr<ARDOUR::AutomationList> alist = (*i)->line().the_list();
 		ARDOUR::AutomationList::iterator j = (*i)->model ();
-		(*j)->value = (*i)->line().the_list()->descriptor ().normal;
+		/* go through the list, so that its cached event index is invalidated */
+		alist->modify (j, (*j)->when, alist->descriptor ().normal);
 	}
 }
 
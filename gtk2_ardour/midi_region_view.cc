@@ -260,8 +260,15 @@ MidiRegionView::init (bool /*wfd*/)
 
 	PublicEditor::DropDownKeys.connect (sigc::mem_fun (*this, &MidiRegionView::drop_down_keys));
 
-	_model = midi_region()->midi_source(0)->model();
-	assert (_model);
+	/* a model that has not been loaded yet is only loaded once the
+	 * notes are edited, see ensure_model(). Until then they are drawn
+	 * from the source.
+	 */
+	_model = midi_region()->midi_source(0)->loaded_model();
+
+	midi_region()->midi_source(0)->ModelChanged.connect (_source_model_connection, invalidator (*this),
+	                                                     boost::bind (&MidiRegionView::source_model_changed, this),
+	                                                     gui_context ());
 
 	fill_color_name = "midi frame base";
 
@@ -335,6 +342,9 @@ MidiRegionView::canvas_group_event(GdkEvent* ev)
 	//For now, move the snapped cursor aside so it doesn't bother you during internal editing
 	//trackview.editor().set_snapped_cursor_position(_region->position());
 
+	/* notes can be edited from here on, so they must come from the model */
+	ensure_model ();
+
 	bool r;
 
 	switch (ev->type) {
@@ -851,6 +861,8 @@ MidiRegionView::show_list_editor ()
 void
 MidiRegionView::create_note_at (timepos_t const & t, double y, Temporal::Beats length, uint32_t state, bool shift_snap)
 {
+	ensure_model ();
+
 	if (length < Temporal::Beats::one_tick()) {
 		return;
 	}
@@ -917,18 +929,60 @@ MidiRegionView::clear_events ()
 void
 MidiRegionView::display_model (boost::shared_ptr<MidiModel> model)
 {
+	_source_notes.clear ();
+
+	if (!model && !midi_region()->midi_source(0)->read_notes (_source_notes)) {
+		/* the source can only provide its notes via the model */
+		ensure_model ();
+		return;
+	}
+
 	_model = model;
 
 	content_connection.disconnect ();
-	_model->ContentsChanged.connect (content_connection, invalidator (*this), boost::bind (&MidiRegionView::model_changed, this), gui_context());
+	if (_model) {
+		_model->ContentsChanged.connect (content_connection, invalidator (*this), boost::bind (&MidiRegionView::model_changed, this), gui_context());
+	}
 	/* Don't signal as nobody else needs to know until selection has been altered. */
 	clear_events();
 	model_changed ();
 }
 
+/** Load the source's model if that has not happened yet, and display it
+ * instead of the notes read from the source. Must be called before anything
+ * that uses or edits the model, but never while a NoteBase of this view is
+ * in use, since they are all replaced.
+ */
+void
+MidiRegionView::ensure_model ()
+{
+	if (_model) {
+		return;
+	}
+
+	boost::shared_ptr<MidiModel> m = midi_region()->midi_source(0)->model ();
+
+	/* loading the model may already have displayed it, via source_model_changed() */
+	if (!_model && m) {
+		display_model (m);
+	}
+}
+
+void
+MidiRegionView::source_model_changed ()
+{
+	boost::shared_ptr<MidiModel> m = midi_region()->midi_source(0)->loaded_model ();
+
+	if (!_model && m) {
+		display_model (m);
+	}
+}
+
 void
 MidiRegionView::start_note_diff_command (string name)
 {
+	ensure_model ();
+
 	if (!_note_diff_command) {
 		trackview.editor().begin_reversible_command (name);
 		_note_diff_command = _model->new_note_diff_command (name);
@@ -1086,6 +1140,8 @@ MidiRegionView::find_canvas_sys_ex (MidiModel::SysExPtr s)
 void
 MidiRegionView::get_events (Events& e, Evoral::Sequence<Temporal::Beats>::NoteOperator op, uint8_t val, int chan_mask)
 {
+	ensure_model ();
+
 	MidiModel::Notes notes;
 	_model->get_notes (notes, op, val, chan_mask);
 
@@ -1133,10 +1189,6 @@ MidiRegionView::model_changed()
 		return;
 	}
 
-	if (!_model) {
-		return;
-	}
-
 	for (_optimization_iterator = _events.begin(); _optimization_iterator != _events.end(); ++_optimization_iterator) {
 		_optimization_iterator->second->invalidate();
 	}
@@ -1147,8 +1199,11 @@ MidiRegionView::model_changed()
 	Note* sus = NULL;
 	Hit*  hit = NULL;
 
-	MidiModel::ReadLock lock(_model->read_lock());
-	MidiModel::Notes& notes (_model->notes());
+	MidiModel::ReadLock lock;
+	if (_model) {
+		lock = _model->read_lock();
+	}
+	MidiModel::Notes& notes (_model ? _model->notes() : _source_notes);
 
 	NoteBase* cne;
 
@@ -1284,10 +1339,6 @@ MidiRegionView::view_changed()
 		return;
 	}
 
-	if (!_model) {
-		return;
-	}
-
 	Note* sus = NULL;
 	Hit*  hit = NULL;
 
@@ -1349,6 +1400,10 @@ MidiRegionView::display_patch_changes ()
 void
 MidiRegionView::display_patch_changes_on_channel (uint8_t channel, bool active_channel)
 {
+	if (!_model) {
+		return;
+	}
+
 	for (MidiModel::PatchChanges::const_iterator i = _model->patch_changes().begin(); i != _model->patch_changes().end(); ++i) {
 		boost::shared_ptr<PatchChange> p;
 
@@ -1409,6 +1464,10 @@ MidiRegionView::display_sysexes()
 	bool have_periodic_system_messages = false;
 	bool display_periodic_messages = true;
 
+	if (!_model) {
+		return;
+	}
+
 	if (!UIConfiguration::instance().get_never_display_periodic_midi()) {
 
 		for (MidiModel::SysExes::const_iterator i = _model->sysexes().begin(); i != _model->sysexes().end(); ++i) {
@@ -1929,6 +1988,13 @@ MidiRegionView::add_note(const boost::shared_ptr<NoteType> note, bool visible)
 	if (event) {
 		MidiGhostRegion* gr;
 
+		if (!_model) {
+			/* notes read from the source are replaced when the model is
+			 * loaded, so they must not be the target of an edit.
+			 */
+			event->set_ignore_events (true);
+		}
+
 		for (std::vector<GhostRegion*>::iterator g = ghosts.begin(); g != ghosts.end(); ++g) {
 			if ((gr = dynamic_cast<MidiGhostRegion*>(*g)) != 0) {
 				gr->add_note(event);
@@ -1964,6 +2030,8 @@ void
 MidiRegionView::step_add_note (uint8_t channel, uint8_t number, uint8_t velocity,
                                Temporal::Beats pos, Temporal::Beats len)
 {
+	ensure_model ();
+
 	boost::shared_ptr<NoteType> new_note (new NoteType (channel, pos, len, number, velocity));
 
 	/* potentially extend region to hold new note */
@@ -1995,6 +2063,8 @@ MidiRegionView::step_add_note (uint8_t channel, uint8_t number, uint8_t velocity
 void
 MidiRegionView::step_sustain (Temporal::Beats beats)
 {
+	ensure_model ();
+
 	change_note_lengths (false, false, beats, false, true);
 }
 
@@ -2053,6 +2123,12 @@ patch_applies (const ARDOUR::MidiModel::constPatchChangePtr pc, Temporal::Beats
 void
 MidiRegionView::get_patch_key_at (Temporal::Beats time, uint8_t channel, MIDI::Name::PatchPrimaryKey& key) const
 {
+	if (!_model) {
+		key.set_bank(0);
+		key.set_program(0);
+		return;
+	}
+
 	// The earliest event not before time
 	MidiModel::PatchChanges::iterator i = _model->patch_change_lower_bound (time);
 
@@ -2140,6 +2216,8 @@ MidiRegionView::change_patch_change (MidiModel::PatchChangePtr old_change, const
 void
 MidiRegionView::add_patch_change (timecnt_t const & t, Evoral::PatchChange<Temporal::Beats> const & patch)
 {
+	ensure_model ();
+
 	string name = _("add patch change");
 
 	trackview.editor().begin_reversible_command (name);
@@ -2281,6 +2359,8 @@ MidiRegionView::unique_select(NoteBase* ev)
 void
 MidiRegionView::select_all_notes ()
 {
+	ensure_model ();
+
 	PBD::Unwinder<bool> uw (_no_sound_notes, true);
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		add_to_selection (i->second);
@@ -2290,6 +2370,8 @@ MidiRegionView::select_all_notes ()
 void
 MidiRegionView::select_range (timepos_t const & start, timepos_t const & end)
 {
+	ensure_model ();
+
 	PBD::Unwinder<bool> uw (_no_sound_notes, true);
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		timepos_t t = _region->source_beats_to_absolute_time (i->first->time());
@@ -2302,6 +2384,8 @@ MidiRegionView::select_range (timepos_t const & start, timepos_t const & end)
 void
 MidiRegionView::extend_selection ()
 {
+	ensure_model ();
+
 	if (_selection.empty()) {
 		return;
 	}
@@ -2335,6 +2419,8 @@ MidiRegionView::extend_selection ()
 void
 MidiRegionView::invert_selection ()
 {
+	ensure_model ();
+
 	PBD::Unwinder<bool> uw (_no_sound_notes, true);
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		if (i->second->selected()) {
@@ -2351,6 +2437,8 @@ MidiRegionView::invert_selection ()
 void
 MidiRegionView::select_notes (list<Evoral::event_id_t> notes, bool allow_audition)
 {
+	ensure_model ();
+
 	NoteBase* cne;
 	list<Evoral::event_id_t>::iterator n;
 
@@ -2368,6 +2456,8 @@ MidiRegionView::select_notes (list<Evoral::event_id_t> notes, bool allow_auditio
 void
 MidiRegionView::select_matching_notes (uint8_t notenum, uint16_t channel_mask, bool add, bool extend)
 {
+	ensure_model ();
+
 	bool have_selection = !_selection.empty();
 	uint8_t low_note = 127;
 	uint8_t high_note = 0;
@@ -2438,6 +2528,8 @@ MidiRegionView::select_matching_notes (uint8_t notenum, uint16_t channel_mask, b
 void
 MidiRegionView::toggle_matching_notes (uint8_t notenum, uint16_t channel_mask)
 {
+	ensure_model ();
+
 	MidiModel::Notes& notes (_model->notes());
 	_optimization_iterator = _events.begin();
 
@@ -3804,6 +3896,8 @@ MidiRegionView::selection_as_cut_buffer () const
 bool
 MidiRegionView::paste (timepos_t const & pos, const ::Selection& selection, PasteContext& ctx)
 {
+	ensure_model ();
+
 	bool commit = false;
 	// Paste notes, if available
 	MidiNoteSelection::const_iterator m = selection.midi_notes.get_nth(ctx.counts.n_notes());
@@ -3901,6 +3995,8 @@ struct EventNoteTimeEarlyFirstComparator {
 void
 MidiRegionView::goto_next_note (bool add_to_selection)
 {
+	ensure_model ();
+
 	bool use_next = false;
 
 	MidiTimeAxisView* const mtv = dynamic_cast<MidiTimeAxisView*>(&trackview);
@@ -3954,6 +4050,8 @@ MidiRegionView::goto_next_note (bool add_to_selection)
 void
 MidiRegionView::goto_previous_note (bool add_to_selection)
 {
+	ensure_model ();
+
 	bool use_next = false;
 
 	MidiTimeAxisView* const mtv = dynamic_cast<MidiTimeAxisView*>(&trackview);
@@ -4007,6 +4105,8 @@ MidiRegionView::goto_previous_note (bool add_to_selection)
 void
 MidiRegionView::selection_as_notelist (Notes& selected, bool allow_all_if_none_selected)
 {
+	ensure_model ();
+
 	bool had_selected = false;
 
 	/* we previously time sorted events here, but Notes is a multiset sorted by time */
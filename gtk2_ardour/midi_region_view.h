@@ -451,6 +451,8 @@ public:
 	typedef std::vector<NoteBase*> CopyDragEvents;
 
 	boost::shared_ptr<ARDOUR::MidiModel> _model;
+	/** Notes read from the source while its model is not loaded */
+	Notes                                _source_notes;
 	Events                               _events;
 	CopyDragEvents                       _copy_drag_events;
 	PatchChanges                         _patch_changes;
@@ -489,6 +491,8 @@ public:
 
 	/** connection used to connect to model's ContentChanged signal */
 	PBD::ScopedConnection content_connection;
+	/** connection used to connect to the source's ModelChanged signal */
+	PBD::ScopedConnection _source_model_connection;
 
 	NoteBase* find_canvas_note (boost::shared_ptr<NoteType>);
 	NoteBase* find_canvas_note (Evoral::event_id_t id);
@@ -569,6 +573,9 @@ public:
 	void update_sysexes ();
 	void view_changed ();
 	void model_changed ();
+
+	void ensure_model ();
+	void source_model_changed ();
 };
 
 
@@ -198,15 +198,21 @@ MidiStreamView::display_region (MidiRegionView* region_view, bool)
 		return;
 	}
 
-	if (!source->model()) {
-		error << _("attempt to display MIDI region with no model") << endmsg;
-		return;
-	}
+	/* a model that is not loaded yet is left alone, the region view
+	 * draws the notes from the source until they are edited.
+	 */
+	boost::shared_ptr<MidiModel> model = source->loaded_model ();
+	uint8_t lowest;
+	uint8_t highest;
 
-	_range_dirty = update_data_note_range (source->model()->lowest_note(), source->model()->highest_note());
+	if (model) {
+		_range_dirty = update_data_note_range (model->lowest_note(), model->highest_note());
+	} else if (source->note_range (lowest, highest)) {
+		_range_dirty = update_data_note_range (lowest, highest);
+	}
 
 	// Display region contents
-	region_view->display_model (source->model());
+	region_view->display_model (model);
 }
 
 
@@ -226,8 +232,22 @@ MidiStreamView::update_contents_metrics(boost::shared_ptr<Region> r)
 	boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion>(r);
 
 	if (mr) {
-		Source::ReaderLock lm (mr->midi_source(0)->mutex());
-		_range_dirty = update_data_note_range (mr->model()->lowest_note(), mr->model()->highest_note());
+		boost::shared_ptr<MidiSource> source = mr->midi_source(0);
+		boost::shared_ptr<MidiModel> model = source->loaded_model();
+		uint8_t lowest;
+		uint8_t highest;
+
+		if (!model && source->note_range (lowest, highest)) {
+			_range_dirty = update_data_note_range (lowest, highest);
+			return;
+		}
+
+		if (!model) {
+			model = mr->model();
+		}
+
+		Source::ReaderLock lm (source->mutex());
+		_range_dirty = update_data_note_range (model->lowest_note(), model->highest_note());
 	}
 }
 
@@ -4536,6 +4536,18 @@ These settings will only take effect after %1 is restarted.\n\
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
 		add_option (_("Performance"), procs);
+
+		bo = new BoolOption (
+				"graph-work-stealing",
+				_("Use work-stealing process graph scheduler"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_work_stealing),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_work_stealing)
+				);
+
+		Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+				_("When enabled, each DSP thread keeps its own queue of routes that are ready to run and idle threads take work from busy ones. Routes fed by a route tend to be processed on the same CPU core. When disabled, all DSP threads share a single queue."));
+
+		add_option (_("Performance"), bo);
 	}
 
 #if !(defined PLATFORM_WINDOWS || defined __APPLE__)
@@ -4648,6 +4660,38 @@ These settings will only take effect after %1 is restarted.\n\
 
 	add_option (_("Performance"), new BufferingOptions (_rc_config));
 
+	SpinOption<uint32_t>* dio = new SpinOption<uint32_t> (
+			"disk-io-threads",
+			_("Number of threads used to read from disk"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_disk_io_threads),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_disk_io_threads),
+			1, 16,
+			1, 4
+			);
+	Gtkmm2ext::UI::instance()->set_tip (dio->tip_widget(),
+			_("Playback buffers of tracks are refilled in parallel by this many threads, tracks with the least amount of buffered data first. This setting takes effect when the session is next loaded."));
+	add_option (_("Performance"), dio);
+
+	bo = new BoolOption (
+			"disk-prefetch",
+			_("Prefetch audio data for all channels"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_disk_prefetch),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_disk_prefetch)
+			);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, the data needed to refill a track's playback buffer is requested from the operating system for all channels and regions at once, before it is read. This allows the disk to work on many requests in parallel. Only applies to uncompressed audio files."));
+	add_option (_("Performance"), bo);
+
+	bo = new BoolOption (
+			"mmap-audio-files",
+			_("Memory-map uncompressed audio files"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_mmap_audio_files),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_mmap_audio_files)
+			);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, WAV/W64/RF64 files with 16, 24 or 32 bit integer or 32 bit float data are read directly from memory instead of using file read operations. This setting takes effect when the session is next loaded."));
+	add_option (_("Performance"), bo);
+
 	/* Image cache size */
 	add_option (_("Performance"), new OptionEditorHeading (_("Memory Usage")));
 
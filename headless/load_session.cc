@@ -17,6 +17,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cstdio>
 #include <cstdlib>
 #include <getopt.h>
 #include <iostream>
@@ -28,10 +29,12 @@
 #include <glibmm.h>
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/crossthread.h"
 #include "pbd/debug.h"
 #include "pbd/error.h"
 #include "pbd/failed_constructor.h"
+#include "pbd/microseconds.h"
 
 #include "ardour/ardour.h"
 #include "ardour/audioengine.h"
@@ -52,6 +55,7 @@ static string             backend_client_name;
 static string             backend_name = "JACK";
 static CrossThreadChannel xthread (true);
 static TestReceiver       test_receiver;
+static PBD::microseconds_t session_load_time = 0;
 
 /** @param dir Session directory.
  *  @param state Session state file, without .ardour suffix.
@@ -77,7 +81,10 @@ load_session (string dir, string state)
 		exit (EXIT_FAILURE);
 	}
 
-	Session* session = new Session (*engine, dir, state);
+	PBD::microseconds_t start   = PBD::get_microseconds ();
+	Session*            session = new Session (*engine, dir, state);
+	session_load_time           = PBD::get_microseconds () - start;
+
 	engine->set_session (session);
 	return session;
 }
@@ -138,8 +145,10 @@ print_help ()
 	     << "  -c, --name <name>           Use a specific backend client name, default is ardour\n"
 	     << "  -d, --disable-plugins       Disable all plugins in an existing session\n"
 	     << "  -D, --debug <options>       Set debug flags. Use \"-D list\" to see available options\n"
+	     << "  -j, --load-threads <n>      Number of threads used to load the session (0: one per CPU core)\n"
 	     << "  -O, --no-hw-optimizations   Disable h/w specific optimizations\n"
 	     << "  -P, --no-connect-ports      Do not connect any ports at startup\n"
+	     << "  -T, --load-timing           Report the time spent in each phase of loading the session\n"
 #ifdef WINDOWS_VST_SUPPORT
 	     << "  -V, --novst                 Do not use VST support\n"
 #endif
@@ -149,7 +158,7 @@ print_help ()
 int
 main (int argc, char* argv[])
 {
-	const char* optstring = "vhBdD:c:OU:P";
+	const char* optstring = "vhBdD:c:j:OU:PT";
 
 	/* clang-format off */
 	const struct option longopts[] = {
@@ -159,13 +168,17 @@ main (int argc, char* argv[])
 		{ "disable-plugins",     no_argument,       0, 'd' },
 		{ "debug",               required_argument, 0, 'D' },
 		{ "name",                required_argument, 0, 'c' },
+		{ "load-threads",        required_argument, 0, 'j' },
 		{ "no-hw-optimizations", no_argument,       0, 'O' },
 		{ "no-connect-ports",    no_argument,       0, 'P' },
+		{ "load-timing",         no_argument,       0, 'T' },
 		{ 0, 0, 0, 0 }
 	};
 	/* clang-format on */
 
 	bool try_hw_optimization = true;
+	bool load_timing         = false;
+	int  load_threads        = -1;
 
 	backend_client_name = PBD::downcase (std::string (PROGRAM_NAME));
 
@@ -203,6 +216,10 @@ main (int argc, char* argv[])
 				}
 				break;
 
+			case 'j':
+				load_threads = atoi (optarg);
+				break;
+
 			case 'O':
 				try_hw_optimization = false;
 				break;
@@ -211,6 +228,10 @@ main (int argc, char* argv[])
 				ARDOUR::Port::set_connecting_blocked (true);
 				break;
 
+			case 'T':
+				load_timing = true;
+				break;
+
 			default:
 				print_help ();
 				exit (EXIT_FAILURE);
@@ -228,6 +249,10 @@ main (int argc, char* argv[])
 		exit (EXIT_FAILURE);
 	}
 
+	if (load_threads >= 0) {
+		Config->set_session_load_threads (load_threads);
+	}
+
 	Session* s = 0;
 
 	try {
@@ -256,6 +281,17 @@ main (int argc, char* argv[])
 		exit (EXIT_FAILURE);
 	}
 
+	if (load_timing) {
+		Session::LoadPhaseTimes const& phases (s->load_phase_times ());
+		uint32_t                       n_threads = Config->get_session_load_threads ();
+
+		printf ("Session load time (%u threads):\n", n_threads > 0 ? n_threads : hardware_concurrency ());
+		for (Session::LoadPhaseTimes::const_iterator i = phases.begin (); i != phases.end (); ++i) {
+			printf ("  %-24s %10.1f ms\n", i->first.c_str (), i->second / 1000.0);
+		}
+		printf ("  %-24s %10.1f ms\n", "total (new Session)", session_load_time / 1000.0);
+	}
+
 	PBD::ScopedConnectionList con;
 	BasicUI::AccessAction.connect_same_thread (con, boost::bind (&access_action, _1, _2));
 	AudioEngine::instance ()->Halted.connect_same_thread (con, boost::bind (&engine_halted, _1));
@@ -175,12 +175,7 @@ Amp::apply_gain (BufferSet& bufs, samplecnt_t sample_rate, samplecnt_t nframes,
 
 	for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
 		Sample* const buffer = i->data();
-		double lpf = initial;
-
-		for (pframes_t nx = 0; nx < nframes; ++nx) {
-			buffer[nx] *= lpf;
-			lpf += a * (target - lpf);
-		}
+		gain_t const lpf = apply_gain_ramp (buffer, buffer, nframes, initial, target, a);
 		if (i == bufs.audio_begin()) {
 			rv = lpf;
 		}
@@ -256,12 +251,40 @@ Amp::apply_gain (AudioBuffer& buf, samplecnt_t sample_rate, samplecnt_t nframes,
 	Sample* const buffer = buf.data (offset);
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF, see [other] Amp::apply_gain() above for details
 
-	gain_t lpf = initial;
-	for (pframes_t nx = 0; nx < nframes; ++nx) {
-		buffer[nx] *= lpf;
-		lpf += a * (target - lpf);
+	gain_t lpf = apply_gain_ramp (buffer, buffer, nframes, initial, target, a);
+
+	if (fabsf (lpf - target) < GAIN_COEFF_DELTA) return target;
+	return lpf;
+}
+
+gain_t
+Amp::apply_gain (AudioBuffer& dst, AudioBuffer const& src, samplecnt_t sample_rate, samplecnt_t nframes, gain_t initial, gain_t target)
+{
+	/* Copy @a src to @a dst applying a (potentially) declicked gain in the
+	 * same pass -- used by sends and Delivery, which would otherwise copy
+	 * first and then modify the copy.
+	 */
+
+	if (nframes == 0) {
+		return initial;
 	}
 
+	if (initial == target) {
+		if (target == GAIN_COEFF_UNITY) {
+			dst.read_from (src, nframes);
+		} else if (fabsf (target) < GAIN_COEFF_SMALL) {
+			dst.silence (nframes);
+		} else {
+			/* the ramp is constant */
+			apply_gain_ramp (dst.data (), src.data (), nframes, target, target, 0);
+		}
+		return target;
+	}
+
+	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF, see [other] Amp::apply_gain() above for details
+
+	gain_t lpf = apply_gain_ramp (dst.data (), src.data (), nframes, initial, target, a);
+
 	if (fabsf (lpf - target) < GAIN_COEFF_DELTA) return target;
 	return lpf;
 }
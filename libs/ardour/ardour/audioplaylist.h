@@ -44,6 +44,7 @@ public:
 	AudioPlaylist (boost::shared_ptr<const AudioPlaylist>, timepos_t const & start, timepos_t const & cnt, std::string name, bool hidden = false);
 
 	timecnt_t read (Sample *dst, Sample *mixdown, float *gain_buffer, timepos_t const & start, timecnt_t const & cnt, uint32_t chan_n=0);
+	void prefetch (timepos_t const & start, timecnt_t const & cnt, uint32_t chan_n=0);
 
 	bool destroy_region (boost::shared_ptr<Region>);
 
@@ -54,6 +55,13 @@ protected:
 	void pre_uncombine (std::vector<boost::shared_ptr<Region> >&, boost::shared_ptr<Region>);
 
 private:
+	struct ReadPlan;
+
+	boost::shared_ptr<ReadPlan const> read_plan (timepos_t const & start, timecnt_t const & cnt);
+
+	Glib::Threads::Mutex              _read_plan_lock;
+	boost::shared_ptr<ReadPlan const> _read_plan;
+
 	int set_state (const XMLNode&, int version);
 	void dump () const;
 	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
@@ -125,6 +125,8 @@ class LIBARDOUR_API AudioRegion : public Region, public AudioReadable
 	                                    samplepos_t position, samplecnt_t cnt,
 	                                    uint32_t chan_n=0) const;
 
+	void prefetch (samplepos_t position, samplecnt_t cnt, uint32_t chan_n = 0) const;
+
 	samplecnt_t read_raw_internal (Sample*, samplepos_t, samplecnt_t, int channel) const;
 
 	XMLNode& state () const;
@@ -27,6 +27,7 @@
 #include <boost/shared_array.hpp>
 #include <boost/enable_shared_from_this.hpp>
 
+#include <atomic>
 #include <time.h>
 
 #include <glibmm/threads.h>
@@ -58,6 +59,11 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 	virtual samplecnt_t read (Sample *dst, samplepos_t start, samplecnt_t cnt, int channel=0) const;
 	virtual samplecnt_t write (Sample *src, samplecnt_t cnt);
 
+	/** Hint that [start, start + cnt) is about to be read.
+	 * This must not wait for I/O to complete; the default is to do nothing.
+	 */
+	virtual void prefetch (samplepos_t /*start*/, samplecnt_t /*cnt*/) const {}
+
 	virtual float sample_rate () const = 0;
 
 	virtual void mark_streaming_write_completed (const WriterLock& lock);
@@ -73,6 +79,15 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 	mutable PBD::Signal0<void>  PeaksReady;
 	mutable PBD::Signal2<void,samplepos_t,samplepos_t>  PeakRangeReady;
 
+	/** Progress of building the peakfile from scratch. Lock-free, may be
+	 *  called from any thread, including handlers of PeakRangeReady.
+	 *  @param[out] fraction Part of the peakfile that has been built.
+	 *  @param[out] eta Estimated time until the peakfile is complete, in seconds,
+	 *  or -1 if nothing has been built yet.
+	 *  @return true if the peakfile is being built.
+	 */
+	bool peak_build_progress (float& fraction, double& eta) const;
+
 	XMLNode& get_state () const;
 	int set_state (const XMLNode&, int version);
 
@@ -116,6 +131,9 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 
 	std::string         _peakpath;
 
+	/** @return path of the file holding the reduced levels of the peakfile */
+	std::string peak_levels_path () const;
+
 	int initialize_peakfile (const std::string& path, const bool in_session = false);
 	int build_peaks_from_scratch ();
 	int compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, samplecnt_t cnt,
@@ -147,6 +165,11 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
         mutable Glib::Threads::Mutex _peaks_ready_lock;
         Glib::Threads::Mutex _initialize_peaks_lock;
 
+	/* progress of build_peaks_from_scratch(), written by the peak thread */
+	std::atomic<int64_t>     _peak_build_start; ///< g_get_monotonic_time() at the start, or 0
+	std::atomic<samplecnt_t> _peak_build_done;
+	std::atomic<samplecnt_t> _peak_build_total;
+
 	int        _peakfile_fd;
 	samplecnt_t peak_leftover_cnt;
 	samplecnt_t peak_leftover_size;
@@ -158,6 +181,28 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* Reduced resolution copies of the peakfile. Level N has _FPP << N
+	 * samples per peak, see audiosource.cc for the file layout.
+	 */
+	int                           _peak_levels_fd;
+	samplecnt_t                   _peak_levels_base;     ///< peakfile peaks added to the levels being written
+	boost::scoped_array<PeakData> _peak_levels_block;    ///< block of the levels being written
+	GATOMIC_QUAL gint             _peak_levels_valid;    ///< peakfile peaks covered by the levels on disk
+	GATOMIC_QUAL gint             _peak_levels_complete; ///< true if the levels also cover a trailing partial block
+
+	bool load_peak_levels ();
+	int  build_peak_levels ();
+	int  start_peak_levels ();
+	void add_peak_levels (PeakData const* peaks, samplepos_t first_peak, samplecnt_t npeaks);
+	int  write_peak_levels_block ();
+	int  write_peak_levels_header (int64_t base_peaks);
+	void finish_peak_levels (bool done);
+	void discard_peak_levels ();
+
+	uint32_t peak_level (samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const;
+	int read_peak_level (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt,
+	                     double samples_per_visual_peak, uint32_t level) const;
 };
 
 }
@@ -24,12 +24,14 @@
 #define __ardour_butler_h__
 
 #include <pthread.h>
+#include <vector>
 
 #include <glibmm/threads.h>
 
 #include "pbd/crossthread.h"
 #include "pbd/ringbuffer.h"
 #include "pbd/pool.h"
+#include "pbd/semutils.h"
 #include "pbd/g_atomic_compat.h"
 
 #include "ardour/libardour_visibility.h"
@@ -38,6 +40,8 @@
 
 namespace ARDOUR {
 
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -97,6 +101,40 @@ private:
 
 	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
 
+	/* parallel playback buffer refill */
+	struct RefillTask {
+		RefillTask (boost::shared_ptr<Track> t, float l)
+			: track (t)
+			, load (l)
+			, result (NotRun)
+		{}
+
+		enum { NotRun = 2 };
+
+		boost::shared_ptr<Track> track;
+		float                    load;   ///< playback buffer fill level at the time the task was queued
+		int                      result; ///< return value of Track::do_refill
+
+		bool operator< (RefillTask const& other) const {
+			return load < other.load;
+		}
+	};
+
+	bool refill_tracks (RouteList const&);
+	void run_refill_tasks (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer);
+
+	void start_io_threads ();
+	void stop_io_threads ();
+	static void* _io_thread_work (void* arg);
+	void         io_thread_work ();
+
+	std::vector<RefillTask> _refill_tasks;
+	GATOMIC_QUAL gint       _refill_next;
+	std::vector<pthread_t>  _io_threads;
+	GATOMIC_QUAL gint       _io_threads_active;
+	PBD::Semaphore          _io_run_sem;
+	PBD::Semaphore          _io_done_sem;
+
 	/**
 	 * Add request to butler thread request queue
 	 */
@@ -136,6 +136,8 @@ private:
 	PBD::ScopedConnection panner_legal_c;
 	void output_changed (IOChange, void*);
 
+	gain_t copy_audio_to_outputs (BufferSet&, pframes_t nframes, gain_t initial, gain_t target);
+
 	bool _no_panner_reset;
 };
 
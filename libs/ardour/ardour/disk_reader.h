@@ -23,6 +23,7 @@
 #include <boost/optional.hpp>
 
 #include "pbd/g_atomic_compat.h"
+#include "pbd/timing.h"
 
 #include "evoral/Curve.h"
 
@@ -81,6 +82,12 @@ public:
 	 */
 	int do_refill ();
 
+	/** Variant of do_refill() for parallel refill by butler I/O workers,
+	 * using working buffers owned by the calling thread.
+	 * Each buffer must hold at least working_buffer_size() samples.
+	 */
+	int do_refill (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer);
+
 	/** For contexts outside the normal butler refill loop (allocates temporary working buffers) */
 	int do_refill_with_alloc (bool partial_fill, bool reverse);
 
@@ -89,6 +96,13 @@ public:
 	/* Working buffers for do_refill (butler thread) */
 	static void allocate_working_buffers ();
 	static void free_working_buffers ();
+	static samplecnt_t working_buffer_size () { return 2 * 1048576; }
+
+	/** Time taken by refills that read data, and average read throughput
+	 * (all channels, in samples per second).
+	 */
+	bool refill_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev, double& samples_per_sec) const;
+	void reset_refill_stats ();
 
 	void adjust_buffering ();
 
@@ -227,10 +241,17 @@ private:
 	                        int                channel,
 	                        bool               reversed);
 
+	void prefetch_audio (samplepos_t start, samplecnt_t cnt, uint32_t n_channels, bool reversed);
+
 	static Sample* _sum_buffer;
 	static Sample* _mixdown_buffer;
 	static gain_t* _gain_buffer;
 
+	PBD::TimingStats  _refill_timing;
+	uint64_t          _refill_samples;
+	uint64_t          _refill_usecs;
+	GATOMIC_QUAL gint _reset_refill_stats;
+
 	int refill (Sample* sum_buffer, Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill_level, bool reversed);
 	int refill_audio (Sample* sum_buffer, Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill_level, bool reversed);
 
@@ -24,6 +24,7 @@
 #define __ardour_graph_h__
 
 #include <list>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -33,6 +34,8 @@
 #include "pbd/mpmc_queue.h"
 #include "pbd/semutils.h"
 #include "pbd/g_atomic_compat.h"
+#include "pbd/timing.h"
+#include "pbd/work_stealing_deque.h"
 
 #include "ardour/audio_backend.h"
 #include "ardour/libardour_visibility.h"
@@ -57,6 +60,7 @@ class LIBARDOUR_API Graph : public SessionHandleRef
 {
 public:
 	Graph (Session& session);
+	~Graph ();
 
 	void trigger (GraphNode* n);
 	void rechain (boost::shared_ptr<RouteList>, GraphEdges const&);
@@ -78,6 +82,40 @@ public:
 
 	bool in_process_thread () const;
 
+	/** Per thread scheduler statistics, accumulated until reset_stats () */
+	struct LIBARDOUR_API SchedulerStats {
+		SchedulerStats () { reset (); }
+		void reset ();
+
+		uint64_t nodes_run;      ///< nodes processed by this thread
+		uint64_t local_pops;     ///< nodes taken from the thread's own deque
+		uint64_t shared_pops;    ///< nodes taken from the shared trigger queue
+		uint64_t steals;         ///< nodes stolen from other threads' deques
+		uint64_t failed_steals;  ///< searches that found no work
+		uint64_t sleeps;         ///< number of times the thread went idle
+	};
+
+	/** true if the current cycle uses per-thread deques with work stealing */
+	bool work_stealing () const { return g_atomic_int_get (&_work_stealing); }
+
+	/** fill in a copy of the per-thread statistics (index 0 is the main graph thread)
+	 * and timing of the complete graph execution (callback start to done).
+	 */
+	void get_stats (std::vector<SchedulerStats>&, PBD::TimingStats&) const;
+	void reset_stats ();
+
+	/** Estimate the longest dependency chain of the current graph,
+	 * using the measured processing time of each route.
+	 *
+	 * If the critical path is close to the total processing time of
+	 * a cycle, adding more DSP threads cannot reduce the DSP load.
+	 *
+	 * @param path sum of processing time along the longest chain [usec]
+	 * @param total sum of processing time of all routes [usec]
+	 * @return false if the graph is empty
+	 */
+	bool critical_path (PBD::microseconds_t& path, PBD::microseconds_t& total) const;
+
 protected:
 	virtual void session_going_away ();
 
@@ -85,15 +123,50 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 	void run_one ();
+	bool pop_node (GraphNode*&);
 	void main_thread ();
 	void prep ();
 	void dump (int chain) const;
 
+	typedef std::map<GraphNode const*, PBD::microseconds_t> CostMap;
+	PBD::microseconds_t critical_path (GraphNode const*, int chain, CostMap&) const;
+
+	/* realtime-safe, called by rechain() and prep() */
+	void                order_by_critical_path (int chain);
+	PBD::microseconds_t update_critical_path (GraphNode*, int chain);
+	bool                node_costs_drifted (int chain) const;
+
+	/** Order nodes by decreasing critical path */
+	struct CriticalPathCmp {
+		CriticalPathCmp (int c) : chain (c) {}
+		bool operator() (GraphNode const* a, GraphNode const* b) const;
+		bool operator() (node_ptr_t const& a, node_ptr_t const& b) const {
+			return (*this) (a.get (), b.get ());
+		}
+		int chain;
+	};
+
 	node_list_t _nodes_rt[2];
 	node_list_t _init_trigger_list[2];
 
 	PBD::MPMCQueue<GraphNode*> _trigger_queue;      ///< nodes that can be processed
-	GATOMIC_QUAL guint         _trigger_queue_size; ///< number of entries in trigger-queue
+	GATOMIC_QUAL guint         _trigger_queue_size; ///< number of entries in trigger-queue and all worker deques
+
+	/* work-stealing scheduler, one deque per process thread */
+	typedef PBD::WorkStealingDeque<GraphNode*> WorkerDeque;
+
+	struct WorkerState {
+		WorkerState () : deque (1024), initial (1024) { g_atomic_int_set (&reset_stats, 0); }
+		WorkerDeque                deque;
+		PBD::MPMCQueue<GraphNode*> initial; ///< initial nodes of the cycle assigned to this thread
+		SchedulerStats             stats;   ///< only written by the thread itself
+		GATOMIC_QUAL gint          reset_stats; ///< set to have the thread reset its stats
+	};
+
+	std::vector<WorkerState*> _workers;
+	GATOMIC_QUAL gint         _work_stealing; ///< latched in prep () for the whole cycle
+	uint32_t                  _cycles_since_cost_check; ///< process cycles since node costs were last compared
+	PBD::TimingStats          _process_stats;
 
 	/** Start worker threads */
 	PBD::Semaphore _execution_sem;
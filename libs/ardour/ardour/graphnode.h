@@ -28,6 +28,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "pbd/g_atomic_compat.h"
+#include "pbd/timing.h"
 
 namespace ARDOUR
 {
@@ -44,6 +45,12 @@ protected:
 	friend class Graph;
 	/** Nodes that we directly feed */
 	node_set_t _activation_set[2];
+	/** Nodes that we directly feed, ordered by decreasing critical path */
+	std::vector<GraphNode*> _activation_order[2];
+	/** Estimated cost of this node plus its most expensive downstream chain */
+	PBD::microseconds_t _critical_path[2];
+	/** estimated_cost() of this node when the order was last computed */
+	PBD::microseconds_t _scheduled_cost[2];
 	/** The number of nodes that we directly feed us (one count for each chain) */
 	gint _init_refcount[2];
 };
@@ -61,16 +68,23 @@ public:
 	void
 	run (int chain)
 	{
+		_timing.start ();
 		process ();
+		_timing.update ();
 		finish (chain);
 	}
 
+	/** average measured processing time in usec, or 1 if not yet known */
+	PBD::microseconds_t estimated_cost () const;
+	void reset_timing ();
+
 private:
 	void finish (int chain);
 	void process ();
 
 	boost::shared_ptr<Graph> _graph;
 	GATOMIC_QUAL gint        _refcount;
+	PBD::TimingStats         _timing;
 };
 }
 
@@ -0,0 +1,76 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_io_tasklist_h_
+#define _ardour_io_tasklist_h_
+
+#include <vector>
+
+#include <boost/function.hpp>
+
+#include "pbd/semutils.h"
+#include "pbd/g_atomic_compat.h"
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** A list of independent tasks which are run in parallel by a pool of
+ * (non-realtime) worker threads and the thread calling process ().
+ *
+ * This is the non-realtime counterpart of RTTaskList, for work that may
+ * block, allocate or do disk I/O, e.g. while loading a session. Tasks
+ * that depend on each other go into separate calls to process (), which
+ * returns only once all queued tasks have completed.
+ */
+class LIBARDOUR_API IOTaskList
+{
+public:
+	/** @param n_threads total number of threads to use, including the one
+	 * calling process (). 0: one per CPU core.
+	 */
+	IOTaskList (uint32_t n_threads = 0);
+	~IOTaskList ();
+
+	/** queue a task for the next call to process ().
+	 * Must only be called from the thread that calls process ().
+	 */
+	void push_back (boost::function<void ()> fn);
+
+	/** process queued tasks in parallel, wait for them to complete */
+	void process ();
+
+	/** number of worker threads, not counting the one calling process () */
+	size_t n_workers () const { return _threads.size (); }
+
+private:
+	GATOMIC_QUAL gint      _threads_active;
+	std::vector<pthread_t> _threads;
+
+	void run_tasks ();
+
+	static void* _thread_run (void *arg);
+	void run ();
+
+	PBD::Semaphore _task_run_sem;
+	PBD::Semaphore _task_end_sem;
+
+	std::vector<boost::function<void ()> > _tasks;
+	GATOMIC_QUAL gint                      _next_task; ///< index of the next task to be claimed
+};
+
+} // namespace ARDOUR
+#endif
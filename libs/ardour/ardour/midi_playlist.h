@@ -25,9 +25,15 @@
 
 #include <vector>
 #include <list>
+#include <map>
+#include <set>
 
 #include <boost/utility.hpp>
 
+#include <glibmm/threads.h>
+
+#include "pbd/id.h"
+
 #include "evoral/Parameter.h"
 
 #include "ardour/ardour.h"
@@ -39,6 +45,8 @@
 #include "evoral/Parameter.h"
 #include "ardour/rt_midibuffer.h"
 
+#include "temporal/tempo.h"
+
 namespace Evoral {
 template<typename Time> class EventSink;
 class                         Beats;
@@ -87,13 +95,55 @@ public:
   protected:
 	void remove_dependents (boost::shared_ptr<Region> region);
 	void region_going_away (boost::weak_ptr<Region> region);
+	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
 
   private:
+	/** The events of one region as of the last ::render(), so that a render
+	 *  only needs to read the regions that have changed since then.
+	 */
+	struct RenderedRegion {
+		RenderedRegion () : included (false) {}
+
+		bool matches (MidiRegion const &) const;
+
+		samplepos_t first () const { return events[order.front ()].timestamp; }
+		samplepos_t last () const { return events[order.back ()].timestamp; }
+
+		RTMidiBuffer          events;   ///< in the order the region rendered them
+		std::vector<uint32_t> order;    ///< indices into events, sorted by time and type
+		timepos_t             position;
+		timepos_t             start;
+		timecnt_t             length;
+		bool                  included; ///< part of the last render
+	};
+
+	typedef std::map<PBD::ID, boost::shared_ptr<RenderedRegion> > RenderedRegions;
+	typedef std::vector<boost::shared_ptr<RenderedRegion> >        RenderedRegionList;
+
 	void dump () const;
 
+	void render_region (MidiRegion const &, RenderedRegion&, MidiChannelFilter*);
+	void merge_rendered (RenderedRegionList const &, samplepos_t first, samplepos_t last, RTMidiBuffer& dst);
+
 	NoteMode     _note_mode;
 
 	RTMidiBuffer _rendered;
+
+	/* state of the last ::render(); any change to these requires all
+	 * regions to be rendered again
+	 */
+	Glib::Threads::Mutex          _render_lock;
+	RenderedRegions               _rendered_regions;
+	std::vector<PBD::ID>          _rendered_order;
+	MidiChannelFilter*            _render_filter;
+	uint32_t                      _render_filter_mode_mask;
+	NoteMode                      _render_note_mode;
+	Temporal::TempoMap::SharedPtr _render_tempo_map;
+	RTMidiBuffer                  _splice;
+
+	/* regions that changed since the last ::render() */
+	Glib::Threads::Mutex          _dirty_lock;
+	std::set<PBD::ID>             _dirty_regions;
 };
 
 } /* namespace ARDOUR */
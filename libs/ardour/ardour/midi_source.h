@@ -27,6 +27,7 @@
 #include <time.h>
 #include <glibmm/threads.h>
 
+#include "pbd/g_atomic_compat.h"
 #include "pbd/stateful.h"
 #include "pbd/xml++.h"
 
@@ -181,7 +182,23 @@ class LIBARDOUR_API MidiSource : virtual public Source
 
 	void set_note_mode(const WriterLock& lock, NoteMode mode);
 
-	boost::shared_ptr<MidiModel> model() { return _model; }
+	/** @return our model, loading it first if that was deferred when the
+	 *  source was opened. Must not be called with the source lock held.
+	 */
+	boost::shared_ptr<MidiModel> model();
+	/** @return our model if it is loaded, without loading it */
+	boost::shared_ptr<MidiModel> loaded_model() const { return _model; }
+
+	/** Read all notes of the source without loading its model, e.g. to
+	 *  display them before the model is needed. Takes the source lock.
+	 *  @return false if the notes can only be had from the model.
+	 */
+	virtual bool read_notes (Evoral::Sequence<Temporal::Beats>::Notes&) const { return false; }
+	/** Find the range of note numbers of the source without loading its
+	 *  model. Takes the source lock.
+	 *  @return false if only the model knows it.
+	 */
+	virtual bool note_range (uint8_t& /*lowest*/, uint8_t& /*highest*/) const { return false; }
 	void set_model(const WriterLock& lock, boost::shared_ptr<MidiModel>);
 	void drop_model(const WriterLock& lock);
 
@@ -226,6 +243,7 @@ class LIBARDOUR_API MidiSource : virtual public Source
 	                                  timecnt_t const &            cnt) = 0;
 
 	boost::shared_ptr<MidiModel> _model;
+	GATOMIC_QUAL gint            _model_deferred; ///< model not loaded yet, read from file
 	bool                         _writing;
 
 	/** The total duration of the current capture. */
@@ -34,6 +34,8 @@ extern "C" {
 }
 
 LIBARDOUR_API void x86_sse_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
+LIBARDOUR_API float x86_sse_apply_gain_ramp        (float* dst, float const* src, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void x86_sse_reduce_peaks            (float const* src, uint32_t nframes, uint32_t fpp, ARDOUR::PeakData* peaks);
 
 extern "C" {
 /* AVX functions */
@@ -49,12 +51,25 @@ extern "C" {
 #ifdef PLATFORM_WINDOWS
 LIBARDOUR_API void x86_sse_avx_find_peaks               (float const* buf, uint32_t nsamples, float* min, float* max);
 #endif
+LIBARDOUR_API void x86_sse_avx_reduce_peaks             (float const* src, uint32_t nframes, uint32_t fpp, ARDOUR::PeakData* peaks);
 
 /* FMA functions */
 #ifdef FPU_AVX_FMA_SUPPORT
 LIBARDOUR_API void  x86_fma_mix_buffers_with_gain       (float* dst, float const* src, uint32_t nframes, float gain);
 #endif
 
+/* AVX-512 functions */
+#ifdef FPU_AVX512F_SUPPORT
+LIBARDOUR_API float x86_avx512f_compute_peak            (float const* buf, uint32_t nsamples, float current);
+LIBARDOUR_API void  x86_avx512f_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
+LIBARDOUR_API void  x86_avx512f_apply_gain_to_buffer    (float* buf, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain   (float* dst, float const* src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_no_gain     (float* dst, float const* src, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_copy_vector             (float* dst, float const* src, uint32_t nframes);
+LIBARDOUR_API float x86_avx512f_apply_gain_ramp         (float* dst, float const* src, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_avx512f_reduce_peaks            (float const* src, uint32_t nframes, uint32_t fpp, ARDOUR::PeakData* peaks);
+#endif
+
 /* debug wrappers for SSE functions */
 
 LIBARDOUR_API float debug_compute_peak               (ARDOUR::Sample const* buf, ARDOUR::pframes_t nsamples, float current);
@@ -84,6 +99,8 @@ extern "C" {
 	LIBARDOUR_API void  arm_neon_find_peaks            (float const* src, uint32_t nframes, float* minf, float* maxf);
 	LIBARDOUR_API void  arm_neon_mix_buffers_no_gain   (float* dst, float const* src, uint32_t nframes);
 	LIBARDOUR_API void  arm_neon_mix_buffers_with_gain (float* dst, float const* src, uint32_t nframes, float gain);
+	LIBARDOUR_API float arm_neon_apply_gain_ramp       (float* dst, float const* src, uint32_t nframes, float initial, float target, float coeff);
+	LIBARDOUR_API void  arm_neon_reduce_peaks          (float const* src, uint32_t nframes, uint32_t fpp, ARDOUR::PeakData* peaks);
 }
 #endif
 
@@ -95,5 +112,7 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample* buf, ARDO
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector               (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API float default_apply_gain_ramp           (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  default_reduce_peaks              (ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, ARDOUR::pframes_t fpp, ARDOUR::PeakData* peaks);
 
 #endif /* __ardour_mix_h__ */
@@ -35,6 +35,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 #include <sys/stat.h>
 
@@ -59,6 +60,7 @@ namespace ARDOUR {
 class Session;
 class Playlist;
 class Crossfade;
+class RegionIndex;
 
 namespace Properties {
 	/* fake the type, since regions are handled by SequenceProperty which doesn't
@@ -227,6 +229,16 @@ public:
 	boost::shared_ptr<Region>  find_region (const PBD::ID&) const;
 	boost::shared_ptr<Region>  top_region_at (timepos_t const &);
 	boost::shared_ptr<Region>  top_unmuted_region_at (timepos_t const &);
+
+	/** Called by regions of this playlist whenever their properties
+	 * change, even while their property change signals are suspended.
+	 */
+	void region_property_changed (Region const *, PBD::PropertyChange const &);
+
+	/** @return a number which changes whenever regions are added, removed,
+	 * modified or relayered.
+	 */
+	gint generation () const { return g_atomic_int_get (&_generation); }
 	boost::shared_ptr<Region>  find_next_region (timepos_t const &, RegionPoint point, int dir);
 	timepos_t                  find_next_region_boundary (timepos_t const &, int dir);
 	bool                       region_is_shuffle_constrained (boost::shared_ptr<Region>);
@@ -346,6 +358,7 @@ protected:
 	uint32_t                             _sort_id;
 	mutable GATOMIC_QUAL gint            block_notifications;
 	mutable GATOMIC_QUAL gint            ignore_state_changes;
+	GATOMIC_QUAL gint                    _generation;
 	std::set<boost::shared_ptr<Region> > pending_adds;
 	std::set<boost::shared_ptr<Region> > pending_removes;
 	RegionList                           pending_bounds;
@@ -398,6 +411,9 @@ protected:
 	void _set_sort_id ();
 
 	boost::shared_ptr<RegionList> regions_touched_locked (timepos_t const & start, timepos_t const & end);
+	void invalidate_region_index ();
+	void region_index_add (boost::shared_ptr<Region> const &);
+	void region_index_remove (boost::shared_ptr<Region> const &);
 
 	void notify_region_removed (boost::shared_ptr<Region>);
 	void notify_region_added (boost::shared_ptr<Region>);
@@ -467,10 +483,36 @@ private:
 private:
 	void freeze_locked ();
 	void setup_layering_indices (RegionList const &);
+	bool find_regions_to_relayer (RegionList const & ordered, RegionList& subset);
+	void assign_layers (RegionList const & ordered);
+	void save_layering_state (RegionList const & ordered);
+
+	/** position, last position, relayer order and layer of a region as of
+	 * the last relayer (), to limit re-computation to regions that changed.
+	 */
+	struct LayeringState {
+		int64_t first;
+		int64_t last;
+		size_t  rank;
+		layer_t layer;
+	};
+
+	/* pointers are never dereferenced, a region that re-uses the address
+	 * of a removed one with the same bounds and layer does not change the
+	 * result.
+	 */
+	std::unordered_map<Region const*, LayeringState> _layering_state;
+	LayerModel                                       _layering_state_model;
+	Temporal::TimeDomain                             _layering_state_domain;
 	void coalesce_and_check_crossfades (std::list<Temporal::TimeRange>);
 	boost::shared_ptr<RegionList> find_regions_at (timepos_t const &);
+	bool find_overlapping (timepos_t const & first, timepos_t const & last, RegionList&) const;
 
 	mutable boost::optional<std::pair<timepos_t, timepos_t> > _cached_extent;
+
+	/* interval tree of the regions, built on first use, see find_overlapping () */
+	mutable Glib::Threads::Mutex           _region_index_lock;
+	mutable boost::shared_ptr<RegionIndex> _region_index;
 	timepos_t _end_space;  //this is used when we are pasting a range with extra space at the end
 	bool _playlist_shift_active;
 
@@ -304,6 +304,7 @@ protected:
 
 private:
 	void run_input_meters (pframes_t, samplecnt_t);
+	void run_input_meters_task (pframes_t);
 	void set_pretty_names (std::vector<std::string> const&, DataType, bool);
 	void fill_midi_port_info_locked ();
 	void load_port_info ();
@@ -377,6 +378,7 @@ private:
 	SerializedRCUManager<AudioInputPorts> _audio_input_ports;
 	SerializedRCUManager<MIDIInputPorts>  _midi_input_ports;
 	GATOMIC_QUAL gint                     _reset_meters;
+	samplecnt_t                           _input_meter_rate;
 };
 
 } // namespace ARDOUR
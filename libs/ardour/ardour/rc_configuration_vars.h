@@ -69,6 +69,7 @@ CONFIG_VARIABLE (int32_t, initial_program_change, "initial-program-change", -1)
 CONFIG_VARIABLE (bool, first_midi_bank_is_zero, "display-first-midi-bank-as-zero", false)
 CONFIG_VARIABLE (int32_t, inter_scene_gap_samples, "inter-scene-gap-samples", 1)
 CONFIG_VARIABLE (bool, midi_input_follows_selection, "midi-input-follows-selection", 1)
+CONFIG_VARIABLE (bool, defer_midi_model_loading, "defer-midi-model-loading", false)
 CONFIG_VARIABLE (std::string, default_trigger_input_port, "default-trigger-input-port", "")
 
 /* Timecode and related */
@@ -197,6 +198,7 @@ CONFIG_VARIABLE (bool, hiding_groups_deactivates_groups, "hiding-groups-deactiva
 CONFIG_VARIABLE (bool, verify_remove_last_capture, "verify-remove-last-capture", true)
 CONFIG_VARIABLE (bool, save_history, "save-history", true)
 CONFIG_VARIABLE (int32_t, saved_history_depth, "save-history-depth", 20)
+CONFIG_VARIABLE (bool, binary_session_state, "binary-session-state", false)
 CONFIG_VARIABLE (int32_t, history_depth, "history-depth", 20)
 CONFIG_VARIABLE (RegionEquivalence, region_equivalence, "region-equivalency", LayerTime)
 CONFIG_VARIABLE (bool, periodic_safety_backups, "periodic-safety-backups", true)
@@ -214,6 +216,11 @@ CONFIG_VARIABLE (std::string, sample_lib_path, "sample-lib-path", "") /* custom
 CONFIG_VARIABLE (bool, allow_special_bus_removal, "allow-special-bus-removal", false)
 CONFIG_VARIABLE (int32_t, processor_usage, "processor-usage", -1)
 CONFIG_VARIABLE (int32_t, cpu_dma_latency, "cpu-dma-latency", -1) /* >=0 to enable */
+CONFIG_VARIABLE (bool, graph_work_stealing, "graph-work-stealing", false)
+CONFIG_VARIABLE (uint32_t, disk_io_threads, "disk-io-threads", 4) /* including the butler thread */
+CONFIG_VARIABLE (bool, disk_prefetch, "disk-prefetch", true)
+CONFIG_VARIABLE (bool, mmap_audio_files, "mmap-audio-files", true)
+CONFIG_VARIABLE (uint32_t, session_load_threads, "session-load-threads", 0) /* 0: one per CPU core, 1: load serially */
 CONFIG_VARIABLE (gain_t, max_gain, "max-gain", 2.0) /* +6.0dB */
 CONFIG_VARIABLE (uint32_t, max_recent_sessions, "max-recent-sessions", 10)
 CONFIG_VARIABLE (uint32_t, max_recent_templates, "max-recent-templates", 10)
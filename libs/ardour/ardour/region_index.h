@@ -0,0 +1,114 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_region_index_h__
+#define __ardour_region_index_h__
+
+#include <unordered_map>
+
+#include <stdint.h>
+
+#include <boost/noncopyable.hpp>
+
+#include "temporal/timeline.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** An interval tree over a playlist's regions.
+ *
+ * Regions are kept in a treap (randomized balanced binary search tree),
+ * sorted by position, each node keeping the latest region-end in its
+ * subtree. Adding, removing and moving a region is O(log N), range queries
+ * are O(log N + K).
+ *
+ * Regions at the same position are ordered by the time they were added or
+ * last moved, which matches the order of a playlist's region list (sorted
+ * by position, new or moved regions go after existing ones).
+ *
+ * Positions are compared in the regions' own time-domain, without any
+ * tempo-map conversion. If the regions use different time-domains, or a
+ * query uses a different domain than the regions, the index cannot be used
+ * and callers have to fall back to a linear search.
+ *
+ * The index is not thread-safe, callers have to serialize access.
+ */
+class LIBARDOUR_API RegionIndex : public boost::noncopyable
+{
+public:
+	RegionIndex ();
+	~RegionIndex ();
+
+	void add (boost::shared_ptr<Region> const &);
+	void remove (Region const *);
+	/** re-read the region's bounds after it was moved or trimmed */
+	void update (Region const *);
+	void clear ();
+
+	/** @return true if the index can answer queries for the given position */
+	bool can_search (timepos_t const & pos) const {
+		return _n_mixed == 0 && _n_domain[pos.time_domain () == Temporal::AudioTime ? Temporal::BeatTime : Temporal::AudioTime] == 0;
+	}
+
+	/** Find regions whose [position, nt_last] intersects [first, last]
+	 * (both inclusive), in position order.
+	 */
+	void overlapping (timepos_t const & first, timepos_t const & last, RegionList&) const;
+
+	size_t size () const { return _nodes.size (); }
+
+private:
+	struct Node {
+		Node (boost::shared_ptr<Region> const & r) : region (r), left (0), right (0) {}
+
+		boost::shared_ptr<Region> region;
+		int64_t                   first;
+		int64_t                   last;
+		int64_t                   subtree_last; ///< max. last of this node and its children
+		uint64_t                  seq;          ///< orders regions at the same position
+		uint32_t                  priority;
+		Temporal::TimeDomain      domain;       ///< time-domain of the position
+		bool                      mixed;        ///< position and end use different time-domains
+		Node*                     left;
+		Node*                     right;
+
+		bool before (int64_t f, uint64_t s) const {
+			return first < f || (first == f && seq < s);
+		}
+	};
+
+	void load (Node*);
+	void link (Node*);
+	void unlink (Node*);
+
+	static void  split (Node*, int64_t first, uint64_t seq, Node*& l, Node*& r);
+	static Node* merge (Node* l, Node* r);
+	static void  update_subtree (Node*);
+	static void  find (Node const*, int64_t first, int64_t last, RegionList&);
+
+	Node*                                      _root;
+	std::unordered_map<Region const *, Node*> _nodes;
+	uint64_t                                   _seq;
+	uint32_t                                   _rand;
+	size_t                                     _n_domain[2]; ///< number of regions per time-domain
+	size_t                                     _n_mixed;
+};
+
+} /* namespace ARDOUR */
+
+#endif /* __ardour_region_index_h__ */
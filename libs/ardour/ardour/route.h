@@ -733,6 +733,13 @@ private:
 	int set_state_2X (const XMLNode&, int);
 	void set_processor_state_2X (XMLNodeList const &, int);
 
+	/** LADSPA (lrdf), LV2 (lilv world) and Lua plugins share host state
+	 * that is not thread-safe. Session::load_routes() may set up routes
+	 * concurrently, so setting up processors with these plugins is serialized.
+	 */
+	static Glib::Threads::Mutex _plugin_setup_lock;
+	static bool processors_share_plugin_state (XMLNode const&);
+
 	void input_change_handler (IOChange, void *src);
 	void output_change_handler (IOChange, void *src);
 	void sidechain_change_handler (IOChange, void *src);
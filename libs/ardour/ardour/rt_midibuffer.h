@@ -63,6 +63,9 @@ class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 	uint32_t write (TimeType time, Evoral::EventType type, uint32_t size, const uint8_t* buf);
 	uint32_t read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiNoteTracker& tracker, samplecnt_t offset = 0);
 
+	/* exchange contents with @param other, caller must hold the write lock of both */
+	void swap (RTMidiBuffer& other);
+
 	void dump (uint32_t);
 	void reverse ();
 	bool reversed() const;
@@ -19,8 +19,7 @@
 #ifndef _ardour_rt_tasklist_h_
 #define _ardour_rt_tasklist_h_
 
-#include <list>
-#include <boost/function.hpp>
+#include <vector>
 
 #include "pbd/semutils.h"
 #include "pbd/g_atomic_compat.h"
@@ -32,17 +31,77 @@
 
 namespace ARDOUR {
 
+/** A unit of work for RTTaskList.
+ *
+ * Tasks are small values (a function, an object and the number of
+ * samples to process), which are copied into the pre-allocated task
+ * array. Creating and queuing a task does not allocate memory.
+ */
+class LIBARDOUR_API RTTask
+{
+public:
+	typedef void (*Function) (void*, pframes_t);
+
+	RTTask ()
+		: _fn (0)
+		, _obj (0)
+		, _nframes (0)
+	{}
+
+	RTTask (Function fn, void* obj, pframes_t nframes)
+		: _fn (fn)
+		, _obj (obj)
+		, _nframes (nframes)
+	{}
+
+	/** Create a task that calls obj->M (nframes) */
+	template <typename T, void (T::*M) (pframes_t)>
+	static RTTask
+	member (T* obj, pframes_t nframes)
+	{
+		return RTTask (&call_member<T, M>, obj, nframes);
+	}
+
+	void run () const { _fn (_obj, _nframes); }
+
+private:
+	template <typename T, void (T::*M) (pframes_t)>
+	static void
+	call_member (void* obj, pframes_t nframes)
+	{
+		(static_cast<T*> (obj)->*M) (nframes);
+	}
+
+	Function  _fn;
+	void*     _obj;
+	pframes_t _nframes;
+};
+
 class LIBARDOUR_API RTTaskList
 {
 public:
-	RTTaskList ();
+	RTTaskList (size_t capacity = 1024);
 	~RTTaskList ();
 
-	// TODO use dedicated allocator of a boost::intrusive::list
-	typedef std::list<boost::function<void ()> > TaskList;
+	/** queue a task for the next call to process ().
+	 *
+	 * This is realtime-safe, but must only be called from the
+	 * thread that calls process ().
+	 *
+	 * @return false if the task list is full, the task was not queued.
+	 */
+	bool push_back (RTTask const&);
+
+	/** process queued tasks in parallel, wait for them to complete */
+	void process ();
+
+	/** number of tasks that can be queued */
+	size_t capacity () const { return _capacity; }
 
-	/** process tasks in list in parallel, wait for them to complete */
-	void process (TaskList const&);
+	/** increase capacity, not realtime-safe.
+	 * Must not be called concurrently with process ().
+	 */
+	void reserve (size_t);
 
 private:
 	GATOMIC_QUAL gint      _threads_active;
@@ -51,17 +110,19 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 
-	void process_tasklist ();
+	void run_tasks ();
 
 	static void* _thread_run (void *arg);
 	void run ();
 
 	Glib::Threads::Mutex _process_mutex;
-	Glib::Threads::Mutex _tasklist_mutex;
 	PBD::Semaphore _task_run_sem;
 	PBD::Semaphore _task_end_sem;
 
-	TaskList _tasklist;
+	RTTask*           _tasks;
+	size_t            _capacity;
+	GATOMIC_QUAL gint _n_tasks;   ///< number of queued tasks
+	GATOMIC_QUAL gint _next_task; ///< index of the next task to be claimed
 };
 
 } // namespace ARDOUR
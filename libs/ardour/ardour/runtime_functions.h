@@ -31,6 +31,8 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_with_gain_t) (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)   (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)           (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	typedef float (*apply_gain_ramp_t)       (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float, float, float);
+	typedef void  (*reduce_peaks_t)          (const ARDOUR::Sample *, pframes_t, pframes_t, ARDOUR::PeakData *);
 
 	LIBARDOUR_API extern compute_peak_t          compute_peak;
 	LIBARDOUR_API extern find_peaks_t            find_peaks;
@@ -38,6 +40,16 @@ namespace ARDOUR {
 	LIBARDOUR_API extern mix_buffers_with_gain_t mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t   mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t           copy_vector;
+
+	/** dst[i] = src[i] * g[i] with g[0] = initial and g[i+1] = g[i] + coeff * (target - g[i]).
+	 * @p dst may be the same as @p src. Returns the gain following the last sample.
+	 */
+	LIBARDOUR_API extern apply_gain_ramp_t       apply_gain_ramp;
+
+	/** peaks[i] = min and max of src[i * fpp] .. src[min ((i + 1) * fpp, nframes) - 1],
+	 * for all ceil (nframes / fpp) peaks.
+	 */
+	LIBARDOUR_API extern reduce_peaks_t          reduce_peaks;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
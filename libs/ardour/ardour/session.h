@@ -57,6 +57,7 @@
 #include "pbd/error.h"
 #include "pbd/event_loop.h"
 #include "pbd/file_archive.h"
+#include "pbd/microseconds.h"
 #include "pbd/rcu.h"
 #include "pbd/reallocpool.h"
 #include "pbd/statefuldestructible.h"
@@ -319,6 +320,11 @@ public:
 	void refresh_disk_space ();
 
 	int load_routes (const XMLNode&, int);
+
+	/** time spent in each phase of the most recent set_state(), in the order the phases ran */
+	typedef std::vector<std::pair<std::string, PBD::microseconds_t> > LoadPhaseTimes;
+	LoadPhaseTimes const & load_phase_times () const { return _load_phase_times; }
+
 	boost::shared_ptr<RouteList> get_routes() const {
 		return routes.reader ();
 	}
@@ -351,6 +357,7 @@ public:
 	uint32_t nbusses () const;
 
 	bool plot_process_graph (std::string const& file_name) const;
+	boost::shared_ptr<Graph> process_graph () const { return _process_graph; }
 
 	boost::shared_ptr<BundleList> bundles () {
 		return _bundles.reader ();
@@ -1289,6 +1296,12 @@ public:
 		_missing_file_replacement = mfr;
 	}
 
+	/** true while Sources are created by several threads during session load.
+	 * Sources that would need to ask the user must fail, they are
+	 * created again afterwards by the thread that loads the session.
+	 */
+	bool loading_sources_concurrently () const { return _loading_sources_concurrently; }
+
 	/** Emitted when the session wants Ardour to quit */
 	static PBD::Signal0<void> Quit;
 
@@ -1591,6 +1604,9 @@ private:
 	int        load_state (std::string snapshot_name, bool from_template = false);
 	static int parse_stateful_loading_version (const std::string&);
 
+	LoadPhaseTimes _load_phase_times;
+	void           load_phase_done (char const*, PBD::microseconds_t&);
+
 	samplepos_t _last_roll_location;
 	/** the session sample time at which we last rolled, located, or changed transport direction */
 	samplepos_t _last_roll_or_reversal_location;
@@ -1924,6 +1940,7 @@ private:
 	boost::shared_ptr<Route> XMLRouteFactory (const XMLNode&, int);
 	boost::shared_ptr<Route> XMLRouteFactory_2X (const XMLNode&, int);
 	boost::shared_ptr<Route> XMLRouteFactory_3X (const XMLNode&, int);
+	void load_route_task (const XMLNode*, int, boost::shared_ptr<Route>*, std::exception_ptr*);
 
 	void route_processors_changed (RouteProcessorChange);
 
@@ -1986,6 +2003,7 @@ private:
 	SourceMap sources;
 
 	int load_sources (const XMLNode& node);
+	void load_source_task (const XMLNode*, boost::shared_ptr<Source>*);
 	XMLNode& get_sources_as_xml ();
 
 	boost::shared_ptr<Source> XMLSourceFactory (const XMLNode&);
@@ -2000,6 +2018,7 @@ private:
 
 	/* CURVES and AUTOMATION LISTS */
 	std::map<PBD::ID, AutomationList*> automation_lists;
+	Glib::Threads::Mutex               automation_lists_lock; ///< lists may be created concurrently while loading
 
 	/** load 2.X Sessions. Diskstream-ID to playlist-name mapping */
 	std::map<PBD::ID, std::string> _diskstreams_2X;
@@ -2028,6 +2047,7 @@ private:
 	boost::dynamic_bitset<uint32_t> aux_send_bitset;
 	boost::dynamic_bitset<uint32_t> return_bitset;
 	boost::dynamic_bitset<uint32_t> insert_bitset;
+	Glib::Threads::Mutex            bitset_lock; ///< processors may be created concurrently while loading
 
 	/* S/W RAID */
 
@@ -2064,6 +2084,7 @@ private:
 	Glib::Threads::Mutex space_lock;
 
 	bool no_questions_about_missing_files;
+	bool _loading_sources_concurrently;
 
 	std::string get_best_session_directory_for_new_audio ();
 
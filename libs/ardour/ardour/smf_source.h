@@ -26,6 +26,7 @@
 #include <cstdio>
 #include <time.h>
 #include "evoral/SMF.h"
+#include "evoral/SMFIndex.h"
 #include "ardour/midi_source.h"
 #include "ardour/file_source.h"
 
@@ -79,20 +80,31 @@ public:
 	/** Query the smf file for its channel info */
 	SMF::UsedChannels used_midi_channels();
 
+	bool read_notes (Evoral::Sequence<Temporal::Beats>::Notes&) const;
+	bool note_range (uint8_t& lowest, uint8_t& highest) const;
+
   protected:
 	void close ();
 	void flush_midi (const WriterLock& lock);
 
   private:
 	bool _open;
+
+	/** set while the file is read through an index of its events,
+	 *  instead of being loaded by libsmf.
+	 */
+	Evoral::SMFIndex* _index;
+	/** reads the file for playback while there is an index, opened on first use */
+	mutable Evoral::SMFIndex::Reader* _index_reader;
+
+	/** serializes seek_to_*() and read_event() sequences, of libsmf and of _index_reader */
+	mutable Glib::Threads::Mutex _read_cursor_lock;
 	Temporal::Beats   _last_ev_time_beats;
 	samplepos_t       _last_ev_time_samples;
-	/** end time (start + duration) of last call to read_unlocked */
-	mutable timepos_t _smf_last_read_end;
-	/** time (in SMF ticks, 1 tick per _ppqn) of the last event read by read_unlocked */
-	mutable timepos_t _smf_last_read_time;
 
 	int open_for_write ();
+	int open_index ();
+	void drop_index ();
 
 	void ensure_disk_file (const WriterLock& lock);
 
@@ -110,7 +122,11 @@ public:
 	                          timepos_t const &            position,
 	                          timecnt_t const &            cnt);
 
+	typedef std::list< std::pair< Evoral::Event<Temporal::Beats>*, Evoral::event_id_t > > LoadedEvents;
+
 	void load_model_unlocked (bool force_reload=false);
+	void load_or_defer_model_unlocked ();
+	void scan_unlocked (LoadedEvents* events);
 
 };
 
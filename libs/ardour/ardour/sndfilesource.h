@@ -27,6 +27,8 @@
 
 #include <sndfile.h>
 
+#include <glibmm/threads.h>
+
 #include "ardour/audiofilesource.h"
 #include "ardour/broadcast_info.h"
 #include "ardour/progress.h"
@@ -81,17 +83,33 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	void set_header_natural_position ();
 
 	samplecnt_t read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const;
+	void prefetch (samplepos_t start, samplecnt_t cnt) const;
 	samplecnt_t write_unlocked (Sample *dst, samplecnt_t cnt);
 	samplecnt_t write_float (Sample* data, samplepos_t pos, samplecnt_t cnt);
 
   private:
 	SNDFILE* _sndfile;
+	int      _fd;
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
 
+	/* read-only mapping of uncompressed little-endian files */
+	char*  _map;
+	size_t _map_length;
+	size_t _map_offset;     ///< offset of the sample data in the file
+	size_t _map_frame_size;
+
+	/* libsndfile handles are not re-entrant (seek + read), and the
+	 * butler may refill several tracks sharing this source concurrently.
+	 */
+	mutable Glib::Threads::Mutex _read_lock;
+
 	void init_sndfile ();
 	int open();
 	int setup_broadcast_info (samplepos_t when, struct tm&, time_t);
+	void setup_mapping ();
+	void release_mapping ();
+	void read_mapped (Sample* dst, samplepos_t start, samplecnt_t cnt) const;
 	void file_closed ();
 
 	void set_natural_position (timepos_t const &);
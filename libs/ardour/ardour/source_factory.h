@@ -43,7 +43,7 @@ public:
 
 	static PBD::Signal1<void, boost::shared_ptr<Source>> SourceCreated;
 
-	static boost::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false);
+	static boost::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false, bool announce = true);
 	static boost::shared_ptr<Source> createSilent (Session&, const XMLNode& node, samplecnt_t, float sample_rate);
 	static boost::shared_ptr<Source> createExternal (DataType, Session&, const std::string& path, int chn, Source::Flag, bool announce = true, bool async = false);
 	static boost::shared_ptr<Source> createWritable (DataType, Session&, const std::string& path, samplecnt_t rate, bool announce = true, bool async = false);
@@ -60,6 +60,11 @@ public:
 
 	static int peak_work_queue_length ();
 	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
+
+	/** Move a source which is waiting for its peakfile to be built to the
+	 * front of the queue, e.g. because it is visible.
+	 */
+	static void prioritize_peakfile (AudioSource const*);
 };
 
 } // namespace ARDOUR
@@ -141,9 +141,11 @@ public:
 	std::list<boost::shared_ptr<Source> > & last_capture_sources ();
 	std::string steal_write_source_name ();
 	void reset_write_sources (bool, bool force = false);
+	boost::shared_ptr<DiskReader> disk_reader () const { return _disk_reader; }
 	float playback_buffer_load () const;
 	float capture_buffer_load () const;
 	int do_refill ();
+	int do_refill (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer);
 	int do_flush (RunContext, bool force = false);
 	void set_pending_overwrite (OverwriteReason);
 	int seek (samplepos_t, bool complete_refill = false);
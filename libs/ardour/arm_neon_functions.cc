@@ -515,4 +515,106 @@ arm_neon_copy_vector(
 	}
 }
 
+/* The ramp g[i+1] = g[i] + coeff * (target - g[i]) is a one-pole lowpass,
+ * in closed form g[i] = target + (initial - target) * (1 - coeff)^i.
+ * This allows to compute 4 consecutive gain values at a time.
+ */
+C_FUNC float
+arm_neon_apply_gain_ramp(
+	float *dst, const float *src,
+	uint32_t nframes, float initial, float target, float coeff)
+{
+	const float r = 1.f - coeff;
+	float d = initial - target;
+
+	if (nframes >= 4) {
+		const float r2 = r * r;
+		const float p[4] = { 1.f, r, r2, r2 * r };
+		const float32x4_t vt = vdupq_n_f32(target);
+		float32x4_t vd = vmulq_n_f32(vld1q_f32(p), d);
+
+		while (nframes >= 4) {
+			float32x4_t x0 = vld1q_f32(src);
+			vst1q_f32(dst, vmulq_f32(x0, vaddq_f32(vt, vd)));
+			vd = vmulq_n_f32(vd, r2 * r2);
+
+			src += 4;
+			dst += 4;
+			nframes -= 4;
+		}
+
+		d = vgetq_lane_f32(vd, 0);
+	}
+
+	// Do the remaining samples
+	while (nframes > 0) {
+		*dst++ = *src++ * (target + d);
+		d *= r;
+		--nframes;
+	}
+
+	return target + d;
+}
+
+/* Each peak is computed from overlapping loads: the first and last four
+ * samples of the peak plus all whole vectors in between. Since min/max
+ * do not care about duplicates, no scalar tail is needed.
+ */
+C_FUNC void
+arm_neon_reduce_peaks(
+	const float *src, uint32_t nframes,
+	uint32_t fpp, ARDOUR::PeakData *peaks)
+{
+	while (nframes > 0) {
+		const uint32_t n = fpp < nframes ? fpp : nframes;
+
+		if (n < 4) {
+			float a = src[0];
+			float b = src[0];
+			for (uint32_t i = 1; i < n; ++i) {
+				a = src[i] > a ? src[i] : a;
+				b = src[i] < b ? src[i] : b;
+			}
+			peaks->max = a;
+			peaks->min = b;
+		} else {
+			float32x4_t vmin0 = vld1q_f32(src);
+			float32x4_t vmax0 = vmin0;
+			float32x4_t vmin1 = vld1q_f32(src + n - 4);
+			float32x4_t vmax1 = vmin1;
+			uint32_t i = 4;
+
+			for (; i + 8 <= n; i += 8) {
+				float32x4_t x0 = vld1q_f32(src + i);
+				float32x4_t x1 = vld1q_f32(src + i + 4);
+				vmin0 = vminq_f32(vmin0, x0);
+				vmax0 = vmaxq_f32(vmax0, x0);
+				vmin1 = vminq_f32(vmin1, x1);
+				vmax1 = vmaxq_f32(vmax1, x1);
+			}
+
+			if (i + 4 <= n) {
+				float32x4_t x0 = vld1q_f32(src + i);
+				vmin0 = vminq_f32(vmin0, x0);
+				vmax0 = vmaxq_f32(vmax0, x0);
+			}
+
+			vmin0 = vminq_f32(vmin0, vmin1);
+			vmax0 = vmaxq_f32(vmax0, vmax1);
+
+			float32x2_t min0 = vpmin_f32(vget_low_f32(vmin0), vget_high_f32(vmin0));
+			float32x2_t max0 = vpmax_f32(vget_low_f32(vmax0), vget_high_f32(vmax0));
+			min0 = vpmin_f32(min0, min0);
+			max0 = vpmax_f32(max0, max0);
+
+			peaks->max = vget_lane_f32(max0, 0);
+			peaks->min = vget_lane_f32(min0, 0);
+		}
+
+		++peaks;
+		src += n;
+		nframes -= n;
+	}
+}
+
 #endif
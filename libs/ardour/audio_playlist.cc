@@ -169,6 +169,20 @@ struct Segment {
 	Temporal::Range range;       ///< range of the region to read, in session samples
 };
 
+/** The segments of regions that need to be read for a range of the
+ *  playlist, in the order that they have to be read.
+ */
+struct AudioPlaylist::ReadPlan {
+	ReadPlan (timepos_t const & s, timepos_t const & e, gint g) : range (s, e), generation (g) {}
+
+	Temporal::Range    range;      ///< range covered by the plan, in session samples
+	gint               generation; ///< Playlist::generation () the plan is valid for
+	std::vector<Segment> segments;
+};
+
+/** Number of reads of the same size that a read plan is made for */
+static const samplecnt_t read_plan_chunks = 8;
+
 /** @param start Start position in session samples.
  *  @param cnt Number of samples to read.
  */
@@ -199,10 +213,77 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, ti
 
 	Playlist::RegionReadLock rl (this);
 
-	/* Find all the regions that are involved in the bit we are reading,
+	boost::shared_ptr<ReadPlan const> plan (read_plan (start, cnt));
+	timepos_t const                   end (start + cnt);
+
+	/* Go through the plan doing the actual reads, the plan
+	   usually covers more than this read.
+	*/
+
+	for (std::vector<Segment>::const_iterator i = plan->segments.begin(); i != plan->segments.end(); ++i) {
+		timepos_t const s (max (i->range.start(), start));
+		timepos_t const e (min (i->range.end(), end));
+
+		if (s >= e) {
+			continue;
+		}
+
+		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("\tPlaylist %1 read %2 @ %3 for %4, channel %5, buf @ %6 offset %7\n",
+		                                                   name(), i->region->name(), s,
+		                                                   s.distance (e), (int) chan_n,
+		                                                   buf, s.earlier (start)));
+
+		i->region->read_at (buf + start.distance (s).samples(), mixdown_buffer, gain_buffer, s.samples(), s.distance (e).samples(), chan_n);
+	}
+
+	return cnt;
+}
+
+/** @return a read plan which covers the given range. This re-uses the
+ *  previous plan, if it is still valid and covers the range, and otherwise
+ *  plans ahead for the next few reads (in the direction of reading).
+ *
+ *  Caller must hold the region lock.
+ */
+boost::shared_ptr<AudioPlaylist::ReadPlan const>
+AudioPlaylist::read_plan (timepos_t const & start, timecnt_t const & cnt)
+{
+	timepos_t const end (start + cnt);
+	gint const      generation = this->generation ();
+
+	/* solo selection is not covered by the playlist's generation */
+	bool const cacheable = !(_session.solo_selection_active() && SoloSelectedActive());
+
+	samplepos_t plan_start = start.samples ();
+	samplepos_t plan_end   = end.samples ();
+
+	{
+		Glib::Threads::Mutex::Lock lm (_read_plan_lock);
+
+		if (cacheable && _read_plan && _read_plan->generation == generation) {
+			if (_read_plan->range.start() <= start && end <= _read_plan->range.end()) {
+				return _read_plan;
+			}
+			if (start < _read_plan->range.start()) {
+				/* reading backwards */
+				plan_start = max<samplepos_t> (0, plan_end - cnt.samples() * read_plan_chunks);
+			} else {
+				plan_end = plan_start + cnt.samples() * read_plan_chunks;
+			}
+		} else if (cacheable) {
+			plan_end = plan_start + cnt.samples() * read_plan_chunks;
+		}
+	}
+
+	boost::shared_ptr<ReadPlan> plan (new ReadPlan (timepos_t (plan_start), timepos_t (plan_end), generation));
+
+	timepos_t const pstart (plan->range.start());
+	timepos_t const pend (plan->range.end());
+
+	/* Find all the regions that are involved in the bit we are planning,
 	   and sort them by descending layer and ascending position.
 	*/
-	boost::shared_ptr<RegionList> all = regions_touched_locked (start, start + cnt);
+	boost::shared_ptr<RegionList> all = regions_touched_locked (pstart, pend);
 	all->sort (ReadSorter ());
 
 	/* This will be a list of the bits of our read range that we have
@@ -230,11 +311,11 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, ti
 		}
 
 		/* Work out which bits of this region need to be read;
-		   first, trim to the range we are reading...
+		   first, trim to the range we are planning for...
 		*/
 		Temporal::Range rrange = ar->range_samples ();
-		Temporal::Range region_range (max (rrange.start(), start),
-		                              min (rrange.end(), start + cnt));
+		Temporal::Range region_range (max (rrange.start(), pstart),
+		                              min (rrange.end(), pend));
 
 		/* ... and then remove the bits that are already done */
 
@@ -263,18 +344,33 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, ti
 		}
 	}
 
-	/* Now go backwards through the to_do list doing the actual reads */
+	/* The reads have to be done backwards through the to_do list */
+	plan->segments.assign (to_do.rbegin(), to_do.rend());
 
-	for (list<Segment>::reverse_iterator i = to_do.rbegin(); i != to_do.rend(); ++i) {
-		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("\tPlaylist %1 read %2 @ %3 for %4, channel %5, buf @ %6 offset %7\n",
-		                                                   name(), i->region->name(), i->range.start(),
-		                                                   i->range.length(), (int) chan_n,
-		                                                   buf, i->range.start().earlier (start)));
-
-		i->region->read_at (buf + start.distance (i->range.start()).samples(), mixdown_buffer, gain_buffer, i->range.start().samples(), i->range.start().distance (i->range.end()).samples(), chan_n);
+	if (cacheable) {
+		Glib::Threads::Mutex::Lock lm (_read_plan_lock);
+		_read_plan = plan;
 	}
 
-	return cnt;
+	return plan;
+}
+
+/** Tell the sources of all regions touching the given range that
+ * the range is about to be read.
+ */
+void
+AudioPlaylist::prefetch (timepos_t const & start, timecnt_t const & cnt, uint32_t chan_n)
+{
+	Playlist::RegionReadLock rl (this);
+
+	boost::shared_ptr<RegionList> all = regions_touched_locked (start, start + cnt);
+
+	for (RegionList::const_iterator i = all->begin(); i != all->end(); ++i) {
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+		if (ar) {
+			ar->prefetch (start.samples(), cnt.samples(), chan_n);
+		}
+	}
 }
 
 void
@@ -320,6 +416,7 @@ AudioPlaylist::destroy_region (boost::shared_ptr<Region> region)
 			if ((*i) == region) {
 				regions.erase (i);
 				changed = true;
+				region_index_remove (region);
 			}
 
 			i = tmp;
@@ -165,6 +165,7 @@ AudioFileSource::~AudioFileSource ()
 	if (removable()) {
 		::g_unlink (_path.c_str());
 		::g_unlink (_peakpath.c_str());
+		::g_unlink (peak_levels_path ().c_str());
 	}
 }
 
@@ -261,6 +262,7 @@ AudioFileSource::mark_streaming_write_completed (const WriterLock& lock)
 int
 AudioFileSource::move_dependents_to_trash()
 {
+	::g_unlink (peak_levels_path ().c_str());
 	return ::g_unlink (_peakpath.c_str());
 }
 
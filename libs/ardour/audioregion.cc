@@ -589,6 +589,22 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 		}
 	}
 
+	bool is_opaque = opaque();
+
+	/* An opaque region without fades or gain in this range replaces
+	   whatever is in buf, so it is a plain copy from the source.
+	   Still read via mixdown_buffer, so that a short read leaves
+	   buf (and the regions below this one) untouched, as below.
+	*/
+
+	if (is_opaque && fade_in_limit == 0 && fade_out_limit == 0 && !envelope_active() && _scale_amplitude == 1.0f) {
+		if (read_from_sources (_sources, lsamples, mixdown_buffer, pos, to_read, chan_n) != to_read) {
+			return 0;
+		}
+		memcpy (buf, mixdown_buffer, to_read * sizeof (Sample));
+		return to_read;
+	}
+
 	/* READ DATA FROM THE SOURCE INTO mixdown_buffer.
 	   We can never read directly into buf, since it may contain data
 	   from a region `below' this one in the stack, and our fades (if they exist)
@@ -624,8 +640,6 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 	 * fades out the existing material.
 	 */
 
-	bool is_opaque = opaque();
-
 	if (fade_in_limit != 0) {
 
 		if (is_opaque) {
@@ -728,6 +742,36 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 	return to_read;
 }
 
+/** Pass a read-ahead hint for the given range (in session samples) of
+ * channel @p chan_n to the source that read_at() would read from.
+ */
+void
+AudioRegion::prefetch (samplepos_t pos, samplecnt_t cnt, uint32_t chan_n) const
+{
+	if (n_channels () == 0 || muted ()) {
+		return;
+	}
+
+	samplepos_t const psamples = position ().samples ();
+	samplepos_t const s        = max (pos, psamples);
+	samplepos_t const e        = min (pos + cnt, psamples + _length.val ().samples ());
+
+	if (e <= s) {
+		return;
+	}
+
+	uint32_t channel = chan_n;
+
+	if (chan_n >= n_channels ()) {
+		if (!Config->get_replicate_missing_region_channels ()) {
+			return;
+		}
+		channel = chan_n % n_channels ();
+	}
+
+	audio_source (channel)->prefetch (_start.val ().samples () + (s - psamples), e - s);
+}
+
 /** Read data directly from one of our sources, accounting for the situation when the track has a different channel
  *  count to the region.
  *
@@ -739,7 +783,6 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
  *  @param chan_n Channel to read from.
  *  @return Number of samples read.
  */
-
 samplecnt_t
 AudioRegion::read_from_sources (SourceList const & srcs, samplecnt_t limit, Sample* buf, samplepos_t pos, samplecnt_t cnt, uint32_t chan_n) const
 {
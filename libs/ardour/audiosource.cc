@@ -60,9 +60,11 @@
 #include "pbd/xml++.h"
 
 #include "ardour/audiosource.h"
+#include "ardour/filename_extensions.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
+#include "ardour/source_factory.h"
 
 #include "pbd/i18n.h"
 
@@ -79,10 +81,55 @@ bool AudioSource::_build_peakfiles = false;
 
 #define _FPP 256
 
+/* Peak levels
+ *
+ * Besides the peakfile (_FPP samples per peak) every source has a levels
+ * file holding power-of-two reductions of it: level N (1 <= N <= peak_levels)
+ * has _FPP << N samples per peak. It is written alongside the peakfile,
+ * or built from an existing peakfile (e.g. of older sessions).
+ *
+ * After a header the file is made of blocks, each covering
+ * (1 << peak_levels) peakfile peaks with the same number of entries:
+ * all level 1 peaks of the block, then all level 2 peaks, and so on, with
+ * one unused entry at the end. So the levels need no more space than the
+ * peakfile itself, and can be written block by block while capturing.
+ */
+
+static const uint32_t peak_levels = 12;
+static const samplecnt_t peak_levels_block_size = 1 << peak_levels;
+
+struct PeakLevelsHeader {
+	char     magic[8];
+	uint32_t version;
+	uint32_t levels;
+	int64_t  base_peaks; ///< number of peakfile peaks, 0 while writing
+};
+
+static const char peak_levels_magic[8] = { 'A', 'R', 'D', 'P', 'K', 'L', 'V', 'L' };
+
+/** @return index of the first peak of @a level in a block of the levels file */
+static inline samplecnt_t
+peak_level_offset (uint32_t level)
+{
+	return peak_levels_block_size - (peak_levels_block_size >> (level - 1));
+}
+
+/** @return file offset of peak @a peak of @a level */
+static inline off_t
+peak_level_byte (uint32_t level, samplepos_t peak)
+{
+	const uint32_t    shift = peak_levels - level; // peaks of this level per block are 1 << shift
+	const samplecnt_t entry = ((peak >> shift) << peak_levels) + peak_level_offset (level) + (peak & ((1 << shift) - 1));
+	return sizeof (PeakLevelsHeader) + entry * sizeof (PeakData);
+}
+
 AudioSource::AudioSource (Session& s, const string& name)
 	: Source (s, DataType::AUDIO, name)
 	, _peak_byte_max (0)
 	, _peaks_built (false)
+	, _peak_build_start (0)
+	, _peak_build_done (0)
+	, _peak_build_total (0)
 	, _peakfile_fd (-1)
 	, peak_leftover_cnt (0)
 	, peak_leftover_size (0)
@@ -92,6 +139,10 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _peak_levels_fd (-1)
+	, _peak_levels_base (0)
+	, _peak_levels_valid (0)
+	, _peak_levels_complete (0)
 {
 }
 
@@ -99,6 +150,9 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	: Source (s, node)
 	, _peak_byte_max (0)
 	, _peaks_built (false)
+	, _peak_build_start (0)
+	, _peak_build_done (0)
+	, _peak_build_total (0)
 	, _peakfile_fd (-1)
 	, peak_leftover_cnt (0)
 	, peak_leftover_size (0)
@@ -108,6 +162,10 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _peak_levels_fd (-1)
+	, _peak_levels_base (0)
+	, _peak_levels_valid (0)
+	, _peak_levels_complete (0)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -127,6 +185,11 @@ AudioSource::~AudioSource ()
 		_peakfile_fd = -1;
 	}
 
+	if (-1 != _peak_levels_fd) {
+		close (_peak_levels_fd);
+		_peak_levels_fd = -1;
+	}
+
 	delete [] peak_leftovers;
 }
 
@@ -179,16 +242,54 @@ bool
 AudioSource::peaks_ready (boost::function<void()> doThisWhenReady, ScopedConnection** connect_here_if_not, EventLoop* event_loop) const
 {
 	bool ret;
-	Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 
-	if (!(ret = _peaks_built)) {
-		*connect_here_if_not = new ScopedConnection;
-		PeaksReady.connect (**connect_here_if_not, MISSING_INVALIDATOR, doThisWhenReady, event_loop);
+	{
+		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
+
+		if (!(ret = _peaks_built)) {
+			*connect_here_if_not = new ScopedConnection;
+			PeaksReady.connect (**connect_here_if_not, MISSING_INVALIDATOR, doThisWhenReady, event_loop);
+		}
+	}
+
+	if (!ret) {
+		/* someone wants to display these peaks, build them before
+		 * those of other sources that are still waiting.
+		 */
+		SourceFactory::prioritize_peakfile (this);
 	}
 
 	return ret;
 }
 
+bool
+AudioSource::peak_build_progress (float& fraction, double& eta) const
+{
+	const int64_t start = _peak_build_start.load ();
+
+	if (start == 0) {
+		return false;
+	}
+
+	const samplecnt_t total = _peak_build_total.load ();
+	const samplecnt_t done  = std::min (_peak_build_done.load (), total);
+
+	if (total <= 0) {
+		return false;
+	}
+
+	fraction = done / (float) total;
+
+	if (done > 0) {
+		const double elapsed = (g_get_monotonic_time () - start) * 1e-6;
+		eta = elapsed * (total - done) / (double) done;
+	} else {
+		eta = -1;
+	}
+
+	return true;
+}
+
 void
 AudioSource::touch_peakfile ()
 {
@@ -204,6 +305,14 @@ AudioSource::touch_peakfile ()
 	tbuf.modtime = time ((time_t*) 0);
 
 	g_utime (_peakpath.c_str(), &tbuf);
+
+	/* keep the levels at least as new as the peakfile */
+	string const levels = peak_levels_path ();
+
+	if (g_stat (levels.c_str(), &statbuf) == 0) {
+		tbuf.actime = statbuf.st_atime;
+		g_utime (levels.c_str(), &tbuf);
+	}
 }
 
 int
@@ -220,8 +329,19 @@ AudioSource::rename_peakfile (string newpath)
 		}
 	}
 
+	string const old_levels = peak_levels_path ();
+
 	_peakpath = newpath;
 
+	if (Glib::file_test (old_levels, Glib::FILE_TEST_EXISTS)) {
+		if (g_rename (old_levels.c_str(), peak_levels_path ().c_str()) != 0) {
+			/* not fatal, the levels are rebuilt when needed */
+			::g_unlink (old_levels.c_str());
+			g_atomic_int_set (&_peak_levels_valid, 0);
+			g_atomic_int_set (&_peak_levels_complete, 0);
+		}
+	}
+
 	return 0;
 }
 
@@ -298,6 +418,9 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 
 	if (!empty() && !_peaks_built && _build_missing_peakfiles && _build_peakfiles) {
 		build_peaks_from_scratch ();
+	} else if (!empty() && _peaks_built && !load_peak_levels () && _build_peakfiles) {
+		/* e.g. peakfiles of older versions, which have no levels */
+		build_peak_levels ();
 	}
 
 	return 0;
@@ -324,6 +447,12 @@ AudioSource::write (Sample *dst, samplecnt_t cnt)
 int
 AudioSource::read_peaks (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const
 {
+	uint32_t const level = peak_level (start, cnt, samples_per_visual_peak);
+
+	if (level > 0 && read_peak_level (peaks, npeaks, start, cnt, samples_per_visual_peak, level) == 0) {
+		return 0;
+	}
+
 	return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, _FPP);
 }
 
@@ -664,6 +793,47 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 
 		memcpy ((void*)peaks, (void*)peak_cache.get(), npeaks * sizeof(PeakData));
 
+	} else if (samples_per_visual_peak == floor (samples_per_visual_peak)) {
+		DEBUG_TRACE (DEBUG::Peaks, "UPSAMPLE (whole samples per peak)\n");
+
+		/* Like the generic case below, but visual peaks start at multiples
+		 * of samples_per_visual_peak, so after the first one (which may be
+		 * shorter) whole chunks of raw data can be reduced at once.
+		 */
+
+		const samplecnt_t spp         = (samplecnt_t) samples_per_visual_peak;
+		const samplecnt_t chunk_peaks = max ((samplecnt_t) 1, (samplecnt_t) 4096 / spp);
+		boost::scoped_array<Sample> raw_staging (new Sample[chunk_peaks * spp]);
+
+		samplepos_t current_sample = start;
+		samplecnt_t nvisual_peaks  = 0;
+
+		while (nvisual_peaks < read_npeaks && current_sample < _length.samples()) {
+
+			const samplecnt_t fpp   = (nvisual_peaks == 0) ? spp - (current_sample % spp) : spp;
+			const samplecnt_t n     = (nvisual_peaks == 0) ? 1 : min (chunk_peaks, read_npeaks - nvisual_peaks);
+			const samplecnt_t avail = _length.samples() - current_sample;
+			samplecnt_t samples_read;
+
+			to_read = min (fpp * n, avail);
+
+			if ((samples_read = read_unlocked (raw_staging.get(), current_sample, to_read)) == 0) {
+				error << string_compose(_("AudioSource[%1]: peak read - cannot read %2 samples at offset %3 of %4 (%5)"),
+				                        _name, to_read, current_sample, _length, strerror (errno))
+				     << endmsg;
+				return -1;
+			}
+
+			ARDOUR::reduce_peaks (raw_staging.get(), samples_read, fpp, &peaks[nvisual_peaks]);
+
+			nvisual_peaks  += (samples_read + fpp - 1) / fpp;
+			current_sample += samples_read;
+		}
+
+		if (nvisual_peaks < npeaks) {
+			memset (&peaks[nvisual_peaks], 0, sizeof (PeakData) * (npeaks - nvisual_peaks));
+		}
+
 	} else {
 		DEBUG_TRACE (DEBUG::Peaks, "UPSAMPLE\n");
 
@@ -774,6 +944,10 @@ AudioSource::build_peaks_from_scratch ()
 		_peaks_built = false;
 		boost::scoped_array<Sample> buf(new Sample[bufsize]);
 
+		_peak_build_total = cnt;
+		_peak_build_done  = 0;
+		_peak_build_start = g_get_monotonic_time ();
+
 		while (cnt) {
 
 			samplecnt_t samples_to_read = min (bufsize, cnt);
@@ -794,6 +968,9 @@ AudioSource::build_peaks_from_scratch ()
 				goto out;
 			}
 
+			/* update before PeakRangeReady is emitted */
+			_peak_build_done = current_sample + samples_read;
+
 			if (compute_and_write_peaks (buf.get(), current_sample, samples_read, true, false, _FPP)) {
 				break;
 			}
@@ -816,9 +993,12 @@ AudioSource::build_peaks_from_scratch ()
 	}
 
   out:
+	_peak_build_start = 0;
+
 	if (ret) {
 		DEBUG_TRACE (DEBUG::Peaks, string_compose("Could not write peak data, attempting to remove peakfile %1\n", _peakpath));
 		::g_unlink (_peakpath.c_str());
+		::g_unlink (peak_levels_path ().c_str());
 	}
 
 	return ret;
@@ -832,9 +1012,16 @@ AudioSource::close_peakfile ()
 		close (_peakfile_fd);
 		_peakfile_fd = -1;
 	}
+	if (-1 != _peak_levels_fd) {
+		close (_peak_levels_fd);
+		_peak_levels_fd = -1;
+	}
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
+		::g_unlink (peak_levels_path ().c_str());
 	}
+	g_atomic_int_set (&_peak_levels_valid, 0);
+	g_atomic_int_set (&_peak_levels_complete, 0);
 	_peaks_built = false;
 	return 0;
 }
@@ -850,6 +1037,10 @@ AudioSource::prepare_for_peakfile_writes ()
 		error << string_compose(_("AudioSource: cannot open _peakpath (c) \"%1\" (%2)"), _peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
+
+	/* levels are optional, failing to write them is not an error */
+	start_peak_levels ();
+
 	return 0;
 }
 
@@ -861,6 +1052,7 @@ AudioSource::done_with_peakfile_writes (bool done)
 			close (_peakfile_fd);
 			_peakfile_fd = -1;
 		}
+		finish_peak_levels (false);
 		return;
 	}
 
@@ -868,6 +1060,8 @@ AudioSource::done_with_peakfile_writes (bool done)
 		compute_and_write_peaks (0, 0, 0, true, false, _FPP);
 	}
 
+	finish_peak_levels (done);
+
 	if (-1 != _peakfile_fd) {
 		close (_peakfile_fd);
 		_peakfile_fd = -1;
@@ -939,6 +1133,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 
 			_peak_byte_max = max (_peak_byte_max, (off_t) (byte + sizeof(PeakData)));
 
+			if (fpp == _FPP) {
+				add_peak_levels (&x, peak_leftover_sample / fpp, 1);
+			}
+
 			{
 				Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 				PeakRangeReady (peak_leftover_sample, peak_leftover_cnt); /* EMIT SIGNAL */
@@ -985,46 +1183,33 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 	}
 
 	boost::scoped_array<PeakData> peakbuf(new PeakData[(to_do/fpp)+1]);
-	peaks_computed = 0;
 	current_sample = first_sample;
-	samples_done = 0;
-
-	while (to_do) {
 
-		/* if some samples were passed in (i.e. we're not flushing leftovers)
-		   and there are less than fpp to do, save them till
-		   next time
-		*/
+	/* if some samples were passed in (i.e. we're not flushing leftovers)
+	   only compute whole peaks, and save the rest till next time.
+	*/
 
-		if (force && (to_do < fpp)) {
-			/* keep the left overs around for next time */
+	samples_done = force ? (to_do / fpp) * fpp : to_do;
+	peaks_computed = (samples_done + fpp - 1) / fpp;
 
-			if (peak_leftover_size < to_do) {
-				delete [] peak_leftovers;
-				peak_leftovers = new Sample[to_do];
-				peak_leftover_size = to_do;
-			}
-			memcpy (peak_leftovers, buf, to_do * sizeof (Sample));
-			peak_leftover_cnt = to_do;
-			peak_leftover_sample = current_sample;
+	if (samples_done) {
+		ARDOUR::reduce_peaks (buf, samples_done, fpp, peakbuf.get());
+		buf += samples_done;
+		to_do -= samples_done;
+		current_sample += samples_done;
+	}
 
-			/* done for now */
+	if (to_do) {
+		/* keep the left overs around for next time */
 
-			break;
+		if (peak_leftover_size < to_do) {
+			delete [] peak_leftovers;
+			peak_leftovers = new Sample[to_do];
+			peak_leftover_size = to_do;
 		}
-
-		samplecnt_t this_time = min (fpp, to_do);
-
-		peakbuf[peaks_computed].max = buf[0];
-		peakbuf[peaks_computed].min = buf[0];
-
-		ARDOUR::find_peaks (buf+1, this_time-1, &peakbuf[peaks_computed].min, &peakbuf[peaks_computed].max);
-
-		peaks_computed++;
-		buf += this_time;
-		to_do -= this_time;
-		samples_done += this_time;
-		current_sample += this_time;
+		memcpy (peak_leftovers, buf, to_do * sizeof (Sample));
+		peak_leftover_cnt = to_do;
+		peak_leftover_sample = current_sample;
 	}
 
 	first_peak_byte = (first_sample / fpp) * sizeof (PeakData);
@@ -1067,6 +1252,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 
 	_peak_byte_max = max (_peak_byte_max, (off_t) (first_peak_byte + bytes_to_write));
 
+	if (fpp == _FPP) {
+		add_peak_levels (peakbuf.get(), first_sample / fpp, peaks_computed);
+	}
+
 	if (samples_done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		PeakRangeReady (first_sample, samples_done); /* EMIT SIGNAL */
@@ -1100,6 +1289,365 @@ AudioSource::truncate_peakfile ()
 	}
 }
 
+string
+AudioSource::peak_levels_path () const
+{
+	return _peakpath + peak_levels_suffix;
+}
+
+/** Check if the levels file on disk matches the peakfile, and use it if so.
+ *  @return true if the levels can be used.
+ */
+bool
+AudioSource::load_peak_levels ()
+{
+	string const path = peak_levels_path ();
+	GStatBuf     peak_stat;
+	GStatBuf     levels_stat;
+
+	g_atomic_int_set (&_peak_levels_valid, 0);
+	g_atomic_int_set (&_peak_levels_complete, 0);
+
+	if (g_stat (_peakpath.c_str(), &peak_stat) || g_stat (path.c_str(), &levels_stat)) {
+		return false;
+	}
+
+	if (levels_stat.st_mtime < peak_stat.st_mtime) {
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peak levels %1 are older than the peakfile\n", path));
+		return false;
+	}
+
+	ScopedFileDescriptor sfd (g_open (path.c_str(), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		return false;
+	}
+
+	PeakLevelsHeader header;
+
+	if (::read (sfd, &header, sizeof (header)) != sizeof (header)
+	    || memcmp (header.magic, peak_levels_magic, sizeof (header.magic))
+	    || header.version != 1
+	    || header.levels != peak_levels
+	    || header.base_peaks <= 0
+	    || header.base_peaks != (int64_t) (_peak_byte_max / sizeof (PeakData))
+	    || header.base_peaks > G_MAXINT) {
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peak levels %1 do not match the peakfile\n", path));
+		return false;
+	}
+
+	g_atomic_int_set (&_peak_levels_valid, (gint) header.base_peaks);
+	g_atomic_int_set (&_peak_levels_complete, 1);
+	return true;
+}
+
+/** Build the levels file from the existing peakfile */
+int
+AudioSource::build_peak_levels ()
+{
+	const samplecnt_t bufsize = 65536;
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Building peak levels for %1\n", _peakpath));
+
+	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		return -1;
+	}
+
+	if (start_peak_levels ()) {
+		return -1;
+	}
+
+	const samplecnt_t npeaks = _peak_byte_max / sizeof (PeakData);
+	samplepos_t       peak   = 0;
+
+	boost::scoped_array<PeakData> buf (new PeakData[bufsize]);
+
+	while (peak < npeaks) {
+
+		if (_session.deletion_in_progress() || _session.peaks_cleanup_in_progres()) {
+			finish_peak_levels (false);
+			return -1;
+		}
+
+		ssize_t const n = ::read (sfd, buf.get(), sizeof (PeakData) * min (bufsize, npeaks - peak));
+
+		if (n <= 0 || (n % sizeof (PeakData))) {
+			error << string_compose (_("%1: could not read peak file data (%2)"), _name, strerror (errno)) << endmsg;
+			finish_peak_levels (false);
+			return -1;
+		}
+
+		add_peak_levels (buf.get(), peak, n / sizeof (PeakData));
+		peak += n / sizeof (PeakData);
+	}
+
+	finish_peak_levels (true);
+	return 0;
+}
+
+/** Start writing the levels file from scratch.
+ *  @return 0 on success.
+ */
+int
+AudioSource::start_peak_levels ()
+{
+	if (-1 != _peak_levels_fd) {
+		close (_peak_levels_fd);
+		_peak_levels_fd = -1;
+	}
+
+	g_atomic_int_set (&_peak_levels_valid, 0);
+	g_atomic_int_set (&_peak_levels_complete, 0);
+	_peak_levels_base = 0;
+
+	string const path = peak_levels_path ();
+
+	if ((_peak_levels_fd = g_open (path.c_str(), O_CREAT|O_RDWR|O_TRUNC, 0664)) == -1) {
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Cannot open peak levels %1 (%2)\n", path, strerror (errno)));
+		return -1;
+	}
+
+	if (!_peak_levels_block) {
+		_peak_levels_block.reset (new PeakData[peak_levels_block_size]);
+	}
+
+	if (write_peak_levels_header (0)) {
+		discard_peak_levels ();
+		return -1;
+	}
+
+	return 0;
+}
+
+/** Add peakfile peaks to the levels being written. Peaks have to be added
+ *  in order, otherwise the levels are given up on.
+ */
+void
+AudioSource::add_peak_levels (PeakData const* peaks, samplepos_t first_peak, samplecnt_t npeaks)
+{
+	if (-1 == _peak_levels_fd) {
+		return;
+	}
+
+	if (first_peak != _peak_levels_base) {
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Non-contiguous peaks for %1, dropping peak levels\n", _peakpath));
+		discard_peak_levels ();
+		return;
+	}
+
+	for (samplecnt_t n = 0; n < npeaks; ++n) {
+
+		PeakData const&   p = peaks[n];
+		samplecnt_t const b = _peak_levels_base & (peak_levels_block_size - 1);
+
+		for (uint32_t level = 1; level <= peak_levels; ++level) {
+			PeakData& e (_peak_levels_block[peak_level_offset (level) + (b >> level)]);
+			if ((b & ((1 << level) - 1)) == 0) {
+				e = p;
+			} else {
+				e.min = min (e.min, p.min);
+				e.max = max (e.max, p.max);
+			}
+		}
+
+		++_peak_levels_base;
+
+		if ((_peak_levels_base & (peak_levels_block_size - 1)) == 0) {
+			if (write_peak_levels_block ()) {
+				discard_peak_levels ();
+				return;
+			}
+			g_atomic_int_set (&_peak_levels_valid, (gint) _peak_levels_base);
+		}
+	}
+}
+
+/** Write the block containing the last added peak */
+int
+AudioSource::write_peak_levels_block ()
+{
+	assert (_peak_levels_base > 0);
+
+	off_t const byte = sizeof (PeakLevelsHeader) + ((_peak_levels_base - 1) >> peak_levels) * peak_levels_block_size * sizeof (PeakData);
+	ssize_t const bytes_to_write = peak_levels_block_size * sizeof (PeakData);
+
+	if (lseek (_peak_levels_fd, byte, SEEK_SET) != byte || ::write (_peak_levels_fd, _peak_levels_block.get(), bytes_to_write) != bytes_to_write) {
+		error << string_compose(_("%1: could not write peak levels (%2)"), _name, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+AudioSource::write_peak_levels_header (int64_t base_peaks)
+{
+	PeakLevelsHeader header;
+
+	memcpy (header.magic, peak_levels_magic, sizeof (header.magic));
+	header.version    = 1;
+	header.levels     = peak_levels;
+	header.base_peaks = base_peaks;
+
+	if (lseek (_peak_levels_fd, 0, SEEK_SET) != 0 || ::write (_peak_levels_fd, &header, sizeof (header)) != sizeof (header)) {
+		error << string_compose(_("%1: could not write peak levels (%2)"), _name, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	return 0;
+}
+
+/** Finish writing the levels file.
+ *  @param done true if all peaks of the source have been added.
+ */
+void
+AudioSource::finish_peak_levels (bool done)
+{
+	if (-1 == _peak_levels_fd) {
+		return;
+	}
+
+	if (done && _peak_levels_base > 0 && _peak_levels_base <= G_MAXINT) {
+		/* flush the trailing partial block, and only then mark the file
+		 * as complete.
+		 */
+		if (((_peak_levels_base & (peak_levels_block_size - 1)) == 0 || write_peak_levels_block () == 0)
+		    && write_peak_levels_header (_peak_levels_base) == 0) {
+			g_atomic_int_set (&_peak_levels_valid, (gint) _peak_levels_base);
+			g_atomic_int_set (&_peak_levels_complete, 1);
+		}
+	}
+
+	close (_peak_levels_fd);
+	_peak_levels_fd = -1;
+}
+
+void
+AudioSource::discard_peak_levels ()
+{
+	if (-1 != _peak_levels_fd) {
+		close (_peak_levels_fd);
+		_peak_levels_fd = -1;
+	}
+
+	g_atomic_int_set (&_peak_levels_valid, 0);
+	g_atomic_int_set (&_peak_levels_complete, 0);
+
+	::g_unlink (peak_levels_path ().c_str());
+}
+
+/** @return the coarsest level with no more samples per peak than requested,
+ *  if it covers the given range, or 0 to use the peakfile.
+ */
+uint32_t
+AudioSource::peak_level (samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const
+{
+	if (samples_per_visual_peak < 2 * _FPP || cnt <= 0) {
+		return 0;
+	}
+
+	uint32_t level = 0;
+
+	while (level < peak_levels && ((samplecnt_t) _FPP << (level + 1)) <= samples_per_visual_peak) {
+		++level;
+	}
+
+	/* levels use the same peak boundaries as the peakfile, so check
+	 * coverage in peakfile peaks.
+	 */
+	samplecnt_t valid = g_atomic_int_get (&_peak_levels_valid);
+
+	if (!g_atomic_int_get (&_peak_levels_complete)) {
+		/* only complete blocks have been written so far */
+		valid &= ~(peak_levels_block_size - 1);
+	} else {
+		/* the last peak of the level may cover less peakfile peaks */
+		valid = ((valid + (1 << level) - 1) >> level) << level;
+	}
+
+	samplepos_t const last_peak = (min (start + cnt, _length.samples()) - 1) / _FPP;
+
+	if (start >= _length.samples() || last_peak >= valid) {
+		return 0;
+	}
+
+	return level;
+}
+
+/** Read peaks from one of the peak levels.
+ *  @return 0 on success, otherwise the caller has to use the peakfile.
+ */
+int
+AudioSource::read_peak_level (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt,
+                              double samples_per_visual_peak, uint32_t level) const
+{
+	ReaderLock lm (_lock);
+
+	const samplecnt_t fpp = (samplecnt_t) _FPP << level;
+	const samplepos_t end = min (start + cnt, _length.samples());
+
+	if (end <= start) {
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("LEVEL %1 PEAKS: npeaks = %2 start = %3 cnt = %4 spp = %5\n", level, npeaks, start, cnt, samples_per_visual_peak));
+
+	ScopedFileDescriptor sfd (g_open (peak_levels_path ().c_str(), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		return -1;
+	}
+
+	/* read the stored peaks of this level, block by block */
+
+	const samplepos_t first_stored = start / fpp;
+	const samplecnt_t nstored      = (end - 1) / fpp - first_stored + 1;
+	const samplecnt_t per_block    = peak_levels_block_size >> level;
+
+	boost::scoped_array<PeakData> stored (new PeakData[nstored]);
+
+	for (samplecnt_t n = 0; n < nstored; ) {
+		samplepos_t const peak = first_stored + n;
+		samplecnt_t const run  = min (nstored - n, per_block - (peak & (per_block - 1)));
+		off_t const       byte = peak_level_byte (level, peak);
+		ssize_t const     len  = run * sizeof (PeakData);
+
+		if (lseek (sfd, byte, SEEK_SET) != byte || ::read (sfd, &stored[n], len) != len) {
+			DEBUG_TRACE (DEBUG::Peaks, string_compose ("Cannot read peak levels %1\n", peak_levels_path ()));
+			return -1;
+		}
+
+		n += run;
+	}
+
+	/* and reduce them to the visual peaks */
+
+	for (samplecnt_t n = 0; n < npeaks; ++n) {
+		samplepos_t const s0 = start + (samplepos_t) floor (n * samples_per_visual_peak);
+		samplepos_t const s1 = min (end, start + (samplepos_t) floor ((n + 1) * samples_per_visual_peak));
+
+		if (s0 >= s1) {
+			memset (&peaks[n], 0, sizeof (PeakData) * (npeaks - n));
+			break;
+		}
+
+		PeakData::PeakDatum xmax = -1.0;
+		PeakData::PeakDatum xmin = 1.0;
+
+		for (samplepos_t i = s0 / fpp; i <= (s1 - 1) / fpp; ++i) {
+			xmax = max (xmax, stored[i - first_stored].max);
+			xmin = min (xmin, stored[i - first_stored].min);
+		}
+
+		peaks[n].max = xmax;
+		peaks[n].min = xmin;
+	}
+
+	return 0;
+}
+
 samplecnt_t
 AudioSource::available_peaks (double zoom_factor) const
 {
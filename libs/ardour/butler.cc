@@ -20,6 +20,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -36,6 +37,7 @@
 
 #include "ardour/butler.h"
 #include "ardour/debug.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/disk_io.h"
 #include "ardour/disk_reader.h"
 #include "ardour/io.h"
@@ -58,8 +60,12 @@ Butler::Butler(Session& s)
 	, _midi_buffer_size(0)
 	, pool_trash(16)
 	, _xthread (true)
+	, _io_run_sem ("butler_io_run", 0)
+	, _io_done_sem ("butler_io_done", 0)
 {
 	g_atomic_int_set (&should_do_transport_work, 0);
+	g_atomic_int_set (&_refill_next, 0);
+	g_atomic_int_set (&_io_threads_active, 0);
 	SessionEvent::pool->set_trash (&pool_trash);
 
 	/* catch future changes to parameters */
@@ -143,6 +149,8 @@ Butler::start_thread()
 	//pthread_detach (thread);
 	have_thread = true;
 
+	start_io_threads ();
+
 	// we are ready to request buffer adjustments
 	_session.adjust_capture_buffering ();
 	_session.adjust_playback_buffering ();
@@ -159,6 +167,184 @@ Butler::terminate_thread ()
 		queue_request (Request::Quit);
 		pthread_join (thread, &status);
 	}
+	stop_io_threads ();
+}
+
+/** Start helper threads which refill track playback buffers in parallel
+ * with the butler thread. The butler itself is the first I/O thread.
+ */
+void
+Butler::start_io_threads ()
+{
+	stop_io_threads ();
+
+	uint32_t n_threads = Config->get_disk_io_threads ();
+
+	if (n_threads < 2) {
+		return;
+	}
+
+	g_atomic_int_set (&_io_threads_active, 1);
+
+	for (uint32_t i = 1; i < n_threads; ++i) {
+		pthread_t tid;
+		if (pthread_create_and_store (string_compose ("butler I/O %1", i), &tid, _io_thread_work, this)) {
+			warning << _("Session: could not create butler I/O thread, using fewer threads for disk I/O") << endmsg;
+			break;
+		}
+		_io_threads.push_back (tid);
+	}
+}
+
+void
+Butler::stop_io_threads ()
+{
+	g_atomic_int_set (&_io_threads_active, 0);
+
+	for (std::vector<pthread_t>::const_iterator i = _io_threads.begin (); i != _io_threads.end (); ++i) {
+		_io_run_sem.signal ();
+	}
+	for (std::vector<pthread_t>::const_iterator i = _io_threads.begin (); i != _io_threads.end (); ++i) {
+		pthread_join (*i, NULL);
+	}
+
+	_io_threads.clear ();
+	_io_run_sem.reset ();
+	_io_done_sem.reset ();
+}
+
+void*
+Butler::_io_thread_work (void* arg)
+{
+	SessionEvent::create_per_thread_pool ("butler I/O events", 64);
+	pthread_set_name (X_("butler I/O"));
+	((Butler*) arg)->io_thread_work ();
+	return 0;
+}
+
+void
+Butler::io_thread_work ()
+{
+	const samplecnt_t bufsize = DiskReader::working_buffer_size ();
+
+	Sample* sum_buffer     = new Sample[bufsize];
+	Sample* mixdown_buffer = new Sample[bufsize];
+	gain_t* gain_buffer    = new gain_t[bufsize];
+
+	while (true) {
+		_io_run_sem.wait ();
+
+		if (!g_atomic_int_get (&_io_threads_active)) {
+			break;
+		}
+
+		Temporal::TempoMap::fetch ();
+		run_refill_tasks (sum_buffer, mixdown_buffer, gain_buffer);
+
+		_io_done_sem.signal ();
+	}
+
+	delete [] sum_buffer;
+	delete [] mixdown_buffer;
+	delete [] gain_buffer;
+}
+
+/** Called concurrently by the butler and all I/O threads.
+ * Tracks are claimed in order of increasing playback buffer fill level.
+ */
+void
+Butler::run_refill_tasks (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer)
+{
+	const gint n_tasks = _refill_tasks.size ();
+
+	while (!transport_work_requested () && should_run) {
+		gint i = g_atomic_int_add (&_refill_next, 1);
+		if (i >= n_tasks) {
+			break;
+		}
+
+		RefillTask& task (_refill_tasks[i]);
+
+		if (sum_buffer) {
+			task.result = task.track->do_refill (sum_buffer, mixdown_buffer, gain_buffer);
+		} else {
+			/* butler thread uses DiskReader's static working buffers */
+			task.result = task.track->do_refill ();
+		}
+	}
+}
+
+/** Refill playback buffers of all active tracks, emptiest buffers first.
+ * @return true if there is more work to do
+ */
+bool
+Butler::refill_tracks (RouteList const& rl)
+{
+	bool disk_work_outstanding = false;
+
+	_refill_tasks.clear ();
+
+	for (RouteList::const_iterator i = rl.begin (); i != rl.end (); ++i) {
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+
+		if (!tr) {
+			continue;
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+
+		if (io && !io->active()) {
+			/* don't read inactive tracks */
+			continue;
+		}
+
+		_refill_tasks.push_back (RefillTask (tr, tr->playback_buffer_load ()));
+	}
+
+	std::stable_sort (_refill_tasks.begin (), _refill_tasks.end ());
+
+	g_atomic_int_set (&_refill_next, 0);
+
+	uint32_t nt = 0;
+	if (_refill_tasks.size () > 1) {
+		nt = std::min<uint32_t> (_io_threads.size (), _refill_tasks.size () - 1);
+	}
+
+	for (uint32_t i = 0; i < nt; ++i) {
+		_io_run_sem.signal ();
+	}
+
+	run_refill_tasks (0, 0, 0);
+
+	for (uint32_t i = 0; i < nt; ++i) {
+		_io_done_sem.wait ();
+	}
+
+	for (std::vector<RefillTask>::const_iterator i = _refill_tasks.begin (); i != _refill_tasks.end (); ++i) {
+		switch (i->result) {
+			case 0:
+				break;
+
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", i->track->name()));
+				disk_work_outstanding = true;
+				break;
+
+			case RefillTask::NotRun:
+				/* we didn't get to all the streams */
+				disk_work_outstanding = true;
+				break;
+
+			default:
+				error << string_compose(_("Butler read ahead failure on dstream %1"), i->track->name()) << endmsg;
+				std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), i->track->name()) << std::endl;
+				break;
+		}
+	}
+
+	_refill_tasks.clear ();
+
+	return disk_work_outstanding;
 }
 
 void *
@@ -175,7 +361,6 @@ Butler::thread_work ()
 	uint32_t err = 0;
 
 	bool disk_work_outstanding = false;
-	RouteList::iterator i;
 
 	while (true) {
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 butler main loop, disk work outstanding ? %2 @ %3\n", DEBUG_THREAD_SELF, disk_work_outstanding, g_get_monotonic_time()));
@@ -252,44 +437,7 @@ Butler::thread_work ()
 
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts refill loop, twr = %1\n", transport_work_requested()));
 
-		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
-
-			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
-
-			if (!tr) {
-				continue;
-			}
-
-			boost::shared_ptr<IO> io = tr->input ();
-
-			if (io && !io->active()) {
-				/* don't read inactive tracks */
-				// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
-				continue;
-			}
-			// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
-			switch (tr->do_refill ()) {
-			case 0:
-				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
-				break;
-
-			case 1:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
-				disk_work_outstanding = true;
-				break;
-
-			default:
-				error << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << endmsg;
-                                std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << std::endl;
-				break;
-			}
-
-		}
-
-		if (i != rl_with_auditioner.begin() && i != rl_with_auditioner.end()) {
-			/* we didn't get to all the streams */
-			disk_work_outstanding = true;
-		}
+		disk_work_outstanding = refill_tracks (rl_with_auditioner);
 
 		if (!err && transport_work_requested()) {
 			DEBUG_TRACE (DEBUG::Butler, "transport work requested during refill, back to restart\n");
@@ -27,6 +27,7 @@
 #include "pbd/enum_convert.h"
 
 #include "ardour/amp.h"
+#include "ardour/audio_buffer.h"
 #include "ardour/audioengine.h"
 #include "ardour/buffer_set.h"
 #include "ardour/debug.h"
@@ -267,10 +268,20 @@ Delivery::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample
 
 	tgain = target_gain ();
 
+	bool const use_panner = _panshell && !_panshell->bypassed() && _panshell->panner();
+	bool const quieten    = fabs (_session.transport_speed()) > 1.5 && Config->get_quieten_at_speed ();
+
+	/* If the buffers are not needed afterwards, apply the gain while
+	 * copying audio to the output ports, rather than modifying bufs first.
+	 */
+	bool const gain_on_copy = !result_required && !use_panner && !quieten && bufs.count().n_midi() == 0;
+
 	if (tgain != _current_gain) {
 		/* target gain has changed */
 
-		_current_gain = Amp::apply_gain (bufs, _session.nominal_sample_rate(), nframes, _current_gain, tgain);
+		if (!gain_on_copy) {
+			_current_gain = Amp::apply_gain (bufs, _session.nominal_sample_rate(), nframes, _current_gain, tgain);
+		}
 
 	} else if (tgain < GAIN_COEFF_SMALL) {
 
@@ -285,7 +296,7 @@ Delivery::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample
 		}
 		return;
 
-	} else if (tgain != GAIN_COEFF_UNITY) {
+	} else if (tgain != GAIN_COEFF_UNITY && !gain_on_copy) {
 
 		/* target gain has not changed, but is not unity */
 		Amp::apply_simple_gain (bufs, nframes, tgain);
@@ -293,13 +304,13 @@ Delivery::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample
 
 	// Speed quietning
 
-	if (fabs (_session.transport_speed()) > 1.5 && Config->get_quieten_at_speed ()) {
+	if (quieten) {
 		Amp::apply_simple_gain (bufs, nframes, speed_quietning, false);
 	}
 
 	// Panning
 
-	if (_panshell && !_panshell->bypassed() && _panshell->panner()) {
+	if (use_panner) {
 
 		// Use the panner to distribute audio to output port buffers
 
@@ -323,7 +334,11 @@ Delivery::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample
 		*/
 
 		if (bufs.count().n_audio() > 0) {
-			_output->copy_to_outputs (bufs, DataType::AUDIO, nframes, 0);
+			if (gain_on_copy) {
+				_current_gain = copy_audio_to_outputs (bufs, nframes, _current_gain, tgain);
+			} else {
+				_output->copy_to_outputs (bufs, DataType::AUDIO, nframes, 0);
+			}
 		}
 
 		for (DataType::iterator t = DataType::begin(); t != DataType::end(); ++t) {
@@ -355,6 +370,31 @@ Delivery::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample
 	}
 }
 
+/** Same as IO::copy_to_outputs() for audio, applying a (potentially)
+ * declicked gain in the same pass. Returns the gain to use next cycle.
+ */
+gain_t
+Delivery::copy_audio_to_outputs (BufferSet& bufs, pframes_t nframes, gain_t initial, gain_t target)
+{
+	PortSet&       ports (_output->ports());
+	uint32_t const n_bufs = bufs.count().n_audio();
+	uint32_t       n      = 0;
+	gain_t         rv     = initial;
+
+	assert (n_bufs > 0);
+
+	/* any extra outputs get the last buffer */
+	for (PortSet::iterator o = ports.begin (DataType::AUDIO); o != ports.end (DataType::AUDIO); ++o, ++n) {
+		AudioBuffer& port_buffer (static_cast<AudioBuffer&> (o->get_buffer (nframes)));
+		gain_t g = Amp::apply_gain (port_buffer, bufs.get_audio (std::min (n, n_bufs - 1)), _session.nominal_sample_rate(), nframes, initial, target);
+		if (n == 0) {
+			rv = g;
+		}
+	}
+
+	return rv;
+}
+
 XMLNode&
 Delivery::state () const
 {
@@ -69,6 +69,9 @@ DiskReader::DiskReader (Session& s, Track& t, string const& str,  Temporal::Time
 	file_sample[DataType::AUDIO] = 0;
 	file_sample[DataType::MIDI]  = 0;
 	g_atomic_int_set (&_pending_overwrite, 0);
+	g_atomic_int_set (&_reset_refill_stats, 0);
+	_refill_samples = 0;
+	_refill_usecs   = 0;
 }
 
 DiskReader::~DiskReader ()
@@ -130,9 +133,9 @@ DiskReader::allocate_working_buffers ()
 	   need to reflect the maximum size we could use, which is 4MB reads, or 2M samples
 	   using 16 bit samples.
 	*/
-	_sum_buffer     = new Sample[2 * 1048576];
-	_mixdown_buffer = new Sample[2 * 1048576];
-	_gain_buffer    = new gain_t[2 * 1048576];
+	_sum_buffer     = new Sample[working_buffer_size ()];
+	_mixdown_buffer = new Sample[working_buffer_size ()];
+	_gain_buffer    = new gain_t[working_buffer_size ()];
 }
 
 void
@@ -1100,6 +1103,75 @@ DiskReader::do_refill ()
 	return refill (_sum_buffer, _mixdown_buffer, _gain_buffer, 0, reversed);
 }
 
+int
+DiskReader::do_refill (Sample* sum_buffer, Sample* mixdown_buffer, gain_t* gain_buffer)
+{
+	const bool reversed = !_session.transport_will_roll_forwards ();
+	return refill (sum_buffer, mixdown_buffer, gain_buffer, 0, reversed);
+}
+
+bool
+DiskReader::refill_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev, double& samples_per_sec) const
+{
+	if (!_refill_timing.get_stats (min, max, avg, dev)) {
+		return false;
+	}
+	samples_per_sec = _refill_usecs > 0 ? 1e6 * _refill_samples / (double) _refill_usecs : 0;
+	return true;
+}
+
+void
+DiskReader::reset_refill_stats ()
+{
+	g_atomic_int_set (&_reset_refill_stats, 1);
+}
+
+/** Ask the playlist's sources to start reading the data for all channels
+ * that the following audio_read() calls will need, so that the reads for
+ * all channels (and regions) are queued with the OS at once rather than
+ * one blocking read at a time. Follows the loop handling of audio_read().
+ */
+void
+DiskReader::prefetch_audio (samplepos_t start, samplecnt_t cnt, uint32_t n_channels, bool reversed)
+{
+	boost::shared_ptr<AudioPlaylist> pl = audio_playlist ();
+	Location*                        loc = 0;
+	samplepos_t                      loop_start = 0;
+	samplepos_t                      loop_end   = 0;
+
+	if (!reversed) {
+		if ((loc = _loop_location) != 0) {
+			loop_start = loc->start_sample ();
+			loop_end   = loc->end_sample ();
+
+			const Temporal::Range loop_range (loc->start(), loc->end());
+			start = loop_range.squish (timepos_t (start)).samples();
+		}
+	} else {
+		start -= cnt;
+		start = max (samplepos_t (0), start);
+	}
+
+	while (cnt > 0) {
+		samplecnt_t this_read = cnt;
+
+		if (loc && (loop_end - start < cnt)) {
+			this_read = loop_end - start;
+		}
+
+		if (this_read <= 0) {
+			break;
+		}
+
+		for (uint32_t n = 0; n < n_channels; ++n) {
+			pl->prefetch (timepos_t (start), timecnt_t::from_samples (this_read), n);
+		}
+
+		cnt  -= this_read;
+		start = loc ? loop_start : start + this_read;
+	}
+}
+
 int
 DiskReader::do_refill_with_alloc (bool partial_fill, bool reversed)
 {
@@ -1275,6 +1347,18 @@ DiskReader::refill_audio (Sample* sum_buffer, Sample* mixdown_buffer, float* gai
 	int64_t elapsed;
 #endif
 
+	if (g_atomic_int_compare_and_exchange (&_reset_refill_stats, 1, 0)) {
+		_refill_timing.reset ();
+		_refill_samples = 0;
+		_refill_usecs   = 0;
+	}
+
+	_refill_timing.start ();
+
+	if (_playlists[DataType::AUDIO] && Config->get_disk_prefetch ()) {
+		prefetch_audio (fsa, min (total_space, samples_to_read), c->size (), reversed);
+	}
+
 	for (chan_n = 0, i = c->begin (); i != c->end (); ++i, ++chan_n) {
 		ChannelInfo* chan (*i);
 
@@ -1331,6 +1415,12 @@ DiskReader::refill_audio (Sample* sum_buffer, Sample* mixdown_buffer, float* gai
 	file_sample[DataType::AUDIO] = file_sample_tmp;
 	assert (file_sample[DataType::AUDIO] >= 0);
 
+	_refill_timing.update ();
+	_refill_samples += (uint64_t) c->size () * min (total_space, samples_to_read);
+	_refill_usecs   += _refill_timing.elapsed ();
+
+	DEBUG_TRACE (DEBUG::DiskIO, string_compose ("%1: refill of %2 samples took %3 usec\n", name (), min (total_space, samples_to_read), _refill_timing.elapsed ()));
+
 	ret = ((total_space - samples_to_read) > _chunk_samples);
 
 out:
@@ -37,6 +37,7 @@
 #include "pbd/strsplit.h"
 #include "pbd/shortpath.h"
 #include "pbd/enumwriter.h"
+#include "pbd/failed_constructor.h"
 #include "pbd/file_utils.h"
 
 #include <glibmm/miscutils.h>
@@ -231,6 +232,8 @@ FileSource::move_to_trash (const string& trash_dir_name)
  * If the source is external, \a path should be a full path.
  * In either case, found_path is set to the complete absolute path of the source file.
  * \return true if the file was found.
+ * Throws failed_constructor if the user would have to pick one of several
+ * matches while Session::loading_sources_concurrently().
  */
 bool
 FileSource::find (Session& s, DataType type, const string& path, bool must_exist,
@@ -292,6 +295,13 @@ FileSource::find (Session& s, DataType type, const string& path, bool must_exist
 
 			/* more than one match: ask the user */
 
+			if (s.loading_sources_concurrently ()) {
+				/* not from a worker thread; the source is
+				 * created again once all workers are done.
+				 */
+				throw failed_constructor ();
+			}
+
                         int which = FileSource::AmbiguousFileName (path, de_duped_hits).value_or (-1);
 
                         if (which < 0) {
@@ -29,6 +29,8 @@ const char* const template_suffix = X_(".template");
 const char* const statefile_suffix = X_(".ardour");
 const char* const pending_suffix = X_(".pending");
 const char* const peakfile_suffix = X_(".peak");
+const char* const peak_levels_suffix = X_(".levels");
+const char* const midi_index_suffix = X_(".midx");
 const char* const backup_suffix = X_(".bak");
 const char* const temp_suffix = X_(".tmp");
 const char* const history_suffix = X_(".history");
@@ -105,8 +105,10 @@
 #include "ardour/clip_library.h"
 #include "ardour/control_protocol_manager.h"
 #include "ardour/directory_names.h"
+#include "ardour/disk_reader.h"
 #include "ardour/event_type_map.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/graph.h"
 #include "ardour/midi_patch_manager.h"
 #include "ardour/midi_region.h"
 #include "ardour/midi_ui.h"
@@ -124,6 +126,7 @@
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
 #include "ardour/session_event.h"
+#include "ardour/track.h"
 #include "ardour/source_factory.h"
 #include "ardour/transport_fsm.h"
 #include "ardour/transport_master_manager.h"
@@ -154,6 +157,8 @@ apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer  = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain   = 0;
 copy_vector_t           ARDOUR::copy_vector           = 0;
+apply_gain_ramp_t       ARDOUR::apply_gain_ramp       = 0;
+reduce_peaks_t          ARDOUR::reduce_peaks          = 0;
 
 PBD::Signal1<void, std::string>                    ARDOUR::BootMessage;
 PBD::Signal3<void, std::string, std::string, bool> ARDOUR::PluginScanMessage;
@@ -193,6 +198,24 @@ setup_hardware_optimization (bool try_optimization)
 #if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
 		/* We have AVX-optimized code for Windows and Linux */
 
+#ifdef FPU_AVX512F_SUPPORT
+		if (fpu->has_avx512f ()) {
+			info << "Using AVX-512 optimized routines" << endmsg;
+
+			// AVX-512F SET
+			compute_peak          = x86_avx512f_compute_peak;
+			find_peaks            = x86_avx512f_find_peaks;
+			apply_gain_to_buffer  = x86_avx512f_apply_gain_to_buffer;
+			mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
+			mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
+			copy_vector           = x86_avx512f_copy_vector;
+			apply_gain_ramp       = x86_avx512f_apply_gain_ramp;
+			reduce_peaks          = x86_avx512f_reduce_peaks;
+
+			generic_mix_functions = false;
+
+		} else
+#endif
 #ifdef FPU_AVX_FMA_SUPPORT
 		if (fpu->has_fma ()) {
 			info << "Using AVX and FMA optimized routines" << endmsg;
@@ -204,6 +227,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_fma_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
+			apply_gain_ramp       = x86_sse_apply_gain_ramp;
+			reduce_peaks          = x86_sse_avx_reduce_peaks;
 
 			generic_mix_functions = false;
 
@@ -219,6 +244,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
+			apply_gain_ramp       = x86_sse_apply_gain_ramp;
+			reduce_peaks          = x86_sse_avx_reduce_peaks;
 
 			generic_mix_functions = false;
 
@@ -232,6 +259,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
+			apply_gain_ramp       = x86_sse_apply_gain_ramp;
+			reduce_peaks          = x86_sse_reduce_peaks;
 
 			generic_mix_functions = false;
 		}
@@ -247,6 +276,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = arm_neon_mix_buffers_with_gain;
 			mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 			copy_vector           = arm_neon_copy_vector;
+			apply_gain_ramp       = arm_neon_apply_gain_ramp;
+			reduce_peaks          = arm_neon_reduce_peaks;
 
 			generic_mix_functions = false;
 		}
@@ -260,6 +291,8 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = veclib_mix_buffers_with_gain;
 			mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
+			apply_gain_ramp       = default_apply_gain_ramp;
+			reduce_peaks          = default_reduce_peaks;
 
 			generic_mix_functions = false;
 
@@ -279,6 +312,8 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_with_gain = default_mix_buffers_with_gain;
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
+		apply_gain_ramp       = default_apply_gain_ramp;
+		reduce_peaks          = default_reduce_peaks;
 
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
@@ -961,6 +996,16 @@ ARDOUR::reset_performance_meters (Session *session)
 		for (size_t n = 0; n < Session::NTT; ++n) {
 			session->dsp_stats[n].queue_reset ();
 		}
+		if (session->process_graph ()) {
+			session->process_graph ()->reset_stats ();
+		}
+		boost::shared_ptr<RouteList> rl = session->get_routes ();
+		for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+			if (tr && tr->disk_reader ()) {
+				tr->disk_reader ()->reset_refill_stats ();
+			}
+		}
 	}
 	for (size_t n = 0; n < AudioEngine::NTT; ++n) {
 		AudioEngine::instance()->dsp_stats[n].queue_reset ();
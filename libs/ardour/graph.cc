@@ -20,6 +20,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <stdio.h>
 
@@ -34,6 +35,7 @@
 #include "ardour/debug.h"
 #include "ardour/graph.h"
 #include "ardour/process_thread.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/route.h"
 #include "ardour/session.h"
 #include "ardour/types.h"
@@ -59,12 +61,29 @@ alloc_allowed ()
 
 #define g_atomic_uint_get(x) static_cast<guint> (g_atomic_int_get (x))
 
+/* index of the current process-thread in Graph::_workers,
+ * 0: main graph thread, 1..N: helper threads, -1: not a graph thread
+ */
+static thread_local int graph_thread_id = -1;
+
+void
+Graph::SchedulerStats::reset ()
+{
+	nodes_run     = 0;
+	local_pops    = 0;
+	shared_pops   = 0;
+	steals        = 0;
+	failed_steals = 0;
+	sleeps        = 0;
+}
+
 Graph::Graph (Session& session)
 	: SessionHandleRef (session)
 	, _execution_sem ("graph_execution", 0)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
 	, _graph_empty (true)
+	, _cycles_since_cost_check (0)
 	, _current_chain (0)
 	, _pending_chain (0)
 	, _setup_chain (1)
@@ -74,6 +93,7 @@ Graph::Graph (Session& session)
 	g_atomic_int_set (&_n_workers, 0);
 	g_atomic_int_set (&_idle_thread_cnt, 0);
 	g_atomic_int_set (&_trigger_queue_size, 0);
+	g_atomic_int_set (&_work_stealing, 0);
 
 	_n_terminal_nodes[0] = 0;
 	_n_terminal_nodes[1] = 0;
@@ -93,6 +113,13 @@ Graph::Graph (Session& session)
 #endif
 }
 
+Graph::~Graph ()
+{
+	for (std::vector<WorkerState*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		delete *i;
+	}
+}
+
 void
 Graph::engine_stopped ()
 {
@@ -128,6 +155,21 @@ Graph::reset_thread_list ()
 		drop_threads ();
 	}
 
+	/* one work-stealing deque per process thread, large enough for all nodes */
+	{
+		Glib::Threads::Mutex::Lock ls (_swap_mutex);
+		size_t n_nodes = std::max (_nodes_rt[0].size (), _nodes_rt[1].size ());
+		while (_workers.size () < num_threads) {
+			_workers.push_back (new WorkerState);
+		}
+		for (std::vector<WorkerState*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+			(*i)->deque.reserve (n_nodes);
+			(*i)->deque.clear ();
+			(*i)->initial.reserve (n_nodes);
+			(*i)->initial.clear ();
+		}
+	}
+
 	/* Allow threads to run */
 	g_atomic_int_set (&_terminate, 0);
 
@@ -158,6 +200,10 @@ Graph::session_going_away ()
 	_init_trigger_list[1].clear ();
 	g_atomic_int_set (&_trigger_queue_size, 0);
 	_trigger_queue.clear ();
+	for (std::vector<WorkerState*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		(*i)->deque.clear ();
+		(*i)->initial.clear ();
+	}
 }
 
 void
@@ -213,6 +259,7 @@ Graph::clear_other_chain ()
 		if (_setup_chain != _pending_chain) {
 			for (node_list_t::iterator ni = _nodes_rt[_setup_chain].begin (); ni != _nodes_rt[_setup_chain].end (); ++ni) {
 				(*ni)->_activation_set[_setup_chain].clear ();
+				(*ni)->_activation_order[_setup_chain].clear ();
 			}
 
 			_nodes_rt[_setup_chain].clear ();
@@ -243,6 +290,12 @@ Graph::swap_process_chain ()
 			_trigger_queue.clear ();
 			/* ensure that all nodes can be queued */
 			_trigger_queue.reserve (_nodes_rt[_current_chain].size ());
+			for (std::vector<WorkerState*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+				(*i)->deque.clear ();
+				(*i)->deque.reserve (_nodes_rt[_current_chain].size ());
+				(*i)->initial.clear ();
+				(*i)->initial.reserve (_nodes_rt[_current_chain].size ());
+			}
 			g_atomic_int_set (&_trigger_queue_size, 0);
 			_cleanup_cond.signal ();
 		}
@@ -262,16 +315,39 @@ Graph::prep ()
 			_current_chain = _pending_chain;
 			/* ensure that all nodes can be queued */
 			_trigger_queue.reserve (_nodes_rt[_current_chain].size ());
+			for (std::vector<WorkerState*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+				(*i)->deque.reserve (_nodes_rt[_current_chain].size ());
+				(*i)->initial.reserve (_nodes_rt[_current_chain].size ());
+			}
 			assert (g_atomic_uint_get (&_trigger_queue_size) == 0);
 			_cleanup_cond.signal ();
 		}
 		_swap_mutex.unlock ();
 	}
 
+	/* No node of the previous cycle is queued or running any more, but
+	 * threads woken late may still be looking for work. Either scheduler
+	 * finds nothing in that case, so it is safe to switch here, once per
+	 * cycle.
+	 */
+	const bool work_stealing = Config->get_graph_work_stealing ();
+	g_atomic_int_set (&_work_stealing, work_stealing ? 1 : 0);
+
 	_graph_empty = true;
 
 	int chain = _current_chain;
 
+	/* Nodes have cost 1 until they were run, so the order computed
+	 * when the graph was rechained does not yet reflect their actual
+	 * processing time. Re-sort when measured costs change.
+	 */
+	if (++_cycles_since_cost_check >= 1024) {
+		_cycles_since_cost_check = 0;
+		if (node_costs_drifted (chain)) {
+			order_by_critical_path (chain);
+		}
+	}
+
 	node_list_t::iterator i;
 	for (i = _nodes_rt[chain].begin (); i != _nodes_rt[chain].end (); ++i) {
 		(*i)->prep (chain);
@@ -284,9 +360,29 @@ Graph::prep ()
 	g_atomic_int_set (&_terminal_refcnt, _n_terminal_nodes[chain]);
 
 	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
+	if (!work_stealing) {
+		for (i = _init_trigger_list[chain].begin (); i != _init_trigger_list[chain].end (); i++) {
+			g_atomic_int_inc (&_trigger_queue_size);
+			_trigger_queue.push_back (i->get ());
+		}
+		return;
+	}
+
+	/* Spread the initial nodes round-robin across all process threads,
+	 * in order of decreasing critical path. These are MPMC queues rather
+	 * than the owner-only deques: a thread woken up late during the
+	 * previous cycle may already be looking for work.
+	 */
+	guint const n_threads = std::min<size_t> (g_atomic_uint_get (&_n_workers) + 1, _workers.size ());
+	guint       t         = 0;
 	for (i = _init_trigger_list[chain].begin (); i != _init_trigger_list[chain].end (); i++) {
 		g_atomic_int_inc (&_trigger_queue_size);
-		_trigger_queue.push_back (i->get ());
+		if (!_workers[t]->initial.push_back (i->get ())) {
+			_trigger_queue.push_back (i->get ());
+		}
+		if (++t == n_threads) {
+			t = 0;
+		}
 	}
 }
 
@@ -294,6 +390,13 @@ void
 Graph::trigger (GraphNode* n)
 {
 	g_atomic_int_inc (&_trigger_queue_size);
+	if (graph_thread_id >= 0 && g_atomic_int_get (&_work_stealing)) {
+		/* keep downstream nodes on the thread that just produced their input */
+		if (_workers[graph_thread_id]->deque.push (n)) {
+			return;
+		}
+		/* deque is full, fall back to the shared queue */
+	}
 	_trigger_queue.push_back (n);
 }
 
@@ -376,6 +479,7 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 	for (RouteList::iterator ri = routelist->begin (); ri != routelist->end (); ri++) {
 		(*ri)->_init_refcount[chain] = 0;
 		(*ri)->_activation_set[chain].clear ();
+		(*ri)->_activation_order[chain].clear ();
 		_nodes_rt[chain].push_back (*ri);
 	}
 
@@ -416,10 +520,129 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const& edges)
 		}
 	}
 
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
+		std::vector<GraphNode*>& order ((*ni)->_activation_order[chain]);
+		order.clear ();
+		for (node_set_t::iterator ai = (*ni)->_activation_set[chain].begin (); ai != (*ni)->_activation_set[chain].end (); ai++) {
+			order.push_back (ai->get ());
+		}
+	}
+
+	order_by_critical_path (chain);
+
 	_pending_chain = chain;
 	dump (chain);
 }
 
+bool
+Graph::CriticalPathCmp::operator() (GraphNode const* a, GraphNode const* b) const
+{
+	return a->_critical_path[chain] > b->_critical_path[chain];
+}
+
+/** Prioritize nodes by the estimated processing time of the longest
+ * path from the node to the output end. Nodes that start long chains
+ * are queued first, so that they do not become the bottleneck at the
+ * end of a cycle.
+ *
+ * This does not allocate memory, prep() calls it when the measured
+ * processing times no longer match the ones the order is based on.
+ */
+void
+Graph::order_by_critical_path (int chain)
+{
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
+		(*ni)->_critical_path[chain] = 0;
+	}
+
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
+		update_critical_path (ni->get (), chain);
+	}
+
+	for (node_list_t::iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
+		std::vector<GraphNode*>& order ((*ni)->_activation_order[chain]);
+		std::sort (order.begin (), order.end (), CriticalPathCmp (chain));
+	}
+
+	_init_trigger_list[chain].sort (CriticalPathCmp (chain));
+}
+
+/** Like critical_path(), memoized in GraphNode::_critical_path. */
+PBD::microseconds_t
+Graph::update_critical_path (GraphNode* n, int chain)
+{
+	if (n->_critical_path[chain] > 0) {
+		return n->_critical_path[chain];
+	}
+
+	PBD::microseconds_t downstream = 0;
+	for (node_set_t::const_iterator ai = n->_activation_set[chain].begin (); ai != n->_activation_set[chain].end (); ++ai) {
+		downstream = std::max (downstream, update_critical_path (ai->get (), chain));
+	}
+
+	n->_scheduled_cost[chain] = n->estimated_cost ();
+	n->_critical_path[chain]  = n->_scheduled_cost[chain] + downstream;
+	return n->_critical_path[chain];
+}
+
+/** @return true if the processing time of a node changed significantly
+ * since order_by_critical_path() was last called for the given chain.
+ */
+bool
+Graph::node_costs_drifted (int chain) const
+{
+	for (node_list_t::const_iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
+		const PBD::microseconds_t scheduled = (*ni)->_scheduled_cost[chain];
+		const PBD::microseconds_t diff      = std::abs ((*ni)->estimated_cost () - scheduled);
+		/* ignore jitter: at least 25% and 5 usec */
+		if (diff > 5 && diff * 4 > scheduled) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Return the estimated time to process the given node and the most
+ * expensive chain of nodes that depend on it.
+ *
+ * The graph is guaranteed to be acyclic, results are memoized in @param cost
+ */
+PBD::microseconds_t
+Graph::critical_path (GraphNode const* n, int chain, CostMap& cost) const
+{
+	CostMap::const_iterator c = cost.find (n);
+	if (c != cost.end ()) {
+		return c->second;
+	}
+
+	PBD::microseconds_t downstream = 0;
+	for (node_set_t::const_iterator ai = n->_activation_set[chain].begin (); ai != n->_activation_set[chain].end (); ++ai) {
+		downstream = std::max (downstream, critical_path (ai->get (), chain, cost));
+	}
+
+	PBD::microseconds_t rv = n->estimated_cost () + downstream;
+	cost[n] = rv;
+	return rv;
+}
+
+bool
+Graph::critical_path (PBD::microseconds_t& path, PBD::microseconds_t& total) const
+{
+	Glib::Threads::Mutex::Lock ls (_swap_mutex);
+	int chain = _current_chain;
+
+	CostMap cost;
+	path  = 0;
+	total = 0;
+
+	for (node_list_t::const_iterator ni = _nodes_rt[chain].begin (); ni != _nodes_rt[chain].end (); ni++) {
+		path = std::max (path, critical_path (ni->get (), chain, cost));
+		total += (*ni)->estimated_cost ();
+	}
+
+	return !_nodes_rt[chain].empty ();
+}
+
 /** Called by both the main thread and all helpers. */
 void
 Graph::run_one ()
@@ -430,7 +653,15 @@ Graph::run_one ()
 		return;
 	}
 
-	if (_trigger_queue.pop_front (to_run)) {
+	if (graph_thread_id >= 0) {
+		/* statistics are only ever written by the thread they belong to */
+		WorkerState* ws = _workers[graph_thread_id];
+		if (g_atomic_int_compare_and_exchange (&ws->reset_stats, 1, 0)) {
+			ws->stats.reset ();
+		}
+	}
+
+	if (pop_node (to_run)) {
 		/* Wake up idle threads, but at most as many as there's
 		 * work in the trigger queue that can be processed by
 		 * other threads.
@@ -448,6 +679,9 @@ Graph::run_one ()
 
 	while (!to_run) {
 		/* Wait for work, fall asleep */
+		if (graph_thread_id >= 0) {
+			++_workers[graph_thread_id]->stats.sleeps;
+		}
 		g_atomic_int_inc (&_idle_thread_cnt);
 		assert (g_atomic_uint_get (&_idle_thread_cnt) <= g_atomic_uint_get (&_n_workers));
 
@@ -467,21 +701,72 @@ Graph::run_one ()
 		g_atomic_int_dec_and_test (&_idle_thread_cnt);
 
 		/* Try to find some work to do */
-		_trigger_queue.pop_front (to_run);
+		pop_node (to_run);
 	}
 
 	/* Process the graph-node */
 	g_atomic_int_dec_and_test (&_trigger_queue_size);
+	if (graph_thread_id >= 0) {
+		++_workers[graph_thread_id]->stats.nodes_run;
+	}
 	to_run->run (_current_chain);
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name ()));
 }
 
+/** Find a node that is ready to run.
+ *
+ * The classic scheduler uses a single shared trigger queue. With
+ * work-stealing enabled a thread first takes the most recently
+ * triggered node from its own deque (data produced by the upstream
+ * node is still hot in this CPU's cache), then the initial nodes
+ * assigned to it, then nodes from the shared queue (overflow), then
+ * initial nodes assigned to other threads, and finally the oldest node
+ * queued by any other thread.
+ */
+bool
+Graph::pop_node (GraphNode*& n)
+{
+	if (graph_thread_id < 0 || !g_atomic_int_get (&_work_stealing)) {
+		return _trigger_queue.pop_front (n);
+	}
+
+	WorkerState* ws = _workers[graph_thread_id];
+
+	if (ws->deque.pop (n)) {
+		++ws->stats.local_pops;
+		return true;
+	}
+
+	if (ws->initial.pop_front (n) || _trigger_queue.pop_front (n)) {
+		++ws->stats.shared_pops;
+		return true;
+	}
+
+	guint const n_threads = std::min<size_t> (g_atomic_uint_get (&_n_workers) + 1, _workers.size ());
+	for (guint i = 1; i < n_threads; ++i) {
+		if (_workers[(graph_thread_id + i) % n_threads]->initial.pop_front (n)) {
+			++ws->stats.steals;
+			return true;
+		}
+	}
+	for (guint i = 1; i < n_threads; ++i) {
+		if (_workers[(graph_thread_id + i) % n_threads]->deque.steal (n)) {
+			++ws->stats.steals;
+			return true;
+		}
+	}
+
+	++ws->stats.failed_steals;
+	return false;
+}
+
 void
 Graph::helper_thread ()
 {
-	g_atomic_int_inc (&_n_workers);
-	guint id = g_atomic_uint_get (&_n_workers);
+	guint id = g_atomic_int_add (&_n_workers, 1) + 1;
+
+	graph_thread_id = id < _workers.size () ? id : -1;
 
 	/* This is needed for ARDOUR::Session requests called from rt-processors
 	 * in particular Lua scripts may do cross-thread calls */
@@ -516,6 +801,8 @@ Graph::main_thread ()
 {
 	/* first time setup */
 
+	graph_thread_id = 0;
+
 	suspend_rt_malloc_checks ();
 	ProcessThread* pt = new ProcessThread ();
 
@@ -659,8 +946,11 @@ Graph::process_routes (pframes_t nframes, samplepos_t start_sample, samplepos_t
 	_process_need_butler = false;
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for non-silent process\n");
-	_callback_start_sem.signal ();
-	_callback_done_sem.wait ();
+	{
+		TimerRAII tr (_process_stats);
+		_callback_start_sem.signal ();
+		_callback_done_sem.wait ();
+	}
 	DEBUG_TRACE (DEBUG::ProcessThreads, "graph execution complete\n");
 
 	need_butler = _process_need_butler;
@@ -687,8 +977,11 @@ Graph::routes_no_roll (pframes_t nframes, samplepos_t start_sample, samplepos_t
 	_process_need_butler = false;
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for no-roll process\n");
-	_callback_start_sem.signal ();
-	_callback_done_sem.wait ();
+	{
+		TimerRAII tr (_process_stats);
+		_callback_start_sem.signal ();
+		_callback_done_sem.wait ();
+	}
 	DEBUG_TRACE (DEBUG::ProcessThreads, "graph execution complete\n");
 
 	return _process_retval;
@@ -718,6 +1011,32 @@ Graph::process_one_route (Route* route)
 	}
 }
 
+void
+Graph::get_stats (std::vector<SchedulerStats>& stats, PBD::TimingStats& process_stats) const
+{
+	/* not RT-safe, values of running threads may be slightly out of date */
+	stats.clear ();
+	for (std::vector<WorkerState*>::const_iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		stats.push_back ((*i)->stats);
+	}
+	process_stats = _process_stats;
+}
+
+void
+Graph::reset_stats ()
+{
+	/* each thread resets its own statistics, see run_one() */
+	for (std::vector<WorkerState*>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		g_atomic_int_set (&(*i)->reset_stats, 1);
+	}
+	_process_stats.queue_reset ();
+
+	Glib::Threads::Mutex::Lock ls (_swap_mutex);
+	for (node_list_t::iterator ni = _nodes_rt[_current_chain].begin (); ni != _nodes_rt[_current_chain].end (); ni++) {
+		(*ni)->reset_timing ();
+	}
+}
+
 bool
 Graph::in_process_thread () const
 {
@@ -18,6 +18,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+
 #include "ardour/graph.h"
 #include "ardour/graphnode.h"
 #include "ardour/route.h"
@@ -28,6 +30,9 @@ GraphNode::GraphNode (boost::shared_ptr<Graph> graph)
 	: _graph (graph)
 {
 	g_atomic_int_set (&_refcount, 0);
+	_init_refcount[0] = _init_refcount[1] = 0;
+	_critical_path[0] = _critical_path[1] = 0;
+	_scheduled_cost[0] = _scheduled_cost[1] = 0;
 }
 
 GraphNode::~GraphNode ()
@@ -59,22 +64,46 @@ GraphNode::trigger ()
 void
 GraphNode::finish (int chain)
 {
-	node_set_t::iterator i;
-	bool                 feeds = false;
+	std::vector<GraphNode*> const& order (_activation_order[chain]);
 
-	/* Notify downstream nodes that depend on this node */
-	for (i = _activation_set[chain].begin (); i != _activation_set[chain].end (); ++i) {
-		(*i)->trigger ();
-		feeds = true;
+	/* Notify downstream nodes that depend on this node.
+	 * Nodes with the longest remaining path are queued to run first:
+	 * the shared trigger-queue is FIFO, a worker's own deque is LIFO.
+	 */
+	if (_graph->work_stealing ()) {
+		for (std::vector<GraphNode*>::const_reverse_iterator i = order.rbegin (); i != order.rend (); ++i) {
+			(*i)->trigger ();
+		}
+	} else {
+		for (std::vector<GraphNode*>::const_iterator i = order.begin (); i != order.end (); ++i) {
+			(*i)->trigger ();
+		}
 	}
 
-	if (!feeds) {
+	if (order.empty ()) {
 		/* This node is a terminal node that does not feed another note,
 		 * so notify the graph to decrement the the finished count */
 		_graph->reached_terminal_node ();
 	}
 }
 
+PBD::microseconds_t
+GraphNode::estimated_cost () const
+{
+	PBD::microseconds_t min, max;
+	double avg, dev;
+	if (_timing.get_stats (min, max, avg, dev)) {
+		return std::max<PBD::microseconds_t> (1, avg);
+	}
+	return 1;
+}
+
+void
+GraphNode::reset_timing ()
+{
+	_timing.queue_reset ();
+}
+
 void
 GraphNode::process ()
 {
@@ -216,6 +216,14 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 		return;
 	}
 
+	/* main gain control: * mute & bypass/enable */
+	gain_t tgain = target_gain ();
+
+	/* without a panner, the gain is applied while copying the input,
+	 * unless we're going to stay silent or MIDI velocities need scaling.
+	 */
+	bool gain_applied = false;
+
 	/* we have to copy the input, because we may alter the buffers with the amp
 	 * in-place, which a send must never do.
 	 */
@@ -290,24 +298,37 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 		/* BufferSet::read_from() changes the channel-conut,
 		 * so we manually copy bufs -> mixbufs
 		 */
+		gain_applied = mixbufs.count ().n_midi () == 0 && !(tgain == GAIN_COEFF_ZERO && _current_gain == GAIN_COEFF_ZERO);
+		gain_t rv    = tgain;
+
 		for (DataType::iterator t = DataType::begin(); t != DataType::end(); ++t) {
 			/* iterate over outputs */
 			BufferSet::iterator i = bufs.begin (*t);
-			for (BufferSet::iterator o = mixbufs.begin (*t); o != mixbufs.end (*t); ++o) {
+			uint32_t            n = 0;
+			for (BufferSet::iterator o = mixbufs.begin (*t); o != mixbufs.end (*t); ++o, ++n) {
 				if (i == bufs.end (*t)) {
 					o->silence (nframes, 0);
+				} else if (*t == DataType::AUDIO && gain_applied) {
+					gain_t g = Amp::apply_gain (mixbufs.get_audio (n), bufs.get_audio (n), _session.nominal_sample_rate (), nframes, _current_gain, tgain);
+					if (n == 0) {
+						rv = g;
+					}
+					++i;
 				} else {
 					o->read_from (*i, nframes);
 					++i;
 				}
 			}
 		}
-	}
 
-	/* main gain control: * mute & bypass/enable */
-	gain_t tgain = target_gain ();
+		if (gain_applied) {
+			_current_gain = rv;
+		}
+	}
 
-	if (tgain != _current_gain) {
+	if (gain_applied) {
+		/* gain was applied while copying the input */
+	} else if (tgain != _current_gain) {
 		/* target gain has changed, fade in/out */
 		_current_gain = Amp::apply_gain (mixbufs, _session.nominal_sample_rate (), nframes, _current_gain, tgain);
 	} else if (tgain == GAIN_COEFF_ZERO) {
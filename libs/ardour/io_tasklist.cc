@@ -0,0 +1,152 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include "pbd/compose.h"
+#include "pbd/cpus.h"
+#include "pbd/error.h"
+#include "pbd/pthread_utils.h"
+
+#include "temporal/tempo.h"
+
+#include "ardour/io_tasklist.h"
+#include "ardour/session_event.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+
+IOTaskList::IOTaskList (uint32_t n_threads)
+	: _task_run_sem ("io_task_run", 0)
+	, _task_end_sem ("io_task_done", 0)
+{
+	g_atomic_int_set (&_threads_active, 0);
+	g_atomic_int_set (&_next_task, 0);
+
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+
+	if (n_threads < 2) {
+		return;
+	}
+
+	g_atomic_int_set (&_threads_active, 1);
+
+	for (uint32_t i = 1; i < n_threads; ++i) {
+		pthread_t thread_id;
+		if (pthread_create_and_store (string_compose ("IOTaskList %1", i), &thread_id, _thread_run, this)) {
+			PBD::warning << _("IOTaskList: could not create worker thread, using fewer threads") << endmsg;
+			break;
+		}
+		_threads.push_back (thread_id);
+	}
+}
+
+IOTaskList::~IOTaskList ()
+{
+	g_atomic_int_set (&_threads_active, 0);
+
+	for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+		_task_run_sem.signal ();
+	}
+	for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+		pthread_join (*i, NULL);
+	}
+}
+
+/*static*/ void*
+IOTaskList::_thread_run (void *arg)
+{
+	IOTaskList *d = static_cast<IOTaskList *>(arg);
+
+	/* tasks may queue session events, or emit signals handled in other threads */
+	SessionEvent::create_per_thread_pool (X_("IOTaskList"), 512);
+	PBD::notify_event_loops_about_thread_creation (pthread_self (), X_("IOTaskList"), 512);
+
+	d->run ();
+	return 0;
+}
+
+void
+IOTaskList::run ()
+{
+	while (true) {
+		_task_run_sem.wait ();
+
+		if (0 == g_atomic_int_get (&_threads_active)) {
+			break;
+		}
+
+		Temporal::TempoMap::fetch ();
+		run_tasks ();
+
+		_task_end_sem.signal ();
+	}
+}
+
+/** Claim and run tasks until all have been claimed.
+ * Called concurrently by all worker threads and the thread calling process().
+ */
+void
+IOTaskList::run_tasks ()
+{
+	const gint n_tasks = _tasks.size ();
+	while (true) {
+		gint i = g_atomic_int_add (&_next_task, 1);
+		if (i >= n_tasks) {
+			break;
+		}
+		_tasks[i] ();
+	}
+}
+
+void
+IOTaskList::push_back (boost::function<void ()> fn)
+{
+	_tasks.push_back (fn);
+}
+
+void
+IOTaskList::process ()
+{
+	const uint32_t n_tasks = _tasks.size ();
+
+	if (_threads.size () == 0 || n_tasks < 2) {
+		for (uint32_t i = 0; i < n_tasks; ++i) {
+			_tasks[i] ();
+		}
+	} else {
+		/* wake up worker threads, and help out */
+		uint32_t nt = std::min<uint32_t> (_threads.size (), n_tasks - 1);
+
+		g_atomic_int_set (&_next_task, 0);
+
+		for (uint32_t i = 0; i < nt; ++i) {
+			_task_run_sem.signal ();
+		}
+
+		run_tasks ();
+
+		for (uint32_t i = 0; i < nt; ++i) {
+			_task_end_sem.wait ();
+		}
+	}
+
+	g_atomic_int_set (&_next_task, 0);
+	_tasks.clear ();
+}
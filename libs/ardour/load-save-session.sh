@@ -8,6 +8,10 @@
 # changes in the Session file resulting from the save if for instance the
 # session is contained in a git repository.
 #
+# It also compares writing and reading the saved state as XML and in the
+# binary format. With --binary the session itself is saved in the binary
+# format.
+#
 
 TOP=`dirname "$0"`/../..
 . $TOP/build/gtk2_ardour/ardev_common_waf.sh
@@ -25,24 +29,30 @@ if [ "$1" == "--debug" -o "$1" == "--valgrind" -o "$1" == "--massif" ]; then
 	shift 1
 fi
 
+BINARY=""
+if [ "$1" == "--binary" ]; then
+	BINARY=$1
+	shift 1
+fi
+
 DIR_PATH=$1
 if [ "$DIR_PATH" == "" ]; then
-	echo "Syntax: load-save-session.sh <session dir>"
+	echo "Syntax: load-save-session.sh [--debug|--valgrind|--massif] [--binary] <session dir>"
 	exit 1
 fi
 
 NAME=`basename $DIR_PATH`
 
 if [ "$OPTION" == "--debug" ]; then
-	gdb --args $ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME
+	gdb --args $ARDOUR_LIBS_DIR/$PROGRAM_NAME $BINARY $DIR_PATH $NAME
 elif [ "$OPTION" == "--valgrind" ]; then
 	MEMCHECK_OPTIONS="--leak-check=full"
 	valgrind $MEMCHECK_OPTIONS \
-	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME
+	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $BINARY $DIR_PATH $NAME
 elif [ "$OPTION" == "--massif" ]; then
 	MASSIF_OPTIONS="--time-unit=ms --massif-out-file=massif.out.$NAME"
 	valgrind --tool=massif $MASSIF_OPTIONS \
-	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME
+	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $BINARY $DIR_PATH $NAME
 else
-	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $DIR_PATH $NAME
+	$ARDOUR_LIBS_DIR/$PROGRAM_NAME $BINARY $DIR_PATH $NAME
 fi
@@ -745,7 +745,7 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("clear", (void (Evoral::ControlList::*)(Temporal::timepos_t const &, timepos_t const &))&Evoral::ControlList::clear)
 		.addFunction ("clear_list", (void (Evoral::ControlList::*)())&Evoral::ControlList::clear)
 		.addFunction ("in_write_pass", &Evoral::ControlList::in_write_pass)
-		.addFunction ("events", &Evoral::ControlList::events)
+		.addFunction ("events", &Evoral::ControlList::script_events)
 		.addFunction ("size", &Evoral::ControlList::size)
 		.endClass ()
 
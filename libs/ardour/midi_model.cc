@@ -484,7 +484,7 @@ MidiModel::NoteDiffCommand::unmarshal_note (XMLNode *xml_note)
 		warning << "note information missing velocity" << endmsg;
 	}
 
-	NotePtr note_ptr(new Evoral::Note<TimeType>(channel, time, length, note, velocity));
+	NotePtr note_ptr (MidiModel::new_note (channel, time, length, note, velocity));
 	note_ptr->set_id (id);
 
 	return note_ptr;
@@ -1439,7 +1439,8 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 	TimeType ea  = note->end_time();
 
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<TimeType>(0, TimeType(), TimeType(), note->note()));
+	Note<TimeType> search (0, TimeType(), TimeType(), note->note());
+	NotePtr        search_note (NotePtr (), &search); /* unowned, for searching only */
 	set<NotePtr> to_be_deleted;
 	bool set_note_length = false;
 	bool set_note_time = false;
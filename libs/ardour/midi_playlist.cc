@@ -23,12 +23,16 @@
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <queue>
 #include <utility>
 
 #include "evoral/EventList.h"
 #include "evoral/Control.h"
 
 #include "ardour/debug.h"
+#include "ardour/midi_buffer.h"
+#include "ardour/midi_channel_filter.h"
 #include "ardour/midi_model.h"
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_region.h"
@@ -49,6 +53,9 @@ using namespace std;
 MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 	: Playlist (session, node, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
+	, _render_filter (0)
+	, _render_filter_mode_mask (0)
+	, _render_note_mode (Sustained)
 {
 #ifndef NDEBUG
 	XMLProperty const * prop = node.property("type");
@@ -67,12 +74,18 @@ MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 MidiPlaylist::MidiPlaylist (Session& session, string name, bool hidden)
 	: Playlist (session, name, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
+	, _render_filter (0)
+	, _render_filter_mode_mask (0)
+	, _render_note_mode (Sustained)
 {
 }
 
 MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other, string name, bool hidden)
 	: Playlist (other, name, hidden)
 	, _note_mode(other->_note_mode)
+	, _render_filter (0)
+	, _render_filter_mode_mask (0)
+	, _render_note_mode (Sustained)
 {
 }
 
@@ -83,6 +96,9 @@ MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other,
                             bool                                  hidden)
 	: Playlist (other, start, dur, name, hidden)
 	, _note_mode(other->_note_mode)
+	, _render_filter (0)
+	, _render_filter_mode_mask (0)
+	, _render_note_mode (Sustained)
 {
 }
 
@@ -120,6 +136,17 @@ MidiPlaylist::region_going_away (boost::weak_ptr<Region> region)
 	}
 }
 
+bool
+MidiPlaylist::region_changed (const PropertyChange& what_changed, boost::shared_ptr<Region> region)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_dirty_lock);
+		_dirty_regions.insert (region->id ());
+	}
+
+	return Playlist::region_changed (what_changed, region);
+}
+
 int
 MidiPlaylist::set_state (const XMLNode& node, int version)
 {
@@ -181,6 +208,7 @@ MidiPlaylist::destroy_region (boost::shared_ptr<Region> region)
 			if ((*i) == region) {
 				regions.erase (i);
 				changed = true;
+				region_index_remove (region);
 			}
 
 			i = tmp;
@@ -284,19 +312,151 @@ MidiPlaylist::contained_automation()
 	return ret;
 }
 
+/** @return true if event @param a of @param abuf should be played before
+ *  event @param b of @param bbuf, using the same order as EventsSortByTimeAndType
+ */
+static bool
+rendered_event_earlier (RTMidiBuffer& abuf, uint32_t a, RTMidiBuffer& bbuf, uint32_t b)
+{
+	RTMidiBuffer::Item const & ai (abuf[a]);
+	RTMidiBuffer::Item const & bi (bbuf[b]);
+
+	if (ai.timestamp == bi.timestamp) {
+		uint32_t size;
+		return !MidiBuffer::second_simultaneous_midi_byte_is_first (abuf.bytes (ai, size)[0], bbuf.bytes (bi, size)[0]);
+	}
+
+	return ai.timestamp < bi.timestamp;
+}
+
+static void
+copy_rendered_event (RTMidiBuffer& src, RTMidiBuffer::Item const & item, RTMidiBuffer& dst)
+{
+	uint32_t       size;
+	uint8_t const* buf = src.bytes (item, size);
+	dst.write (item.timestamp, Evoral::MIDI_EVENT, size, buf);
+}
+
+struct RenderedEventsSortByTimeAndType {
+	RenderedEventsSortByTimeAndType (RTMidiBuffer& b) : buf (b) {}
+	bool operator() (uint32_t a, uint32_t b) const {
+		return rendered_event_earlier (buf, a, buf, b);
+	}
+	RTMidiBuffer& buf;
+};
+
+struct RenderedEventTimeEarlier {
+	RenderedEventTimeEarlier (RTMidiBuffer& b) : buf (b) {}
+	bool operator() (uint32_t a, samplepos_t t) const { return buf[a].timestamp < t; }
+	bool operator() (samplepos_t t, uint32_t a) const { return t < buf[a].timestamp; }
+	RTMidiBuffer& buf;
+};
+
+bool
+MidiPlaylist::RenderedRegion::matches (MidiRegion const & mr) const
+{
+	return position == mr.position () && start == mr.start () && length == mr.length ();
+}
+
+void
+MidiPlaylist::render_region (MidiRegion const & mr, RenderedRegion& rr, MidiChannelFilter* filter)
+{
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("render from %1\n", mr.name()));
+
+	rr.position = mr.position ();
+	rr.start    = mr.start ();
+	rr.length   = mr.length ();
+
+	rr.events.clear ();
+	mr.render (rr.events, 0, _note_mode, filter);
+
+	rr.order.resize (rr.events.size ());
+	for (uint32_t n = 0; n < rr.order.size (); ++n) {
+		rr.order[n] = n;
+	}
+
+	/* same order as sorting the events of several regions, but
+	 * done once per region rather than on every render.
+	 */
+	std::stable_sort (rr.order.begin (), rr.order.end (), RenderedEventsSortByTimeAndType (rr.events));
+}
+
+namespace {
+struct MergeCursor {
+	size_t                                n;
+	RTMidiBuffer*                         events;
+	std::vector<uint32_t>::const_iterator pos;
+	std::vector<uint32_t>::const_iterator end;
+};
+
+/* priority queue order: the next event to write is at the top, events
+ * at the same time and of the same type are taken in region order
+ */
+struct MergeCursorLater {
+	bool operator() (MergeCursor const & a, MergeCursor const & b) const {
+		if (rendered_event_earlier (*b.events, *b.pos, *a.events, *a.pos)) {
+			return true;
+		}
+		if (rendered_event_earlier (*a.events, *a.pos, *b.events, *b.pos)) {
+			return false;
+		}
+		return a.n > b.n;
+	}
+};
+}
+
+/** Write all events from @param first to @param last (inclusive) of the given
+ *  regions to @param dst. The result is identical to sorting the events of
+ *  all regions, appended in list order, with EventsSortByTimeAndType.
+ */
+void
+MidiPlaylist::merge_rendered (RenderedRegionList const & rrs, samplepos_t first, samplepos_t last, RTMidiBuffer& dst)
+{
+	std::priority_queue<MergeCursor, std::vector<MergeCursor>, MergeCursorLater> cursors;
+
+	for (size_t n = 0; n < rrs.size (); ++n) {
+		RenderedRegion& rr (*rrs[n]);
+		MergeCursor     c;
+
+		c.n      = n;
+		c.events = &rr.events;
+		c.pos    = std::lower_bound (rr.order.begin (), rr.order.end (), first, RenderedEventTimeEarlier (rr.events));
+		c.end    = std::upper_bound (c.pos, rr.order.end (), last, RenderedEventTimeEarlier (rr.events));
+
+		if (c.pos != c.end) {
+			cursors.push (c);
+		}
+	}
+
+	while (!cursors.empty ()) {
+		MergeCursor c (cursors.top ());
+		cursors.pop ();
+
+		copy_rendered_event (*c.events, (*c.events)[*c.pos], dst);
+
+		if (++c.pos != c.end) {
+			cursors.push (c);
+		}
+	}
+}
+
 void
 MidiPlaylist::render (MidiChannelFilter* filter)
 {
-	typedef pair<MidiNoteTracker*,samplepos_t> TrackerInfo;
+	typedef std::vector<std::pair<samplepos_t, samplepos_t> > Ranges;
 
 	Playlist::RegionReadLock rl (this);
+	Glib::Threads::Mutex::Lock lm (_render_lock);
 
 	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- MidiPlaylist::render (regions: %1)-----\n", regions.size()));
 
-	std::vector< boost::shared_ptr<Region> > regs;
+	std::vector<boost::shared_ptr<MidiRegion> > regs;
+	std::set<PBD::ID>                           in_playlist;
 
 	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
 
+		in_playlist.insert ((*i)->id ());
+
 		/* check for the case of solo_selection */
 
 		if (_session.solo_selection_active() && SoloSelectedActive() && !SoloSelectedListIncludes ((const Region*) &(**i))) {
@@ -307,61 +467,210 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 			continue;
 		}
 
-		regs.push_back (*i);
+		boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion>(*i);
+
+		if (!mr) {
+			continue;
+		}
+
+		regs.push_back (mr);
 	}
 
-	/* If we are reading from a single region, we can read directly into _rendered.  Otherwise,
-	   we read into a temporarily list, sort it, then write that to _rendered.
-	*/
-	Evoral::EventList<samplepos_t>  evlist;
-	Evoral::EventSink<samplepos_t>* tgt;
+	/* Regions are rendered into a cache of their own, and only rendered
+	 * again when they change. The time ranges covered by changed regions
+	 * (before and after the change) are then spliced into _rendered,
+	 * everything else is kept as it is.
+	 *
+	 * If the filter, note mode or tempo map changed, all regions are
+	 * rendered again, and _rendered is rebuilt from scratch.
+	 */
+
+	uint32_t mode_mask = 0;
+
+	if (filter) {
+		ChannelMode mode;
+		uint16_t    mask;
+		filter->get_mode_and_mask (&mode, &mask);
+		mode_mask = ((uint32_t) mode << 16) | mask;
+	}
+
+	Temporal::TempoMap::SharedPtr tmap (Temporal::TempoMap::use ());
+	std::set<PBD::ID>             dirty;
+
+	{
+		Glib::Threads::Mutex::Lock dl (_dirty_lock);
+		dirty.swap (_dirty_regions);
+	}
+
+	bool full = _rendered.reversed ();
+
+	if (filter != _render_filter || mode_mask != _render_filter_mode_mask || _note_mode != _render_note_mode || tmap != _render_tempo_map) {
+		_rendered_regions.clear ();
+		_render_filter           = filter;
+		_render_filter_mode_mask = mode_mask;
+		_render_note_mode        = _note_mode;
+		_render_tempo_map        = tmap;
+		full                     = true;
+	}
+
+	Ranges changed;
+
+	/* regions that are no longer rendered */
+
+	std::set<PBD::ID> now_included;
+
+	for (vector<boost::shared_ptr<MidiRegion> >::const_iterator i = regs.begin(); i != regs.end(); ++i) {
+		now_included.insert ((*i)->id ());
+	}
+
+	for (RenderedRegions::iterator i = _rendered_regions.begin(); i != _rendered_regions.end(); ) {
+		RenderedRegion& rr (*i->second);
+
+		if (rr.included && now_included.find (i->first) == now_included.end ()) {
+			if (!rr.order.empty ()) {
+				changed.push_back (make_pair (rr.first (), rr.last ()));
+			}
+			rr.included = false;
+		}
+
+		/* a region that is not rendered now cannot be refreshed when it changes */
+
+		if (in_playlist.find (i->first) == in_playlist.end () || (!rr.included && dirty.find (i->first) != dirty.end ())) {
+			_rendered_regions.erase (i++);
+		} else {
+			++i;
+		}
+	}
+
+	/* regions that are new or changed */
+
+	RenderedRegionList rrs;
+
+	for (vector<boost::shared_ptr<MidiRegion> >::const_iterator i = regs.begin(); i != regs.end(); ++i) {
+
+		boost::shared_ptr<RenderedRegion>& rr (_rendered_regions[(*i)->id ()]);
+
+		if (!rr || dirty.find ((*i)->id ()) != dirty.end () || !rr->matches (**i)) {
+
+			if (rr && rr->included && !rr->order.empty ()) {
+				changed.push_back (make_pair (rr->first (), rr->last ()));
+			}
+
+			rr.reset (new RenderedRegion);
+			render_region (**i, *rr, filter);
+
+		} else if (rr->included) {
+			rrs.push_back (rr);
+			continue;
+		}
+
+		if (!rr->order.empty ()) {
+			changed.push_back (make_pair (rr->first (), rr->last ()));
+		}
+
+		rr->included = true;
+		rrs.push_back (rr);
+	}
+
+	/* Events at the same time and of the same type are ordered by region,
+	 * so if the order of the regions that were already rendered changed
+	 * (e.g. by relayering), splicing would not give the same result.
+	 */
+
+	std::vector<PBD::ID> order;
+	std::vector<PBD::ID> kept_before;
+	std::vector<PBD::ID> kept_after;
+
+	order.reserve (regs.size ());
+
+	for (vector<boost::shared_ptr<MidiRegion> >::const_iterator i = regs.begin(); i != regs.end(); ++i) {
+		order.push_back ((*i)->id ());
+	}
+
+	if (!full) {
+		std::set<PBD::ID> before (_rendered_order.begin (), _rendered_order.end ());
+
+		for (vector<PBD::ID>::const_iterator i = _rendered_order.begin(); i != _rendered_order.end(); ++i) {
+			if (now_included.find (*i) != now_included.end ()) {
+				kept_before.push_back (*i);
+			}
+		}
+		for (vector<PBD::ID>::const_iterator i = order.begin(); i != order.end(); ++i) {
+			if (before.find (*i) != before.end ()) {
+				kept_after.push_back (*i);
+			}
+		}
+
+		/* a single region is written to _rendered in the order it
+		 * rendered the events, not sorted.
+		 */
+		if (kept_before != kept_after || _rendered_order.size () == 1 || order.size () == 1) {
+			full = true;
+		}
+	}
+
+	_rendered_order.swap (order);
 
 	/* RAII */
 	RTMidiBuffer::WriteProtectRender wpr (_rendered);
 
-	if (regs.empty()) {
+	if (full) {
+
+		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\t%1 regions to write, direct: %2\n", rrs.size(), (rrs.size() == 1)));
+
 		wpr.acquire ();
 		_rendered.clear ();
-	} else {
 
-		if (regs.size() == 1) {
-			tgt = &_rendered;
-			wpr.acquire ();
-			_rendered.clear ();
-		} else {
-			tgt = &evlist;
+		if (rrs.size () == 1) {
+			RTMidiBuffer& events (rrs.front ()->events);
+			for (size_t n = 0; n < events.size (); ++n) {
+				copy_rendered_event (events, events[n], _rendered);
+			}
+		} else if (!rrs.empty ()) {
+			merge_rendered (rrs, std::numeric_limits<samplepos_t>::min (), std::numeric_limits<samplepos_t>::max (), _rendered);
 		}
 
-		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\t%1 regions to read, direct: %2\n", regs.size(), (regs.size() == 1)));
+	} else if (!changed.empty ()) {
 
-		for (vector<boost::shared_ptr<Region> >::iterator i = regs.begin(); i != regs.end(); ++i) {
+		/* merge overlapping ranges */
 
-			boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion>(*i);
+		std::sort (changed.begin (), changed.end ());
 
-			if (!mr) {
-				continue;
-			}
+		Ranges ranges;
+		ranges.push_back (changed.front ());
 
-			DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("render from %1\n", mr->name()));
-			mr->render (*tgt, 0, _note_mode, filter);
+		for (Ranges::const_iterator r = changed.begin () + 1; r != changed.end (); ++r) {
+			if (r->first <= ranges.back ().second) {
+				ranges.back ().second = std::max (ranges.back ().second, r->second);
+			} else {
+				ranges.push_back (*r);
+			}
 		}
 
-		if (!evlist.empty()) {
-			/* We've read from multiple regions into evlist, sort the event list by time. */
-			EventsSortByTimeAndType<samplepos_t> cmp;
-			evlist.sort (cmp);
+		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\tsplice %1 ranges from %2 regions\n", ranges.size(), rrs.size()));
 
-			/* Copy ordered events from event list to _rendered. */
+		/* we are the only writer, reading _rendered without the lock is fine */
 
-			wpr.acquire ();
-			_rendered.clear ();
+		_splice.clear ();
 
-			for (Evoral::EventList<samplepos_t>::iterator e = evlist.begin(); e != evlist.end(); ++e) {
-				Evoral::Event<samplepos_t>* ev (*e);
-				_rendered.write (ev->time(), ev->event_type(), ev->size(), ev->buffer());
-				delete ev;
+		size_t n = 0;
+
+		for (Ranges::const_iterator r = ranges.begin (); r != ranges.end (); ++r) {
+			for (; n < _rendered.size () && _rendered[n].timestamp < r->first; ++n) {
+				copy_rendered_event (_rendered, _rendered[n], _splice);
+			}
+			for (; n < _rendered.size () && _rendered[n].timestamp <= r->second; ++n) {
+				/* skip, replaced below */
 			}
+			merge_rendered (rrs, r->first, r->second, _splice);
 		}
+
+		for (; n < _rendered.size (); ++n) {
+			copy_rendered_event (_rendered, _rendered[n], _splice);
+		}
+
+		wpr.acquire ();
+		_rendered.swap (_splice);
 	}
 
 	/* no need to release - RAII with WriteProtectRender takes care of it */
@@ -108,6 +108,9 @@ MidiRegion::do_export (string const& path) const
 	newsrc = boost::dynamic_pointer_cast<MidiSource> (SourceFactory::createWritable (DataType::MIDI, _session, path, _session.sample_rate (), false, true));
 
 	{
+		/* load the model (if deferred) before we lock the source */
+		midi_source(0)->model ();
+
 		/* Lock our source since we'll be reading from it.  write_to() will
 		 * take a lock on newsrc.
 		 */
@@ -145,6 +148,9 @@ MidiRegion::clone (boost::shared_ptr<MidiSource> newsrc, ThawList* tl) const
 	{
 		boost::shared_ptr<MidiSource> ms = midi_source(0);
 
+		/* load the model (if deferred) before we lock the source */
+		ms->model ();
+
 		/* Lock our source since we'll be reading from it.  write_to() will
 		   take a lock on newsrc.
 		*/
@@ -433,7 +439,12 @@ MidiRegion::clobber_sources (boost::shared_ptr<MidiSource> s)
 void
 MidiRegion::model_changed ()
 {
-	if (!model()) {
+	/* do not load a deferred model just because a region was created;
+	 * we are called again once it has been loaded.
+	 */
+	boost::shared_ptr<MidiModel> m = midi_source()->loaded_model ();
+
+	if (!m) {
 		return;
 	}
 
@@ -441,7 +452,7 @@ MidiRegion::model_changed ()
 
 	_filtered_parameters.clear ();
 
-	Automatable::Controls const & c = model()->controls();
+	Automatable::Controls const & c = m->controls();
 
 	for (Automatable::Controls::const_iterator i = c.begin(); i != c.end(); ++i) {
 		boost::shared_ptr<AutomationControl> ac = boost::dynamic_pointer_cast<AutomationControl> (i->second);
@@ -456,8 +467,8 @@ MidiRegion::model_changed ()
 		_model_connection, boost::bind (&MidiRegion::model_automation_state_changed, this, _1)
 		);
 
-	model()->ContentsShifted.connect_same_thread (_model_shift_connection, boost::bind (&MidiRegion::model_shifted, this, _1));
-	model()->ContentsChanged.connect_same_thread (_model_changed_connection, boost::bind (&MidiRegion::model_contents_changed, this));
+	m->ContentsShifted.connect_same_thread (_model_shift_connection, boost::bind (&MidiRegion::model_shifted, this, _1));
+	m->ContentsChanged.connect_same_thread (_model_changed_connection, boost::bind (&MidiRegion::model_contents_changed, this));
 }
 
 void
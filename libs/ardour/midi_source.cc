@@ -68,6 +68,7 @@ MidiSource::MidiSource (Session& s, string name, Source::Flag flags)
 	, _writing(false)
 	, _capture_length(0)
 {
+	g_atomic_int_set (&_model_deferred, 0);
 }
 
 MidiSource::MidiSource (Session& s, const XMLNode& node)
@@ -75,6 +76,8 @@ MidiSource::MidiSource (Session& s, const XMLNode& node)
 	, _writing(false)
 	, _capture_length(0)
 {
+	g_atomic_int_set (&_model_deferred, 0);
+
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
 	}
@@ -471,9 +474,26 @@ MidiSource::session_saved()
 	}
 }
 
+boost::shared_ptr<MidiModel>
+MidiSource::model ()
+{
+	if (g_atomic_int_get (&_model_deferred)) {
+		{
+			WriterLock lm (_lock);
+			if (g_atomic_int_get (&_model_deferred)) {
+				load_model (lm);
+			}
+		}
+		ModelChanged (); /* EMIT SIGNAL */
+	}
+
+	return _model;
+}
+
 void
 MidiSource::drop_model (const WriterLock& lock)
 {
+	g_atomic_int_set (&_model_deferred, 0);
 	_model.reset();
 	invalidate(lock);
 	ModelChanged (); /* EMIT SIGNAL */
@@ -482,6 +502,7 @@ MidiSource::drop_model (const WriterLock& lock)
 void
 MidiSource::set_model (const WriterLock& lock, boost::shared_ptr<MidiModel> m)
 {
+	g_atomic_int_set (&_model_deferred, 0);
 	_model = m;
 	invalidate(lock);
 	ModelChanged (); /* EMIT SIGNAL */
@@ -75,9 +75,10 @@ MidiStretch::run (boost::shared_ptr<Region> r, Progress*)
 	}
 
 	boost::shared_ptr<MidiSource> src = region->midi_source(0);
+	boost::shared_ptr<MidiModel> old_model = src->model();
+
 	Source::ReaderLock lock (src->mutex());
 
-	boost::shared_ptr<MidiModel> old_model = src->model();
 	boost::shared_ptr<MidiSource> new_src = boost::dynamic_pointer_cast<MidiSource>(nsrcs[0]);
 
 	if (!new_src) {
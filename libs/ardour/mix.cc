@@ -145,6 +145,39 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+float
+default_apply_gain_ramp (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t nframes, float initial, float target, float coeff)
+{
+	float g = initial;
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] = src[i] * g;
+		g += coeff * (target - g);
+	}
+	return g;
+}
+
+void
+default_reduce_peaks (const ARDOUR::Sample * src, pframes_t nframes, pframes_t fpp, ARDOUR::PeakData* peaks)
+{
+	while (nframes > 0) {
+		const pframes_t n = min (fpp, nframes);
+		float a = src[0];
+		float b = src[0];
+
+		for (pframes_t i = 1; i < n; ++i) {
+			a = max (src[i], a);
+			b = min (src[i], b);
+		}
+
+		peaks->max = a;
+		peaks->min = b;
+
+		++peaks;
+		src += n;
+		nframes -= n;
+	}
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
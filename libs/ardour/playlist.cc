@@ -29,6 +29,7 @@
 #include <set>
 #include <stdint.h>
 #include <string>
+#include <unordered_set>
 
 #include <glibmm/datetime.h>
 
@@ -45,6 +46,7 @@
 #include "ardour/playlist_source.h"
 #include "ardour/region.h"
 #include "ardour/region_factory.h"
+#include "ardour/region_index.h"
 #include "ardour/region_sorters.h"
 #include "ardour/session.h"
 #include "ardour/session_playlists.h"
@@ -325,6 +327,7 @@ Playlist::init (bool hide)
 
 	g_atomic_int_set (&block_notifications, 0);
 	g_atomic_int_set (&ignore_state_changes, 0);
+	g_atomic_int_set (&_generation, 0);
 	pending_contents_change     = false;
 	pending_layering            = false;
 	first_set_state             = true;
@@ -343,6 +346,8 @@ Playlist::init (bool hide)
 	_combine_ops = 0;
 	_end_space = timecnt_t (_type == DataType::AUDIO ? Temporal::AudioTime : Temporal::BeatTime);
 	_playlist_shift_active = false;
+	_layering_state_model  = Manual;
+	_layering_state_domain = Temporal::AudioTime;
 
 	_session.history ().BeginUndoRedo.connect_same_thread (*this, boost::bind (&Playlist::begin_undo, this));
 	_session.history ().EndUndoRedo.connect_same_thread (*this, boost::bind (&Playlist::end_undo, this));
@@ -771,6 +776,7 @@ Playlist::add_region_internal (boost::shared_ptr<Region> region, timepos_t const
 
 	regions.insert (upper_bound (regions.begin (), regions.end (), region, cmp), region);
 	all_regions.insert (region);
+	region_index_add (region);
 
 	if (!holding_state ()) {
 		/* layers get assigned from XML state, and are not reset during undo/redo */
@@ -826,6 +832,7 @@ Playlist::remove_region_internal (boost::shared_ptr<Region> region, ThawList& th
 		if (*i == region) {
 
 			regions.erase (i);
+			region_index_remove (region);
 
 			if (!holding_state ()) {
 				relayer ();
@@ -1613,6 +1620,7 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 
 		regions.erase (i);
 		regions.insert (upper_bound (regions.begin (), regions.end (), region, cmp), region);
+		/* the region index was already updated by region_property_changed () */
 
 		if (holding_state ()) {
 			pending_bounds.push_back (region);
@@ -1704,6 +1712,7 @@ Playlist::drop_regions ()
 	RegionWriteLock rl (this);
 	regions.clear ();
 	all_regions.clear ();
+	invalidate_region_index ();
 }
 
 void
@@ -1732,6 +1741,7 @@ Playlist::clear (bool with_signals)
 		}
 
 		regions.clear ();
+		invalidate_region_index ();
 
 		for (auto & r : pending_removes) {
 			remove_dependents (r);
@@ -1784,6 +1794,17 @@ Playlist::count_regions_at (timepos_t const & pos) const
 	RegionReadLock rlock (const_cast<Playlist*> (this));
 	uint32_t       cnt = 0;
 
+	RegionList candidates;
+
+	if (find_overlapping (pos, pos, candidates)) {
+		for (auto const & r : candidates) {
+			if (r->covers (pos)) {
+				cnt++;
+			}
+		}
+		return cnt;
+	}
+
 	for (auto const & r : regions) {
 		if (r->covers (pos)) {
 			cnt++;
@@ -1845,6 +1866,17 @@ Playlist::find_regions_at (timepos_t const & pos)
 
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
+	RegionList candidates;
+
+	if (find_overlapping (pos, pos, candidates)) {
+		for (auto & r : candidates) {
+			if (r->covers (pos)) {
+				rlist->push_back (r);
+			}
+		}
+		return rlist;
+	}
+
 	for (auto & r : regions) {
 		if (r->covers (pos)) {
 			rlist->push_back (r);
@@ -1860,6 +1892,17 @@ Playlist::regions_with_start_within (Temporal::Range range)
 	RegionReadLock                rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
+	RegionList                    candidates;
+
+	if (find_overlapping (range.start(), range.end(), candidates)) {
+		for (auto & r : candidates) {
+			if (r->position() >= range.start() && r->position() < range.end()) {
+				rlist->push_back (r);
+			}
+		}
+		return rlist;
+	}
+
 	for (auto & r : regions) {
 		if (r->position() >= range.start() && r->position() < range.end()) {
 			rlist->push_back (r);
@@ -1875,6 +1918,17 @@ Playlist::regions_with_end_within (Temporal::Range range)
 	RegionReadLock                rlock (this);
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
+	RegionList                    candidates;
+
+	if (find_overlapping (range.start(), range.end(), candidates)) {
+		for (auto & r : candidates) {
+			if (r->nt_last() >= range.start() && r->nt_last() < range.end()) {
+				rlist->push_back (r);
+			}
+		}
+		return rlist;
+	}
+
 	for (auto & r : regions) {
 		if (r->nt_last() >= range.start() && r->nt_last() < range.end()) {
 			rlist->push_back (r);
@@ -1896,6 +1950,18 @@ Playlist::regions_touched_locked (timepos_t const & start, timepos_t const & end
 {
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
+	RegionList                    candidates;
+
+	/* coverage () excludes the end of both ranges, so this is a superset */
+	if (find_overlapping (start, end, candidates)) {
+		for (auto & r : candidates) {
+			if (r->coverage (start, end) != Temporal::OverlapNone) {
+				rlist->push_back (r);
+			}
+		}
+		return rlist;
+	}
+
 	for (auto & r : regions) {
 		if (r->coverage (start, end) != Temporal::OverlapNone) {
 			rlist->push_back (r);
@@ -1905,6 +1971,73 @@ Playlist::regions_touched_locked (timepos_t const & start, timepos_t const & end
 	return rlist;
 }
 
+void
+Playlist::invalidate_region_index ()
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	_region_index.reset ();
+	g_atomic_int_inc (&_generation);
+}
+
+void
+Playlist::region_index_add (boost::shared_ptr<Region> const & region)
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	if (_region_index) {
+		_region_index->add (region);
+	}
+	g_atomic_int_inc (&_generation);
+}
+
+void
+Playlist::region_index_remove (boost::shared_ptr<Region> const & region)
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	if (_region_index) {
+		_region_index->remove (region.get ());
+	}
+	g_atomic_int_inc (&_generation);
+}
+
+void
+Playlist::region_property_changed (Region const * region, PropertyChange const & what_changed)
+{
+	if (what_changed.contains (Properties::length) || what_changed.contains (Properties::time_domain)) {
+		/* the region was moved or trimmed (position is part of the length) */
+		Glib::Threads::Mutex::Lock lm (_region_index_lock);
+		if (_region_index) {
+			_region_index->update (region);
+		}
+	}
+	g_atomic_int_inc (&_generation);
+}
+
+/** Use the region index to find all regions which may intersect
+ * [first, last]. The index is built on first use, and then kept up to date
+ * as regions are added, removed, moved or trimmed.
+ *
+ * Caller must hold the region lock.
+ *
+ * @return false if the index cannot be used for the given range, callers
+ * then have to search the region list.
+ */
+bool
+Playlist::find_overlapping (timepos_t const & first, timepos_t const & last, RegionList& candidates) const
+{
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+	if (!_region_index) {
+		_region_index.reset (new RegionIndex);
+		for (auto const & r : regions) {
+			_region_index->add (r);
+		}
+	}
+	if (!_region_index->can_search (first) || !_region_index->can_search (last)) {
+		return false;
+	}
+	_region_index->overlapping (first, last, candidates);
+	return true;
+}
+
 samplepos_t
 Playlist::find_next_transient (timepos_t const & from, int dir)
 {
@@ -2511,6 +2644,66 @@ Playlist::relayer ()
 
 	if (regions.empty()) {
 		/* nothing to do */
+		_layering_state.clear ();
+		return;
+	}
+
+	/* Sort our regions into layering index order (for manual layering) or position order (for later is higher)*/
+	RegionList copy = regions.rlist ();
+	switch (Config->get_layer_model ()) {
+		case LaterHigher:
+			copy.sort (LaterHigherSort ());
+			break;
+		case Manual:
+			copy.sort (RelayerSort ());
+			break;
+	}
+
+	DEBUG_TRACE (DEBUG::Layering, "relayer() using:\n");
+#ifndef NDEBUG
+	for (auto const & r : copy) {
+		DEBUG_TRACE (DEBUG::Layering, string_compose ("\t%1 %2\n", r->name (), r->layering_index ()));
+	}
+#endif
+
+	RegionList subset;
+
+	if (find_regions_to_relayer (copy, subset)) {
+		DEBUG_TRACE (DEBUG::Layering, string_compose ("relayer() %1 of %2 regions\n", subset.size (), copy.size ()));
+		assign_layers (subset);
+	} else {
+		assign_layers (copy);
+	}
+
+	save_layering_state (copy);
+	g_atomic_int_inc (&_generation);
+
+	/* It's a little tricky to know when we could avoid calling this; e.g. if we are
+	 * relayering because we just removed the only region on the top layer, nothing will
+	 * appear to have changed, but the StreamView must still sort itself out.  We could
+	 * probably keep a note of the top layer last time we relayered, and check that,
+	 * but premature optimisation &c...
+	 */
+	notify_layering_changed ();
+
+	/* This relayer() may have been called as a result of a region removal, in which
+	 * case we need to setup layering indices to account for the one that has just
+	 * gone away.
+	 */
+	setup_layering_indices (copy);
+}
+
+/** Compute layers for the given regions, in the given order.
+ *
+ * A region is placed one layer above the highest region it overlaps, which
+ * precedes it in @a ordered (or on layer 0). So the result for any region
+ * only depends on the regions it transitively overlaps, and @a ordered may be
+ * any subset of the playlist which is closed under overlap.
+ */
+void
+Playlist::assign_layers (RegionList const & ordered)
+{
+	if (ordered.empty ()) {
 		return;
 	}
 
@@ -2522,11 +2715,11 @@ Playlist::relayer ()
 	/* how many pieces to divide this playlist's time up into */
 	int const divisions = 512;
 
-	/* find the start and end positions of the regions on this playlist */
-	timepos_t start = timepos_t::max (regions.front()->position().time_domain());
+	/* find the start and end positions of the regions */
+	timepos_t start = timepos_t::max (ordered.front()->position().time_domain());
 	timepos_t end = timepos_t (start.time_domain());
 
-	for (auto const & r : regions) {
+	for (auto const & r : ordered) {
 		start = min (start, r->position());
 		end = max (end, r->position() + r->length());
 	}
@@ -2537,25 +2730,7 @@ Playlist::relayer ()
 	vector<vector<RegionList> > layers;
 	layers.push_back (vector<RegionList> (divisions));
 
-	/* Sort our regions into layering index order (for manual layering) or position order (for later is higher)*/
-	RegionList copy = regions.rlist ();
-	switch (Config->get_layer_model ()) {
-		case LaterHigher:
-			copy.sort (LaterHigherSort ());
-			break;
-		case Manual:
-			copy.sort (RelayerSort ());
-			break;
-	}
-
-	DEBUG_TRACE (DEBUG::Layering, "relayer() using:\n");
-#ifndef NDEBUG
-	for (auto const & r : copy) {
-		DEBUG_TRACE (DEBUG::Layering, string_compose ("\t%1 %2\n", r->name (), r->layering_index ()));
-	}
-#endif
-
-	for (auto const & r : copy) {
+	for (auto const & r : ordered) {
 		/* find the time divisions that this region covers; if there are no regions on the list,
 		 * division_size will equal 0 and in this case we'll just say that
 		 * start_division = end_division = 0.
@@ -2616,20 +2791,220 @@ Playlist::relayer ()
 
 		r->set_layer (j);
 	}
+}
+
+/** Compare the playlist with the state saved by the last relayer() and find
+ * the regions whose layer may change.
+ *
+ * Regions which were added, removed, moved, trimmed or changed their relative
+ * order, or whose layer was modified elsewhere, are "dirty". All regions that
+ * (transitively) overlap the old or new extent of a dirty region are added to
+ * @a subset, in the order of @a ordered.
+ *
+ * @return false if the state cannot be compared, and all regions need to be
+ * relayered.
+ */
+bool
+Playlist::find_regions_to_relayer (RegionList const & ordered, RegionList& subset)
+{
+	if (_layering_state.empty () || _layering_state_model != Config->get_layer_model ()) {
+		return false;
+	}
 
-	/* It's a little tricky to know when we could avoid calling this; e.g. if we are
-	 * relayering because we just removed the only region on the top layer, nothing will
-	 * appear to have changed, but the StreamView must still sort itself out.  We could
-	 * probably keep a note of the top layer last time we relayered, and check that,
-	 * but premature optimisation &c...
+	Temporal::TimeDomain const td = _layering_state_domain;
+
+	struct Item {
+		boost::shared_ptr<Region> region;
+		int64_t                   first;
+		int64_t                   last;
+		bool                      dirty;
+		bool                      relayer;
+	};
+
+	vector<Item>                    items;
+	vector<pair<int64_t, int64_t> > dirty_spans;
+	vector<pair<size_t, size_t> >   ranks; /* previous rank, index into items */
+	size_t                          seen = 0;
+
+	items.reserve (ordered.size ());
+
+	for (auto const & r : ordered) {
+		timepos_t const pos (r->position ());
+		timepos_t const last (r->nt_last ());
+
+		if (pos.time_domain () != td || last.time_domain () != td) {
+			/* positions cannot be compared without a tempo-map */
+			return false;
+		}
+
+		Item i = { r, pos.val (), last.val (), false, false };
+
+		unordered_map<Region const*, LayeringState>::const_iterator s = _layering_state.find (r.get ());
+
+		if (s == _layering_state.end ()) {
+			i.dirty = true;
+		} else {
+			++seen;
+			if (s->second.first != i.first || s->second.last != i.last || s->second.layer != r->layer ()) {
+				i.dirty = true;
+				dirty_spans.push_back (make_pair (s->second.first, max (s->second.first, s->second.last)));
+			} else {
+				ranks.push_back (make_pair (s->second.rank, items.size ()));
+			}
+		}
+
+		if (i.dirty) {
+			dirty_spans.push_back (make_pair (i.first, max (i.first, i.last)));
+		}
+
+		items.push_back (i);
+	}
+
+	if (seen < _layering_state.size ()) {
+		/* some regions have been removed, find out where they used to be */
+		unordered_set<Region const*> present;
+		for (auto const & r : ordered) {
+			present.insert (r.get ());
+		}
+		for (auto const & s : _layering_state) {
+			if (present.find (s.first) == present.end ()) {
+				dirty_spans.push_back (make_pair (s.second.first, max (s.second.first, s.second.last)));
+			}
+		}
+	}
+
+	/* Unchanged regions must retain their relative order. Find the longest
+	 * subsequence with increasing previous rank; all others moved.
 	 */
-	notify_layering_changed ();
+	vector<size_t> tails;                             /* index into ranks of the smallest tail of each length */
+	vector<size_t> parent (ranks.size (), SIZE_MAX); /* predecessor in the subsequence */
+
+	for (size_t n = 0; n < ranks.size (); ++n) {
+		size_t lo = 0;
+		size_t hi = tails.size ();
+		while (lo < hi) {
+			size_t const mid = (lo + hi) / 2;
+			if (ranks[tails[mid]].first < ranks[n].first) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		if (lo > 0) {
+			parent[n] = tails[lo - 1];
+		}
+		if (lo == tails.size ()) {
+			tails.push_back (n);
+		} else {
+			tails[lo] = n;
+		}
+	}
 
-	/* This relayer() may have been called as a result of a region removal, in which
-	 * case we need to setup layering indices to account for the one that has just
-	 * gone away.
+	vector<bool> in_order (ranks.size (), false);
+	for (size_t n = tails.empty () ? SIZE_MAX : tails.back (); n != SIZE_MAX; n = parent[n]) {
+		in_order[n] = true;
+	}
+
+	for (size_t n = 0; n < ranks.size (); ++n) {
+		if (!in_order[n]) {
+			Item& i (items[ranks[n].second]);
+			i.dirty = true;
+			dirty_spans.push_back (make_pair (i.first, max (i.first, i.last)));
+		}
+	}
+
+	if (dirty_spans.empty ()) {
+		return true;
+	}
+
+	/* Find clusters of (inclusively) overlapping regions, and relayer all
+	 * regions in clusters that intersect a dirty span.
 	 */
-	setup_layering_indices (copy);
+	vector<size_t> by_position;
+	by_position.reserve (items.size ());
+	for (size_t n = 0; n < items.size (); ++n) {
+		by_position.push_back (n);
+	}
+
+	sort (by_position.begin (), by_position.end (), [&items] (size_t a, size_t b) { return items[a].first < items[b].first; });
+
+	/* merge dirty spans, so that both their starts and ends are increasing */
+	sort (dirty_spans.begin (), dirty_spans.end ());
+
+	vector<pair<int64_t, int64_t> > dirty;
+	for (auto const & span : dirty_spans) {
+		if (!dirty.empty () && span.first <= dirty.back ().second) {
+			dirty.back ().second = max (dirty.back ().second, span.second);
+		} else {
+			dirty.push_back (span);
+		}
+	}
+
+	vector<pair<int64_t, int64_t> >::const_iterator d = dirty.begin ();
+	vector<size_t>::const_iterator                  c = by_position.begin ();
+	size_t                                          n_relayer = 0;
+
+	while (c != by_position.end ()) {
+
+		/* extend the cluster */
+		vector<size_t>::const_iterator e = c;
+		int64_t const                 first = items[*c].first;
+		int64_t                       last  = max (first, items[*c].last);
+
+		for (++e; e != by_position.end () && items[*e].first <= last; ++e) {
+			last = max (last, items[*e].last);
+		}
+
+		/* skip dirty spans that end before this cluster */
+		while (d != dirty.end () && d->second < first) {
+			++d;
+		}
+
+		if (d != dirty.end () && d->first <= last) {
+			for (; c != e; ++c) {
+				items[*c].relayer = true;
+				++n_relayer;
+			}
+		}
+
+		c = e;
+	}
+
+	if (n_relayer > items.size () / 2) {
+		/* not worth it */
+		return false;
+	}
+
+	for (auto const & i : items) {
+		if (i.relayer) {
+			subset.push_back (i.region);
+		}
+	}
+
+	return true;
+}
+
+void
+Playlist::save_layering_state (RegionList const & ordered)
+{
+	_layering_state.clear ();
+	_layering_state_model  = Config->get_layer_model ();
+	_layering_state_domain = ordered.front ()->position ().time_domain ();
+
+	size_t rank = 0;
+	for (auto const & r : ordered) {
+		timepos_t const pos (r->position ());
+		timepos_t const last (r->nt_last ());
+
+		if (pos.time_domain () != _layering_state_domain || last.time_domain () != _layering_state_domain) {
+			/* the next relayer () will have to start from scratch */
+			_layering_state.clear ();
+			return;
+		}
+
+		LayeringState s = { pos.val (), last.val (), rank++, r->layer () };
+		_layering_state[r.get ()] = s;
+	}
 }
 
 void
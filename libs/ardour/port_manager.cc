@@ -145,6 +145,7 @@ PortManager::PortManager ()
 	, _midi_info_dirty (true)
 	, _audio_input_ports (new AudioInputPorts)
 	, _midi_input_ports (new MIDIInputPorts)
+	, _input_meter_rate (0)
 {
 	g_atomic_int_set (&_reset_meters, 1);
 	load_port_info ();
@@ -1113,14 +1114,21 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	 *    input-ports. Currently re-sampling is per input.
 	 */
 	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+		boost::shared_ptr<RTTaskList> tl (s->rt_tasklist ());
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_start, p->second, nframes));
+				RTTask task (RTTask::member<Port, &Port::cycle_start> (p->second.get (), nframes));
+				if (!tl->push_back (task)) {
+					task.run ();
+				}
 			}
 		}
-		tl.push_back (boost::bind (&PortManager::run_input_meters, this, nframes, s ? s->nominal_sample_rate () : 0));
-		s->rt_tasklist ()->process (tl);
+		_input_meter_rate = s->nominal_sample_rate ();
+		RTTask task (RTTask::member<PortManager, &PortManager::run_input_meters_task> (this, nframes));
+		if (!tl->push_back (task)) {
+			task.run ();
+		}
+		tl->process ();
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
@@ -1136,13 +1144,16 @@ PortManager::cycle_end (pframes_t nframes, Session* s)
 {
 	// see optimzation note in ::cycle_start()
 	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+		boost::shared_ptr<RTTaskList> tl (s->rt_tasklist ());
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
+				RTTask task (RTTask::member<Port, &Port::cycle_end> (p->second.get (), nframes));
+				if (!tl->push_back (task)) {
+					task.run ();
+				}
 			}
 		}
-		s->rt_tasklist ()->process (tl);
+		tl->process ();
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
@@ -1244,13 +1255,16 @@ PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t n
 {
 	// see optimzation note in ::cycle_start()
 	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
-		RTTaskList::TaskList tl;
+		boost::shared_ptr<RTTaskList> tl (s->rt_tasklist ());
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
-				tl.push_back (boost::bind (&Port::cycle_end, p->second, nframes));
+				RTTask task (RTTask::member<Port, &Port::cycle_end> (p->second.get (), nframes));
+				if (!tl->push_back (task)) {
+					task.run ();
+				}
 			}
 		}
-		s->rt_tasklist ()->process (tl);
+		tl->process ();
 	} else {
 		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
 			if (!(p->second->flags () & TransportSyncPort)) {
@@ -1820,6 +1834,12 @@ private:
 
 static FallOffCache falloff_cache;
 
+void
+PortManager::run_input_meters_task (pframes_t n_samples)
+{
+	run_input_meters (n_samples, _input_meter_rate);
+}
+
 void
 PortManager::run_input_meters (pframes_t n_samples, samplecnt_t rate)
 {
@@ -1407,6 +1407,16 @@ Region::send_change (const PropertyChange& what_changed)
 		return;
 	}
 
+	{
+		/* do not wait for (possibly suspended) property change
+		 * signals, the playlist may be queried before we're thawed.
+		 */
+		boost::shared_ptr<Playlist> pl (playlist());
+		if (pl) {
+			pl->region_property_changed (this, what_changed);
+		}
+	}
+
 	Stateful::send_change (what_changed);
 
 	if (!Stateful::property_changes_suspended()) {
@@ -0,0 +1,231 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include "ardour/region.h"
+#include "ardour/region_index.h"
+
+using namespace ARDOUR;
+
+RegionIndex::RegionIndex ()
+	: _root (0)
+	, _seq (0)
+	, _rand (0x9e3779b9)
+	, _n_mixed (0)
+{
+	_n_domain[Temporal::AudioTime] = 0;
+	_n_domain[Temporal::BeatTime]  = 0;
+}
+
+RegionIndex::~RegionIndex ()
+{
+	clear ();
+}
+
+void
+RegionIndex::clear ()
+{
+	for (auto const & n : _nodes) {
+		delete n.second;
+	}
+	_nodes.clear ();
+	_root = 0;
+	_n_mixed = 0;
+	_n_domain[Temporal::AudioTime] = 0;
+	_n_domain[Temporal::BeatTime]  = 0;
+}
+
+void
+RegionIndex::add (boost::shared_ptr<Region> const & r)
+{
+	if (_nodes.find (r.get ()) != _nodes.end ()) {
+		update (r.get ());
+		return;
+	}
+
+	Node* n = new Node (r);
+	_nodes[r.get ()] = n;
+
+	/* xorshift32 */
+	_rand ^= _rand << 13;
+	_rand ^= _rand >> 17;
+	_rand ^= _rand << 5;
+	n->priority = _rand;
+
+	load (n);
+	link (n);
+}
+
+void
+RegionIndex::remove (Region const * r)
+{
+	std::unordered_map<Region const *, Node*>::iterator i = _nodes.find (r);
+	if (i == _nodes.end ()) {
+		return;
+	}
+	Node* n = i->second;
+	_nodes.erase (i);
+	unlink (n);
+	delete n;
+}
+
+void
+RegionIndex::update (Region const * r)
+{
+	std::unordered_map<Region const *, Node*>::iterator i = _nodes.find (r);
+	if (i == _nodes.end ()) {
+		return;
+	}
+	Node* n = i->second;
+	unlink (n);
+	load (n);
+	link (n);
+}
+
+/** (re-)read the bounds of the node's region, and give it a new sequence
+ * number: just like the region list, a region that is added or moved goes
+ * after all others at the same position.
+ */
+void
+RegionIndex::load (Node* n)
+{
+	timepos_t const pos (n->region->position ());
+	timepos_t const end (n->region->nt_last ());
+
+	n->first        = pos.val ();
+	n->last         = end.val ();
+	n->subtree_last = n->last;
+	n->seq          = ++_seq;
+	n->domain       = pos.time_domain ();
+	n->mixed        = end.time_domain () != n->domain;
+	n->left         = 0;
+	n->right        = 0;
+
+	_n_domain[n->domain]++;
+	if (n->mixed) {
+		_n_mixed++;
+	}
+}
+
+void
+RegionIndex::link (Node* n)
+{
+	Node* l;
+	Node* r;
+	split (_root, n->first, n->seq, l, r);
+	_root = merge (merge (l, n), r);
+}
+
+void
+RegionIndex::unlink (Node* n)
+{
+	Node* l;
+	Node* m;
+	Node* r;
+	/* l: before n, m: n, r: after n */
+	split (_root, n->first, n->seq, l, m);
+	split (m, n->first, n->seq + 1, m, r);
+	assert (m == n);
+	_root = merge (l, r);
+
+	_n_domain[n->domain]--;
+	if (n->mixed) {
+		_n_mixed--;
+	}
+}
+
+/** split a subtree into nodes before (first, seq) and all others */
+void
+RegionIndex::split (Node* t, int64_t first, uint64_t seq, Node*& l, Node*& r)
+{
+	if (!t) {
+		l = r = 0;
+		return;
+	}
+	if (t->before (first, seq)) {
+		split (t->right, first, seq, t->right, r);
+		l = t;
+	} else {
+		split (t->left, first, seq, l, t->left);
+		r = t;
+	}
+	update_subtree (t);
+}
+
+/** join two subtrees, all nodes of l must be before all nodes of r */
+RegionIndex::Node*
+RegionIndex::merge (Node* l, Node* r)
+{
+	if (!l) {
+		return r;
+	}
+	if (!r) {
+		return l;
+	}
+	if (l->priority > r->priority) {
+		l->right = merge (l->right, r);
+		update_subtree (l);
+		return l;
+	}
+	r->left = merge (l, r->left);
+	update_subtree (r);
+	return r;
+}
+
+void
+RegionIndex::update_subtree (Node* t)
+{
+	t->subtree_last = t->last;
+	if (t->left) {
+		t->subtree_last = std::max (t->subtree_last, t->left->subtree_last);
+	}
+	if (t->right) {
+		t->subtree_last = std::max (t->subtree_last, t->right->subtree_last);
+	}
+}
+
+void
+RegionIndex::find (Node const* t, int64_t first, int64_t last, RegionList& rl)
+{
+	while (t) {
+		if (t->subtree_last < first) {
+			/* nothing in this subtree reaches the range */
+			return;
+		}
+
+		find (t->left, first, last, rl);
+
+		if (t->first > last) {
+			/* this and all later nodes start after the range */
+			return;
+		}
+
+		if (t->last >= first) {
+			rl.push_back (t->region);
+		}
+
+		/* continue with the right subtree */
+		t = t->right;
+	}
+}
+
+void
+RegionIndex::overlapping (timepos_t const & first, timepos_t const & last, RegionList& rl) const
+{
+	assert (can_search (first) && can_search (last));
+	find (_root, first.val (), last.val (), rl);
+}
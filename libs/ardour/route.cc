@@ -2648,6 +2648,22 @@ Route::state (bool save_template) const
 	return *node;
 }
 
+Glib::Threads::Mutex Route::_plugin_setup_lock;
+
+bool
+Route::processors_share_plugin_state (XMLNode const& node)
+{
+	for (XMLNodeConstIterator i = node.children ().begin (); i != node.children ().end (); ++i) {
+		std::string type;
+		if ((*i)->name () == X_("Processor") && (*i)->get_property (X_("type"), type)) {
+			if (type == X_("ladspa") || type == X_("Ladspa") || type == X_("lv2") || type == X_("luaproc")) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 int
 Route::set_state (const XMLNode& node, int version)
 {
@@ -2772,7 +2788,12 @@ Route::set_state (const XMLNode& node, int version)
 		}
 	}
 
-	set_processor_state (processor_state, version);
+	if (processors_share_plugin_state (processor_state)) {
+		Glib::Threads::Mutex::Lock lp (_plugin_setup_lock);
+		set_processor_state (processor_state, version);
+	} else {
+		set_processor_state (processor_state, version);
+	}
 
 	// this looks up the internal instrument in processors
 	reset_instrument_info();
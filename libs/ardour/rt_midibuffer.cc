@@ -416,6 +416,18 @@ RTMidiBuffer::clear ()
 	_reversed = false;
 }
 
+void
+RTMidiBuffer::swap (RTMidiBuffer& other)
+{
+	std::swap (_size, other._size);
+	std::swap (_capacity, other._capacity);
+	std::swap (_data, other._data);
+	std::swap (_reversed, other._reversed);
+	std::swap (_pool_size, other._pool_size);
+	std::swap (_pool_capacity, other._pool_capacity);
+	std::swap (_pool, other._pool);
+}
+
 samplecnt_t
 RTMidiBuffer::span() const
 {
@@ -29,17 +29,40 @@
 
 using namespace ARDOUR;
 
-RTTaskList::RTTaskList ()
+RTTaskList::RTTaskList (size_t capacity)
 	: _task_run_sem ("rt_task_run", 0)
 	, _task_end_sem ("rt_task_done", 0)
+	, _tasks (0)
+	, _capacity (0)
 {
 	g_atomic_int_set (&_threads_active, 0);
+	g_atomic_int_set (&_n_tasks, 0);
+	g_atomic_int_set (&_next_task, 0);
+	reserve (capacity);
 	reset_thread_list ();
 }
 
 RTTaskList::~RTTaskList ()
 {
 	drop_threads ();
+	delete [] _tasks;
+}
+
+void
+RTTaskList::reserve (size_t capacity)
+{
+	Glib::Threads::Mutex::Lock pm (_process_mutex);
+	if (capacity <= _capacity) {
+		return;
+	}
+
+	RTTask* tasks = new RTTask[capacity];
+	for (gint i = 0; i < g_atomic_int_get (&_n_tasks); ++i) {
+		tasks[i] = _tasks[i];
+	}
+	delete [] _tasks;
+	_tasks    = tasks;
+	_capacity = capacity;
 }
 
 void
@@ -104,84 +127,74 @@ RTTaskList::reset_thread_list ()
 void
 RTTaskList::run ()
 {
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-	bool wait = true;
-
 	while (true) {
-		if (wait) {
-			_task_run_sem.wait ();
-		}
+		_task_run_sem.wait ();
 
 		if (0 == g_atomic_int_get (&_threads_active)) {
 			_task_end_sem.signal ();
 			break;
 		}
 
-		wait = false;
-
-		boost::function<void ()> to_run;
-		tm.acquire ();
-		if (!_tasklist.empty ()) {
-			to_run = _tasklist.front();
-			_tasklist.pop_front ();
-		}
-		tm.release ();
+		run_tasks ();
 
-		if (!to_run.empty ()) {
-			to_run ();
-			continue;
-		}
+		_task_end_sem.signal ();
+	}
+}
 
-		if (!wait) {
-			_task_end_sem.signal ();
+/** Claim and run tasks until all have been claimed.
+ * Called concurrently by all worker threads and the thread calling process().
+ */
+void
+RTTaskList::run_tasks ()
+{
+	const gint n_tasks = g_atomic_int_get (&_n_tasks);
+	while (true) {
+		gint i = g_atomic_int_add (&_next_task, 1);
+		if (i >= n_tasks) {
+			break;
 		}
+		_tasks[i].run ();
+	}
+}
 
-		wait = true;
+bool
+RTTaskList::push_back (RTTask const& task)
+{
+	gint n = g_atomic_int_get (&_n_tasks);
+	if ((size_t) n >= _capacity) {
+		return false;
 	}
+	_tasks[n] = task;
+	g_atomic_int_set (&_n_tasks, n + 1);
+	return true;
 }
 
 void
-RTTaskList::process (TaskList const& tl)
+RTTaskList::process ()
 {
 	Glib::Threads::Mutex::Lock pm (_process_mutex);
 
-#ifndef NDEBUG
-	/* must not be called while processing is already running */
-	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
-	tm.acquire ();
-	assert (_tasklist.empty ());
-	tm.release ();
-#endif
-
-	_tasklist = tl;
-	process_tasklist ();
-
-#ifndef NDEBUG
-	/* ensure that all tasks are processed, and threads are in wait state */
-	tm.acquire ();
-	assert (_tasklist.empty ());
-	tm.release ();
-#endif
-}
+	const uint32_t n_tasks = g_atomic_int_get (&_n_tasks);
 
-void
-RTTaskList::process_tasklist ()
-{
-	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0) {
+	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0 || n_tasks < 2) {
+		for (uint32_t i = 0; i < n_tasks; ++i) {
+			_tasks[i].run ();
+		}
+	} else {
+		/* wake up worker threads, and help out */
+		uint32_t nt = std::min<uint32_t> (_threads.size (), n_tasks - 1);
 
-		for (TaskList::iterator i = _tasklist.begin (); i != _tasklist.end(); ++i) {
-			(*i)();
+		for (uint32_t i = 0; i < nt; ++i) {
+			_task_run_sem.signal ();
 		}
-		_tasklist.clear ();
-		return;
-	}
 
-	uint32_t nt = std::min (_threads.size (), _tasklist.size ());
+		run_tasks ();
 
-	for (uint32_t i = 0; i < nt; ++i) {
-		_task_run_sem.signal ();
-	}
-	for (uint32_t i = 0; i < nt; ++i) {
-		_task_end_sem.wait ();
+		for (uint32_t i = 0; i < nt; ++i) {
+			_task_end_sem.wait ();
+		}
 	}
+
+	g_atomic_int_set (&_next_task, 0);
+	g_atomic_int_set (&_n_tasks, 0);
 }
@@ -289,6 +289,7 @@ Session::Session (AudioEngine &eng,
 	, _total_free_4k_blocks (0)
 	, _total_free_4k_blocks_uncertain (false)
 	, no_questions_about_missing_files (false)
+	, _loading_sources_concurrently (false)
 	, _bundles (new BundleList)
 	, _bundle_xml_node (0)
 	, _current_trans (0)
@@ -5471,6 +5472,8 @@ Session::ensure_buffer_set(BufferSet& buffers, const ChanCount& count)
 uint32_t
 Session::next_insert_id ()
 {
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
+
 	/* this doesn't really loop forever. just think about it */
 
 	while (true) {
@@ -5491,6 +5494,8 @@ Session::next_insert_id ()
 uint32_t
 Session::next_send_id ()
 {
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
+
 	/* this doesn't really loop forever. just think about it */
 
 	while (true) {
@@ -5511,6 +5516,8 @@ Session::next_send_id ()
 uint32_t
 Session::next_aux_send_id ()
 {
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
+
 	/* this doesn't really loop forever. just think about it */
 
 	while (true) {
@@ -5531,6 +5538,8 @@ Session::next_aux_send_id ()
 uint32_t
 Session::next_return_id ()
 {
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
+
 	/* this doesn't really loop forever. just think about it */
 
 	while (true) {
@@ -5551,6 +5560,7 @@ Session::next_return_id ()
 void
 Session::mark_send_id (uint32_t id)
 {
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
 	if (id >= send_bitset.size()) {
 		send_bitset.resize (id+16, false);
 	}
@@ -5563,6 +5573,7 @@ Session::mark_send_id (uint32_t id)
 void
 Session::mark_aux_send_id (uint32_t id)
 {
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
 	if (id >= aux_send_bitset.size()) {
 		aux_send_bitset.resize (id+16, false);
 	}
@@ -5575,6 +5586,7 @@ Session::mark_aux_send_id (uint32_t id)
 void
 Session::mark_return_id (uint32_t id)
 {
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
 	if (id >= return_bitset.size()) {
 		return_bitset.resize (id+16, false);
 	}
@@ -5587,6 +5599,7 @@ Session::mark_return_id (uint32_t id)
 void
 Session::mark_insert_id (uint32_t id)
 {
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
 	if (id >= insert_bitset.size()) {
 		insert_bitset.resize (id+16, false);
 	}
@@ -5602,6 +5615,7 @@ Session::unmark_send_id (uint32_t id)
 	if (deletion_in_progress ()) {
 		return;
 	}
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
 	if (id < send_bitset.size()) {
 		send_bitset[id] = false;
 	}
@@ -5613,6 +5627,7 @@ Session::unmark_aux_send_id (uint32_t id)
 	if (deletion_in_progress ()) {
 		return;
 	}
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
 	if (id < aux_send_bitset.size()) {
 		aux_send_bitset[id] = false;
 	}
@@ -5624,6 +5639,7 @@ Session::unmark_return_id (uint32_t id)
 	if (deletion_in_progress ()) {
 		return;
 	}
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
 	if (id < return_bitset.size()) {
 		return_bitset[id] = false;
 	}
@@ -5635,6 +5651,7 @@ Session::unmark_insert_id (uint32_t id)
 	if (deletion_in_progress ()) {
 		return;
 	}
+	Glib::Threads::Mutex::Lock lm (bitset_lock);
 	if (id < insert_bitset.size()) {
 		insert_bitset[id] = false;
 	}
@@ -6184,6 +6201,7 @@ Session::plot_process_graph (std::string const& file_name) const {
 void
 Session::add_automation_list(AutomationList *al)
 {
+	Glib::Threads::Mutex::Lock lm (automation_lists_lock);
 	automation_lists[al->id()] = al;
 }
 
@@ -125,6 +125,7 @@ Session::memento_command_factory(XMLNode *n)
 
     } else if (type_name == "Evoral::Curve" || type_name == "ARDOUR::AutomationList") {
 	    if (have_id) {
+		    Glib::Threads::Mutex::Lock lm (automation_lists_lock);
 		    std::map<PBD::ID, AutomationList*>::iterator i = automation_lists.find(id);
 		    if (i != automation_lists.end()) {
 			    return new MementoCommand<AutomationList>(*i->second, before, after);
@@ -104,6 +104,7 @@
 #include "ardour/disk_reader.h"
 #include "ardour/filename_extensions.h"
 #include "ardour/graph.h"
+#include "ardour/io_tasklist.h"
 #include "ardour/location.h"
 #include "ardour/lv2_plugin.h"
 #include "ardour/midi_model.h"
@@ -831,6 +832,9 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		tree.set_root (&state (false, fork_state, only_used_assets));
 	}
 
+	/* templates and archives may be opened by other versions, keep them XML */
+	tree.set_binary (Config->get_binary_session_state () && !template_only && !for_archive);
+
 	if (snapshot_name.empty()) {
 		snapshot_name = _current_snapshot_name;
 	} else if (switch_to_snapshot) {
@@ -1521,7 +1525,7 @@ Session::maybe_copy_midifile (snapshot_t snapshot_type, boost::shared_ptr<Source
 	{
 		Source::WriterLock lm (ms->mutex());
 
-		if (!ms->model()) {
+		if (!ms->loaded_model()) {
 			ms->load_model (lm);
 		}
 	}
@@ -1567,6 +1571,14 @@ Session::get_control_protocol_state () const
 	return ControlProtocolManager::instance().get_state ();
 }
 
+void
+Session::load_phase_done (char const* name, PBD::microseconds_t& start)
+{
+	const PBD::microseconds_t now = PBD::get_microseconds ();
+	_load_phase_times.push_back (std::make_pair (std::string (name), now - start));
+	start = now;
+}
+
 int
 Session::set_state (const XMLNode& node, int version)
 {
@@ -1574,7 +1586,9 @@ Session::set_state (const XMLNode& node, int version)
 	XMLNodeList nlist;
 	XMLNode* child;
 	int ret = -1;
+	PBD::microseconds_t phase_start = PBD::get_microseconds ();
 
+	_load_phase_times.clear ();
 	_state_of_the_state = StateOfTheState (_state_of_the_state | CannotSave);
 
 	if (node.name() != X_("Session")) {
@@ -1676,6 +1690,8 @@ Session::set_state (const XMLNode& node, int version)
 		_speakers->set_state (*child, version);
 	}
 
+	load_phase_done (X_("config"), phase_start);
+
 	if ((child = find_named_node (node, "Sources")) == 0) {
 		error << _("Session: XML state has no sources section") << endmsg;
 		goto out;
@@ -1683,6 +1699,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (X_("sources"), phase_start);
+
 	if ((child = find_named_node (node, "Locations")) == 0) {
 		error << _("Session: XML state has no locations section") << endmsg;
 		goto out;
@@ -1696,6 +1714,8 @@ Session::set_state (const XMLNode& node, int version)
 		AudioFileSource::set_header_position_offset (_session_range_location->start().samples());
 	}
 
+	load_phase_done (X_("locations"), phase_start);
+
 	if ((child = find_named_node (node, "Regions")) == 0) {
 		error << _("Session: XML state has no Regions section") << endmsg;
 		goto out;
@@ -1703,6 +1723,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (X_("regions"), phase_start);
+
 	if ((child = find_named_node (node, "Playlists")) == 0) {
 		error << _("Session: XML state has no playlists section") << endmsg;
 		goto out;
@@ -1722,6 +1744,8 @@ Session::set_state (const XMLNode& node, int version)
 		}
 	}
 
+	load_phase_done (X_("playlists"), phase_start);
+
 	if (version >= 3000) {
 		if ((child = find_named_node (node, "Bundles")) == 0) {
 			warning << _("Session: XML state has no bundles section") << endmsg;
@@ -1801,6 +1825,8 @@ Session::set_state (const XMLNode& node, int version)
 		}
 	}
 
+	load_phase_done (X_("whole-file regions"), phase_start);
+
 	if ((child = find_named_node (node, "Routes")) == 0) {
 		error << _("Session: XML state has no routes section") << endmsg;
 		goto out;
@@ -1808,6 +1834,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (X_("routes"), phase_start);
+
 	/* Now that we Tracks have been loaded and playlists are assigned */
 	_playlists->update_tracking ();
 
@@ -1878,6 +1906,8 @@ Session::set_state (const XMLNode& node, int version)
 	update_route_record_state ();
 	sync_cues ();
 
+	load_phase_done (X_("groups, scripts, etc."), phase_start);
+
 	/* here beginneth the second phase ... */
 	set_snapshot_name (_current_snapshot_name);
 
@@ -1893,6 +1923,30 @@ out:
 	return ret;
 }
 
+/** @return true if a Route's state contains processors that must be
+ * instantiated by the thread that loads the session: plugins whose APIs
+ * expect to be used from the main thread, and port-inserts, which use
+ * transient insert IDs. LADSPA, LV2 and Lua plugins can be set up by any
+ * thread, Route::set_state() serializes the steps that use shared state.
+ */
+static bool
+processors_need_main_thread (XMLNode const& node)
+{
+	for (XMLNodeConstIterator i = node.children ().begin (); i != node.children ().end (); ++i) {
+		std::string type;
+		if ((*i)->name () == X_("Processor") && (*i)->get_property (X_("type"), type)) {
+			if (type == X_("windows-vst") || type == X_("mac-vst") || type == X_("lxvst") ||
+			    type == X_("vst3") || type == X_("audiounit") || type == X_("port")) {
+				return true;
+			}
+		}
+		if (processors_need_main_thread (**i)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 int
 Session::load_routes (const XMLNode& node, int version)
 {
@@ -1904,11 +1958,62 @@ Session::load_routes (const XMLNode& node, int version)
 
 	set_dirty();
 
-	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
+	/* Routes, and the plugins on them, are set up concurrently and added
+	 * in order below. Routes that must be loaded by this thread are created
+	 * there. A route that failed in a worker is not created again, an
+	 * exception is passed on as if it had been thrown by this thread.
+	 */
+	std::vector<boost::shared_ptr<Route> > loaded (nlist.size ());
+	std::vector<std::exception_ptr>        failed (nlist.size ());
+	std::vector<bool>                      concurrent (nlist.size (), false);
+
+	if (version >= 5000 && nlist.size () > 1) {
+		IOTaskList tasks (Config->get_session_load_threads ());
+
+		if (tasks.n_workers () > 0) {
+			/* tracks sharing a playlist are loaded one after another */
+			std::map<std::string, uint32_t> playlist_users;
+			for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
+				std::string pl;
+				if ((*niter)->get_property (X_("audio-playlist"), pl)) {
+					++playlist_users[pl];
+				}
+				if ((*niter)->get_property (X_("midi-playlist"), pl)) {
+					++playlist_users[pl];
+				}
+			}
+
+			uint32_t n = 0;
+			for (niter = nlist.begin(); niter != nlist.end(); ++niter, ++n) {
+				std::string pl;
+				if ((*niter)->get_property (X_("audio-playlist"), pl) && playlist_users[pl] > 1) {
+					continue;
+				}
+				if ((*niter)->get_property (X_("midi-playlist"), pl) && playlist_users[pl] > 1) {
+					continue;
+				}
+				if (processors_need_main_thread (**niter)) {
+					continue;
+				}
+				concurrent[n] = true;
+				tasks.push_back (boost::bind (&Session::load_route_task, this, *niter, version, &loaded[n], &failed[n]));
+			}
+
+			tasks.process ();
+		}
+	}
+
+	uint32_t n = 0;
+
+	for (niter = nlist.begin(); niter != nlist.end(); ++niter, ++n) {
 
 		boost::shared_ptr<Route> route;
 
-		if (version < 3000) {
+		if (failed[n]) {
+			std::rethrow_exception (failed[n]);
+		} else if (concurrent[n]) {
+			route = loaded[n];
+		} else if (version < 3000) {
 			route = XMLRouteFactory_2X (**niter, version);
 		} else if (version < 5000) {
 			route = XMLRouteFactory_3X (**niter, version);
@@ -1945,6 +2050,17 @@ Session::load_routes (const XMLNode& node, int version)
 	return 0;
 }
 
+void
+Session::load_route_task (const XMLNode* node, int version, boost::shared_ptr<Route>* route, std::exception_ptr* error)
+{
+	try {
+		*route = XMLRouteFactory (*node, version);
+	} catch (...) {
+		/* rethrown by load_routes() */
+		*error = std::current_exception ();
+	}
+}
+
 boost::shared_ptr<Route>
 Session::XMLRouteFactory (const XMLNode& node, int version)
 {
@@ -2474,7 +2590,42 @@ Session::load_sources (const XMLNode& node)
 	set_dirty();
 	std::map<std::string, std::string> relocation;
 
-	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
+	/* Opening files and reading their headers is mostly I/O bound, so
+	 * first create all Sources concurrently. They are announced in order
+	 * below; those that failed are created again by this thread, which
+	 * can then ask the user about missing or ambiguous files.
+	 */
+	std::vector<boost::shared_ptr<Source> > loaded (nlist.size ());
+
+	if (Stateful::loading_state_version >= 3000 && nlist.size () > 1) {
+		IOTaskList tasks (Config->get_session_load_threads ());
+
+		if (tasks.n_workers () > 0) {
+			uint32_t n = 0;
+			for (niter = nlist.begin(); niter != nlist.end(); ++niter, ++n) {
+				tasks.push_back (boost::bind (&Session::load_source_task, this, *niter, &loaded[n]));
+			}
+#ifdef PLATFORM_WINDOWS
+			int old_mode = SetErrorMode(SEM_FAILCRITICALERRORS);
+#endif
+			_loading_sources_concurrently = true;
+			tasks.process ();
+			_loading_sources_concurrently = false;
+#ifdef PLATFORM_WINDOWS
+			SetErrorMode(old_mode);
+#endif
+		}
+	}
+
+	uint32_t n = 0;
+
+	for (niter = nlist.begin(); niter != nlist.end(); ++niter, ++n) {
+
+		if (loaded[n]) {
+			SourceFactory::SourceCreated (loaded[n]);
+			continue;
+		}
+
 #ifdef PLATFORM_WINDOWS
 		int old_mode = 0;
 #endif
@@ -2598,6 +2749,21 @@ retry:
 	return 0;
 }
 
+void
+Session::load_source_task (const XMLNode* node, boost::shared_ptr<Source>* source)
+{
+	if (node->name() != "Source") {
+		return;
+	}
+
+	try {
+		/* announced by load_sources(), in order */
+		*source = SourceFactory::create (*this, *node, true, false);
+	} catch (...) {
+		/* retried by load_sources() */
+	}
+}
+
 boost::shared_ptr<Source>
 Session::XMLSourceFactory (const XMLNode& node)
 {
@@ -3960,6 +4126,7 @@ Session::save_history (string snapshot_name)
 	}
 
 	tree.set_root (&_history.get_state (Config->get_saved_history_depth()));
+	tree.set_binary (Config->get_binary_session_state ());
 
 	if (!tree.write (xml_path))
 	{
@@ -4680,6 +4847,66 @@ Session::get_info_from_path (const string& xmlpath, float& sample_rate, SampleFo
 		return -1;
 	}
 
+	if (XMLTree::is_binary (xmlpath)) {
+
+		/* binary state (see "binary-session-state"), there is no
+		 * libxml2 document to peek into, so read the whole tree.
+		 */
+
+		XMLTree tree;
+
+		if (!tree.read (xmlpath) || !tree.root ()) {
+			return -1;
+		}
+
+		XMLNode const & root (*tree.root ());
+
+		root.get_property ("version", version);
+		found_sr = root.get_property ("sample-rate", sample_rate);
+
+		if ((parse_stateful_loading_version(version) / 1000L) > (CURRENT_SESSION_FILE_VERSION / 1000L)) {
+			return -1;
+		}
+
+		XMLNode const * child;
+
+		if ((child = root.child ("ProgramVersion")) != 0 && child->get_property ("modified-with", program_version)) {
+			size_t sep = program_version.find_first_of("-");
+			if (sep != string::npos) {
+				program_version = program_version.substr (0, sep);
+			}
+		}
+
+		if (engine_hints && (child = root.child ("EngineHints")) != 0) {
+			std::string val;
+			if (child->get_property ("backend", val)) {
+				engine_hints->set_property ("backend", val);
+			}
+			if (child->get_property ("input-device", val)) {
+				engine_hints->set_property ("input-device", val);
+			}
+			if (child->get_property ("output-device", val)) {
+				engine_hints->set_property ("output-device", val);
+			}
+		}
+
+		if ((child = root.child ("Config")) != 0) {
+			for (XMLNodeConstIterator i = child->children().begin(); i != child->children().end(); ++i) {
+				std::string val;
+				if ((*i)->has_property_with_value ("name", "native-file-data-format") && (*i)->get_property ("value", val)) {
+					try {
+						SampleFormat fmt = (SampleFormat) string_2_enum (val, fmt);
+						data_format = fmt;
+						found_data_format = true;
+					} catch (PBD::unknown_enumeration& e) {}
+					break;
+				}
+			}
+		}
+
+		return (found_sr && found_data_format) ? 0 : 1;
+	}
+
 	xmlParserCtxtPtr ctxt = xmlNewParserCtxt();
 	if (ctxt == NULL) {
 		return -1;
@@ -42,15 +42,18 @@
 
 #include "evoral/Control.h"
 #include "evoral/SMF.h"
+#include "evoral/SMFIndex.h"
 
 #include "temporal/tempo.h"
 
 #include "ardour/debug.h"
+#include "ardour/filename_extensions.h"
 #include "ardour/midi_channel_filter.h"
 #include "ardour/midi_model.h"
 #include "ardour/midi_ring_buffer.h"
 #include "ardour/midi_state_tracker.h"
 #include "ardour/parameter_types.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 #include "ardour/smf_source.h"
 
@@ -69,6 +72,8 @@ SMFSource::SMFSource (Session& s, const string& path, Source::Flag flags)
 	, FileSource(s, DataType::MIDI, path, string(), flags)
 	, Evoral::SMF()
 	, _open (false)
+	, _index (0)
+	, _index_reader (0)
 	, _last_ev_time_samples(0)
 {
 	/* note that origin remains empty */
@@ -106,6 +111,8 @@ SMFSource::SMFSource (Session& s, const string& path)
 	, FileSource(s, DataType::MIDI, path, string(), Source::Flag (0))
 	, Evoral::SMF()
 	, _open (false)
+	, _index (0)
+	, _index_reader (0)
 	, _last_ev_time_samples(0)
 {
 	/* note that origin remains empty */
@@ -124,7 +131,7 @@ SMFSource::SMFSource (Session& s, const string& path)
 	_open = true;
 
 	/* no lock required since we do not actually exist yet */
-	load_model_unlocked (true);
+	load_or_defer_model_unlocked ();
 }
 
 /** Constructor used for existing internal-to-session files. */
@@ -133,6 +140,8 @@ SMFSource::SMFSource (Session& s, const XMLNode& node, bool must_exist)
 	, MidiSource(s, node)
 	, FileSource(s, node, must_exist)
 	, _open (false)
+	, _index (0)
+	, _index_reader (0)
 	, _last_ev_time_samples(0)
 {
 	if (set_state(node, Stateful::loading_state_version)) {
@@ -174,10 +183,15 @@ SMFSource::SMFSource (Session& s, const XMLNode& node, bool must_exist)
 	if (!(_flags & Source::Empty)) {
 		assert (Glib::file_test (_path, Glib::FILE_TEST_EXISTS));
 		existence_check ();
-		if (open (_path)) {
-			throw failed_constructor ();
+		/* libsmf loads all of the file, so with deferred model loading,
+		 * read it through an index of its events until the model is needed.
+		 */
+		if (!Config->get_defer_midi_model_loading () || open_index ()) {
+			if (open (_path)) {
+				throw failed_constructor ();
+			}
+			_open = true;
 		}
-		_open = true;
 	} else {
 		assert (_flags & Source::Writable);
 		if (open_for_write ()) {
@@ -187,7 +201,7 @@ SMFSource::SMFSource (Session& s, const XMLNode& node, bool must_exist)
 	}
 
 	/* no lock required since we do not actually exist yet */
-	load_model_unlocked (true);
+	load_or_defer_model_unlocked ();
 }
 
 SMFSource::~SMFSource ()
@@ -195,6 +209,8 @@ SMFSource::~SMFSource ()
 	if (removable()) {
 		::g_unlink (_path.c_str());
 	}
+
+	drop_index ();
 }
 
 int
@@ -207,6 +223,43 @@ SMFSource::open_for_write ()
 	return 0;
 }
 
+/** Index the events of the file, or load its index if that is up to date.
+ *  The index is kept in the peak file directory of the session.
+ *  @return 0 on success
+ */
+int
+SMFSource::open_index ()
+{
+	const string index_path = _session.construct_peak_filepath (_path, within_session ()) + midi_index_suffix;
+
+	Evoral::SMFIndex* index = new Evoral::SMFIndex;
+
+	if (index->load (index_path, _path)) {
+		if (index->build (_path)) {
+			delete index;
+			return -1;
+		}
+		if (index->save (index_path)) {
+			warning << string_compose (_("Cannot save index of MIDI file %1 as %2"), _path, index_path) << endmsg;
+		}
+	}
+
+	_index = index;
+	return 0;
+}
+
+/** Stop reading the file through its index, caller must hold the source's
+ *  lock for writing (or be the only user of the source).
+ */
+void
+SMFSource::drop_index ()
+{
+	delete _index_reader;
+	_index_reader = 0;
+	delete _index;
+	_index = 0;
+}
+
 void
 SMFSource::close ()
 {
@@ -217,103 +270,135 @@ SMFSource::close ()
 
 extern PBD::Timing minsert;
 
-timecnt_t
-SMFSource::read_unlocked (const ReaderLock&               lock,
-                          Evoral::EventSink<samplepos_t>& destination,
-                          timepos_t const &               source_start,
-                          timepos_t const &               start,
-                          timecnt_t const &               duration,
-                          Temporal::Range*                loop_range,
-                          MidiNoteTracker*                tracker,
-                          MidiChannelFilter*              filter) const
+/** Write the events that @a cursor reads from @a start_ticks on, and which
+ *  are in [session_source_start, end), to @a destination.
+ *  @param cursor the source itself (libsmf) or a reader of its index.
+ */
+template<typename Cursor> static void
+read_events (Cursor&                         cursor,
+             uint16_t                        ppqn,
+             uint64_t                        start_ticks,
+             Temporal::Beats const &         source_start_beats,
+             Temporal::Beats const &         session_source_start,
+             Temporal::Beats const &         end,
+             Evoral::EventSink<samplepos_t>& destination,
+             Temporal::Range*                loop_range,
+             MidiNoteTracker*                tracker,
+             MidiChannelFilter*              filter)
 {
 	int      ret  = 0;
-	timepos_t time; // in SMF ticks, 1 tick per _ppqn
-
-	if (writable() && !_open) {
-		/* nothing to read since nothing has ben written */
-		return timecnt_t();
-	}
-
-	DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked: start %1 duration %2\n", start, duration));
+	uint64_t time = 0; // in SMF ticks, 1 tick per _ppqn
 
 	// Output parameters for read_event (which will allocate scratch in buffer as needed)
 	uint32_t ev_delta_t = 0;
 	uint32_t ev_size    = 0;
 	uint8_t* ev_buffer  = 0;
 
-	size_t scratch_size = 0; // keep track of scratch to minimize reallocs
-
-	/* start of read in SMF ticks (which may differ from our own musical ticks */
-	const uint64_t start_ticks = llrint (start.beats().to_ticks() * (Temporal::Beats::PPQN / ppqn()));
+	uint32_t scratch_size = 0; // keep track of scratch to minimize reallocs
 
-	DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked: start in ticks %1\n", start_ticks));
-
-	if (_smf_last_read_end.is_zero() || start != _smf_last_read_end) {
-		DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked: seek to %1\n", start));
-		Evoral::SMF::seek_to_start();
-		while (time < start_ticks) {
-			Evoral::event_id_t ignored;
-
-			ret = read_event(&ev_delta_t, &ev_size, &ev_buffer, &ignored);
-			if (ret == -1) { // EOF
-				_smf_last_read_end = start + duration;
-				return timecnt_t();
-			}
-			time += timepos_t::from_ticks (ev_delta_t); // accumulate delta time
-		}
-	} else {
-		DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked: set time to %1\n", _smf_last_read_time));
-		time = _smf_last_read_time;
-	}
+	/* the events of libsmf are in memory and in time order, and the index
+	 * has the file position of every beat, so this does not read from the
+	 * start of the file.
+	 */
+	time = cursor.seek_to_time (start_ticks);
 
-	_smf_last_read_end = start + duration;
+	DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked: start in ticks %1, seek to %2\n", start_ticks, time));
 
 	while (true) {
 		Evoral::event_id_t ignored; /* XXX don't ignore note id's ??*/
 
-		ret = read_event(&ev_delta_t, &ev_size, &ev_buffer, &ignored);
+		ret = cursor.read_event(&ev_delta_t, &ev_size, &ev_buffer, &ignored);
 		if (ret == -1) { // EOF
 			break;
 		}
 
-		time += timepos_t::from_ticks (ev_delta_t); // accumulate delta time
-		_smf_last_read_time = time;
+		time += ev_delta_t; // accumulate delta time
 
 		if (ret == 0) { // meta-event (skipped, just accumulate time)
 			continue;
 		}
 
+		const uint32_t size = ev_size;
+
+		scratch_size = std::max (scratch_size, ev_size);
+		ev_size = scratch_size; // ensure read_event only allocates if necessary
+
 		DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked delta %1, time %2, buf[0] %3\n",
 								  ev_delta_t, time, ev_buffer[0]));
 
-		assert(time >= start_ticks);
+		/* Note that we add on the source start time here so that the
+		 * event time is in session time.
+		 */
+		const Temporal::Beats session_event_beats = source_start_beats + Temporal::Beats::ticks_at_rate (time, ppqn);
 
-		/* Note that we add on the source start time (in session samples) here so that ev_sample_time
-		   is in session samples.
-		*/
-		const samplepos_t ev_sample_time = (time + timepos_t (source_start.beats())).samples();
-		timepos_t est (ev_sample_time);
+		if (session_event_beats < session_source_start) {
+			/* event too early, from rounding start to SMF ticks or
+			 * from the start of the beat in the index
+			 */
+			continue;
+		}
+
+		if (session_event_beats >= end) {
+			break;
+		}
+
+		timepos_t   seb (session_event_beats);
+		samplepos_t time_samples = seb.samples();
 
 		if (loop_range) {
-			est = loop_range->squish (est);
+			time_samples = loop_range->squish (seb).samples();
 		}
 
-		if (est < start + duration) {
-			if (!filter || !filter->filter(ev_buffer, ev_size)) {
-				destination.write (est.samples(), Evoral::MIDI_EVENT, ev_size, ev_buffer);
-				if (tracker) {
-					tracker->track(ev_buffer);
-				}
+		if (!filter || !filter->filter(ev_buffer, size)) {
+			destination.write (time_samples, Evoral::MIDI_EVENT, size, ev_buffer);
+			if (tracker) {
+				tracker->track(ev_buffer);
 			}
-		} else {
-			break;
 		}
+	}
+
+	free (ev_buffer);
+}
 
-		if (ev_size > scratch_size) {
-			scratch_size = ev_size;
+timecnt_t
+SMFSource::read_unlocked (const ReaderLock&               lock,
+                          Evoral::EventSink<samplepos_t>& destination,
+                          timepos_t const &               source_start,
+                          timepos_t const &               start,
+                          timecnt_t const &               duration,
+                          Temporal::Range*                loop_range,
+                          MidiNoteTracker*                tracker,
+                          MidiChannelFilter*              filter) const
+{
+	if (!_index && writable() && !_open) {
+		/* nothing to read since nothing has ben written */
+		return timecnt_t();
+	}
+
+	DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF read_unlocked: start %1 duration %2\n", start, duration));
+
+	/* same range as MidiSource::midi_read() uses for the model */
+	const Temporal::Beats source_start_beats   = source_start.beats();
+	const Temporal::Beats end                  = source_start_beats + start.beats() + duration.beats();
+	const Temporal::Beats session_source_start = (source_start + start).beats();
+
+	/* start of read in SMF ticks (which may differ from our own musical ticks) */
+	const uint16_t file_ppqn   = _index ? _index->ppqn () : ppqn ();
+	const uint64_t start_ticks = (uint64_t) std::max<int64_t> (0, start.beats().to_ticks()) * file_ppqn / Temporal::Beats::PPQN;
+
+	/* the read position of libsmf, or of the index reader, is shared by
+	 * all readers, which only hold the source's lock for reading.
+	 */
+	Glib::Threads::Mutex::Lock cl (_read_cursor_lock);
+
+	if (_index) {
+		/* keep the file open for the next refill */
+		if (!_index_reader) {
+			_index_reader = new Evoral::SMFIndex::Reader (*_index, _path);
 		}
-		ev_size = scratch_size; // ensure read_event only allocates if necessary
+		read_events (*_index_reader, file_ppqn, start_ticks, source_start_beats, session_source_start, end, destination, loop_range, tracker, filter);
+	} else {
+		read_events (static_cast<Evoral::SMF const &> (*this), file_ppqn, start_ticks, source_start_beats, session_source_start, end, destination, loop_range, tracker, filter);
 	}
 
 	return duration;
@@ -553,6 +638,11 @@ SMFSource::set_state (const XMLNode& node, int version)
 void
 SMFSource::mark_streaming_midi_write_started (const WriterLock& lock, NoteMode mode)
 {
+	if (_index) {
+		/* the file is written anew, from what libsmf holds */
+		drop_index ();
+	}
+
 	if (!_open && open_for_write()) {
 		error << string_compose (_("cannot open MIDI file %1 for write"), _path) << endmsg;
 		/* XXX should probably throw or return something */
@@ -634,8 +724,8 @@ SMFSource::safe_midi_file_extension (const string& file)
 }
 
 static bool compare_eventlist (
-	const std::pair< const Evoral::Event<Temporal::Beats>*, gint >& a,
-	const std::pair< const Evoral::Event<Temporal::Beats>*, gint >& b) {
+	const std::pair< const Evoral::Event<Temporal::Beats>*, Evoral::event_id_t >& a,
+	const std::pair< const Evoral::Event<Temporal::Beats>*, Evoral::event_id_t >& b) {
 	return ( a.first->time() < b.first->time() );
 }
 
@@ -647,11 +737,51 @@ SMFSource::load_model (const WriterLock& lock, bool force_reload)
 	invalidate (lock);
 }
 
+void
+SMFSource::load_or_defer_model_unlocked ()
+{
+	if (Config->get_defer_midi_model_loading () && !(_flags & Source::Empty)) {
+		/* Only find the length and channel information now. Playback
+		 * and display read from the file, the model is loaded when it
+		 * is first asked for, usually to edit a region.
+		 */
+		if (_index) {
+			/* building the index has read the file already */
+			_used_channels    = _index->used_channels ();
+			_num_channels     = _used_channels.size ();
+			_n_note_on_events = _index->n_note_on_events ();
+			_has_pgm_change   = _index->has_pgm_change ();
+
+			if (!_index->is_empty ()) {
+				assert (!_length || (_length.time_domain() == Temporal::BeatTime));
+				_length = max (_length, timepos_t (Temporal::Beats::ticks_at_rate (_index->length_pulses (), _index->ppqn ())));
+			}
+		} else {
+			scan_unlocked (0);
+		}
+		g_atomic_int_set (&_model_deferred, 1);
+	} else {
+		load_model_unlocked (true);
+	}
+}
+
 void
 SMFSource::load_model_unlocked (bool force_reload)
 {
 	assert (!_writing);
 
+	if (_index) {
+		/* the model is made from the events that libsmf loads, which
+		 * is also what playback reads from now on.
+		 */
+		if (open (_path)) {
+			error << string_compose (_("cannot open MIDI file %1"), _path) << endmsg;
+		} else {
+			_open = true;
+		}
+		drop_index ();
+	}
+
 	if (!_model) {
 		_model = boost::shared_ptr<MidiModel> (new MidiModel (*this));
 	} else {
@@ -659,10 +789,41 @@ SMFSource::load_model_unlocked (bool force_reload)
 	}
 
 	_model->start_write();
+
+	LoadedEvents eventlist;
+
+	scan_unlocked (&eventlist);
+
+	eventlist.sort(compare_eventlist);
+
+	LoadedEvents::iterator it;
+	for (it=eventlist.begin(); it!=eventlist.end(); ++it) {
+		_model->append (*it->first, it->second);
+		delete it->first;
+	}
+
+        // cerr << "----SMF-SRC-----\n";
+        // _playback_buf->dump (cerr);
+        // cerr << "----------------\n";
+
+	_model->end_write (Evoral::Sequence<Temporal::Beats>::ResolveStuckNotes, _length.beats());
+	_model->set_edited (false);
+
+	/* only now, MidiSource::model () does not lock if this is unset */
+	g_atomic_int_set (&_model_deferred, 0);
+}
+
+/** Read all events of the file, to find its length and the channels used.
+ *  @param events if non-null, the events are added to this list.
+ */
+void
+SMFSource::scan_unlocked (LoadedEvents* events)
+{
+	Glib::Threads::Mutex::Lock cl (_read_cursor_lock);
+
 	Evoral::SMF::seek_to_start();
 
 	uint64_t time = 0; /* in SMF ticks */
-	Evoral::Event<Temporal::Beats> ev;
 
 	uint32_t scratch_size = 0; // keep track of scratch and minimize reallocs
 
@@ -678,9 +839,6 @@ SMFSource::load_model_unlocked (bool force_reload)
 	_has_pgm_change   = false;
 	_used_channels.reset ();
 
-	// TODO simplify event allocation
-	std::list< std::pair< Evoral::Event<Temporal::Beats>*, gint > > eventlist;
-
 	for (unsigned i = 1; i <= num_tracks(); ++i) {
 		if (seek_to_track(i)) continue;
 
@@ -736,11 +894,13 @@ SMFSource::load_model_unlocked (bool force_reload)
 							delta_t, time, size, ss, event_id, name()));
 #endif
 
-				eventlist.push_back(make_pair (
-							new Evoral::Event<Temporal::Beats> (
-								Evoral::MIDI_EVENT, event_time,
-								size, buf, true)
-							, event_id));
+				if (events) {
+					events->push_back(make_pair (
+								new Evoral::Event<Temporal::Beats> (
+									Evoral::MIDI_EVENT, event_time,
+									size, buf, true)
+								, event_id));
+				}
 
 				// Set size to max capacity to minimize allocs in read_event
 				scratch_size = std::max(size, scratch_size);
@@ -757,28 +917,119 @@ SMFSource::load_model_unlocked (bool force_reload)
 
 	_num_channels = _used_channels.size();
 
-	eventlist.sort(compare_eventlist);
+	free (buf);
+}
 
-	std::list< std::pair< Evoral::Event<Temporal::Beats>*, gint > >::iterator it;
-	for (it=eventlist.begin(); it!=eventlist.end(); ++it) {
-		_model->append (*it->first, it->second);
-		delete it->first;
+Evoral::SMF::UsedChannels
+SMFSource::used_midi_channels()
+{
+	return _used_channels;
+}
+
+/** Read the notes of the file through its index, which is only there until
+ *  the model is loaded. Notes that are still on at the end of the file end
+ *  with the source.
+ */
+bool
+SMFSource::read_notes (Evoral::Sequence<Temporal::Beats>::Notes& notes) const
+{
+	typedef Evoral::Sequence<Temporal::Beats>::NotePtr NotePtr;
+
+	ReaderLock lm (_lock);
+
+	if (!_index) {
+		return false;
 	}
 
-        // cerr << "----SMF-SRC-----\n";
-        // _playback_buf->dump (cerr);
-        // cerr << "----------------\n";
+	Evoral::SMFIndex::Reader reader (*_index, _path);
 
-	_model->end_write (Evoral::Sequence<Temporal::Beats>::ResolveStuckNotes, _length.beats());
-	_model->set_edited (false);
+	const uint16_t file_ppqn = _index->ppqn ();
+
+	NotePtr active[16][128];
+
+	uint64_t time         = 0; /* in SMF ticks */
+	uint32_t scratch_size = 0;
+	uint32_t delta_t      = 0;
+	uint32_t size         = 0;
+	uint8_t* buf          = NULL;
+	int ret;
+	Evoral::event_id_t event_id;
+	bool have_event_id = false;
+
+	while ((ret = reader.read_event (&delta_t, &size, &buf, &event_id)) >= 0) {
+
+		time += delta_t;
+
+		if (ret == 0) {
+			/* meta-event : did we get an event ID ?  */
+			if (event_id >= 0) {
+				have_event_id = true;
+			}
+			continue;
+		}
+
+		const uint8_t type = buf[0] & 0xf0;
+		const uint8_t chan = buf[0] & 0x0f;
+
+		if (type == MIDI_CMD_NOTE_ON || type == MIDI_CMD_NOTE_OFF) {
+
+			const Temporal::Beats event_time = Temporal::Beats::ticks_at_rate (time, file_ppqn);
+			NotePtr& note (active[chan][buf[1]]);
+
+			if (note) {
+				/* a note off, or the same note again, ends the note */
+				note->set_length (event_time - note->time());
+				if (type == MIDI_CMD_NOTE_OFF) {
+					note->set_off_velocity (buf[2]);
+				}
+				notes.insert (note);
+				note.reset ();
+			}
+
+			if (type == MIDI_CMD_NOTE_ON) {
+				note = Evoral::Sequence<Temporal::Beats>::new_note (chan, event_time, Temporal::Beats(), buf[1], buf[2]);
+				note->set_id (have_event_id ? event_id : Evoral::next_event_id());
+			}
+		}
+
+		// Set size to max capacity to minimize allocs in read_event
+		scratch_size = std::max(size, scratch_size);
+		size = scratch_size;
+
+		/* event ID's must immediately precede the event they are for */
+		have_event_id = false;
+	}
+
+	const Temporal::Beats end = _length.beats();
+
+	for (uint8_t chan = 0; chan < 16; ++chan) {
+		for (uint8_t n = 0; n < 128; ++n) {
+			NotePtr& note (active[chan][n]);
+			if (note) {
+				note->set_length (std::max (Temporal::Beats(), end - note->time()));
+				notes.insert (note);
+			}
+		}
+	}
 
 	free (buf);
+
+	return true;
 }
 
-Evoral::SMF::UsedChannels
-SMFSource::used_midi_channels()
+bool
+SMFSource::note_range (uint8_t& lowest, uint8_t& highest) const
 {
-	return _used_channels;
+	ReaderLock lm (_lock);
+
+	if (!_index) {
+		return false;
+	}
+
+	lowest  = _index->lowest_note ();
+	highest = _index->highest_note ();
+
+	return true;
 }
 
 void
@@ -792,7 +1043,10 @@ SMFSource::destroy_model (const WriterLock& lock)
 void
 SMFSource::flush_midi (const WriterLock& lock)
 {
-	if (!writable() || _length.is_zero()) {
+	if (!writable() || _length.is_zero() || _index) {
+		/* nothing to write: the file is unchanged while it is read
+		 * through its index.
+		 */
 		return;
 	}
 
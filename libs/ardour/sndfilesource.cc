@@ -31,6 +31,9 @@
 #include <climits>
 #include <cstdarg>
 #include <fcntl.h>
+#ifndef PLATFORM_WINDOWS
+#include <sys/mman.h>
+#endif
 
 #include <sys/stat.h>
 
@@ -41,6 +44,8 @@
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
+#include "ardour/debug.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
@@ -64,7 +69,12 @@ SndFileSource::SndFileSource (Session& s, const XMLNode& node)
 	: Source(s, node)
 	, AudioFileSource (s, node)
 	, _sndfile (0)
+	, _fd (-1)
 	, _broadcast_info (0)
+	, _map (0)
+	, _map_length (0)
+	, _map_offset (0)
+	, _map_frame_size (0)
 {
 	init_sndfile ();
 
@@ -84,7 +94,12 @@ SndFileSource::SndFileSource (Session& s, const string& path, int chn, Flag flag
           /* note that the origin of an external file is itself */
 	, AudioFileSource (s, path, Flag (flags & ~(Writable|Removable|RemovableIfEmpty|RemoveAtDestroy)))
 	, _sndfile (0)
+	, _fd (-1)
 	, _broadcast_info (0)
+	, _map (0)
+	, _map_length (0)
+	, _map_offset (0)
+	, _map_frame_size (0)
 {
 	_channel = chn;
 
@@ -106,7 +121,12 @@ SndFileSource::SndFileSource (Session& s, const string& path, const string& orig
 	: Source(s, DataType::AUDIO, path, flags)
 	, AudioFileSource (s, path, origin, flags, sfmt, hf)
 	, _sndfile (0)
+	, _fd (-1)
 	, _broadcast_info (0)
+	, _map (0)
+	, _map_length (0)
+	, _map_offset (0)
+	, _map_frame_size (0)
 {
 	int fmt = 0;
 
@@ -207,7 +227,12 @@ SndFileSource::SndFileSource (Session& s, const string& path, int chn)
 	  /* the final boolean argument is not used, its value is irrelevant. see audiofilesource.h for explanation */
 	, AudioFileSource (s, path, Flag (0))
 	, _sndfile (0)
+	, _fd (-1)
 	, _broadcast_info (0)
+	, _map (0)
+	, _map_length (0)
+	, _map_offset (0)
+	, _map_frame_size (0)
 {
 	_channel = chn;
 
@@ -226,7 +251,12 @@ SndFileSource::SndFileSource (Session& s, const AudioFileSource& other, const st
 	: Source(s, DataType::AUDIO, path, Flag ((other.flags () | default_writable_flags | NoPeakFile) & ~RF64_RIFF))
 	, AudioFileSource (s, path, "", Flag ((other.flags () | default_writable_flags | NoPeakFile) & ~RF64_RIFF), /*unused*/ FormatFloat, /*unused*/ WAVE64)
 	, _sndfile (0)
+	, _fd (-1)
 	, _broadcast_info (0)
+	, _map (0)
+	, _map_length (0)
+	, _map_offset (0)
+	, _map_frame_size (0)
 {
 	if (other.readable_length_samples () == 0) {
 		throw failed_constructor();
@@ -330,8 +360,10 @@ void
 SndFileSource::close ()
 {
 	if (_sndfile) {
+		release_mapping ();
 		sf_close (_sndfile);
 		_sndfile = 0;
+		_fd = -1;
 		file_closed ();
 	}
 }
@@ -372,12 +404,15 @@ SndFileSource::open ()
 		return -1;
 	}
 
+	_fd = fd;
+
 	if (_channel >= _info.channels) {
 #ifndef HAVE_COREAUDIO
 		error << string_compose(_("SndFileSource: file only contains %1 channels; %2 is invalid as a channel number"), _info.channels, _channel) << endmsg;
 #endif
 		sf_close (_sndfile);
 		_sndfile = 0;
+		_fd = -1;
 		return -1;
 	}
 
@@ -414,6 +449,10 @@ SndFileSource::open ()
 		}
 	}
 #endif
+	if (!writable () && Config->get_mmap_audio_files ()) {
+		setup_mapping ();
+	}
+
 	if (!_broadcast_info) {
 		_broadcast_info = new BroadcastInfo;
 	}
@@ -500,6 +539,8 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
                 return cnt;
         }
 
+	Glib::Threads::Mutex::Lock lm (_read_lock);
+
         if (const_cast<SndFileSource*>(this)->open()) {
 		error << string_compose (_("could not open file %1 for reading."), _path) << endmsg;
 		return 0;
@@ -531,6 +572,14 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 		memset (dst+file_cnt, 0, sizeof (Sample) * delta);
 	}
 
+	if (file_cnt && _map) {
+		read_mapped (dst, start, file_cnt);
+		if (_gain != 1.f) {
+			apply_gain_to_buffer (dst, file_cnt, _gain);
+		}
+		return file_cnt;
+	}
+
 	if (file_cnt) {
 
 		if (sf_seek (_sndfile, (sf_count_t) start, SEEK_SET|SFM_READ) != (sf_count_t) start) {
@@ -581,6 +630,223 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 	return nread;
 }
 
+/** @return size of one frame in bytes for files which store uncompressed
+ * linear PCM or float data, 0 otherwise.
+ */
+static size_t
+linear_frame_size (SF_INFO const& info)
+{
+	switch (info.format & SF_FORMAT_TYPEMASK) {
+	case SF_FORMAT_FLAC:
+	case SF_FORMAT_OGG:
+		return 0;
+	default:
+		break;
+	}
+
+	switch (info.format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_PCM_S8:
+	case SF_FORMAT_PCM_U8:
+		return info.channels;
+	case SF_FORMAT_PCM_16:
+		return 2 * info.channels;
+	case SF_FORMAT_PCM_24:
+		return 3 * info.channels;
+	case SF_FORMAT_PCM_32:
+	case SF_FORMAT_FLOAT:
+		return 4 * info.channels;
+	case SF_FORMAT_DOUBLE:
+		return 8 * info.channels;
+	default:
+		return 0;
+	}
+}
+
+/** Map the file into memory, if its sample data can be converted
+ * directly (uncompressed, little-endian, 16/24/32 bit integer or float).
+ * read_unlocked() then bypasses libsndfile.
+ */
+void
+SndFileSource::setup_mapping ()
+{
+#if !defined PLATFORM_WINDOWS && G_BYTE_ORDER == G_LITTLE_ENDIAN
+	assert (!_map);
+
+	switch (_info.format & SF_FORMAT_TYPEMASK) {
+	case SF_FORMAT_WAV:
+	case SF_FORMAT_WAVEX:
+	case SF_FORMAT_W64:
+	case SF_FORMAT_RF64:
+		break;
+	default:
+		return;
+	}
+
+	switch (_info.format & SF_FORMAT_ENDMASK) {
+	case SF_ENDIAN_FILE:
+	case SF_ENDIAN_LITTLE:
+		break;
+	default:
+		return;
+	}
+
+	switch (_info.format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_PCM_16:
+	case SF_FORMAT_PCM_24:
+	case SF_FORMAT_PCM_32:
+	case SF_FORMAT_FLOAT:
+		break;
+	default:
+		return;
+	}
+
+	const size_t frame_size = linear_frame_size (_info);
+
+	if (frame_size == 0 || _fd < 0 || _info.frames <= 0) {
+		return;
+	}
+
+	/* libsndfile does not tell us where the sample data starts, but
+	 * seeking to the first sample positions the file descriptor there.
+	 */
+	if (sf_seek (_sndfile, 0, SEEK_SET) != 0) {
+		return;
+	}
+
+	off_t const data_offset = lseek (_fd, 0, SEEK_CUR);
+
+	struct stat statbuf;
+
+	if (data_offset <= 0 || fstat (_fd, &statbuf) != 0) {
+		return;
+	}
+
+	if ((off_t) (data_offset + _info.frames * frame_size) > statbuf.st_size) {
+		return;
+	}
+
+	void* addr = mmap (0, statbuf.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+
+	if (addr == MAP_FAILED) {
+		DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("SndFileSource: cannot map %1, using libsndfile\n", _path));
+		return;
+	}
+
+	_map            = (char*) addr;
+	_map_length     = statbuf.st_size;
+	_map_offset     = data_offset;
+	_map_frame_size = frame_size;
+#endif
+}
+
+void
+SndFileSource::release_mapping ()
+{
+#ifndef PLATFORM_WINDOWS
+	if (_map) {
+		munmap (_map, _map_length);
+	}
+#endif
+	_map            = 0;
+	_map_length     = 0;
+	_map_offset     = 0;
+	_map_frame_size = 0;
+}
+
+/** Convert @p cnt samples of our channel, starting at @p start, from the
+ * mapped file. The range must be within the file. Integer formats are
+ * normalized in the same way as libsndfile does, so the result is identical
+ * to sf_read_float().
+ */
+void
+SndFileSource::read_mapped (Sample* dst, samplepos_t start, samplecnt_t cnt) const
+{
+	const size_t    stride = _map_frame_size;
+	const char*     src    = _map + _map_offset + start * stride;
+
+	switch (_info.format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_FLOAT:
+		src += _channel * sizeof (float);
+		if (_info.channels == 1) {
+			memcpy (dst, src, cnt * sizeof (float));
+		} else {
+			for (samplecnt_t n = 0; n < cnt; ++n, src += stride) {
+				memcpy (&dst[n], src, sizeof (float));
+			}
+		}
+		break;
+
+	case SF_FORMAT_PCM_16:
+		src += _channel * sizeof (int16_t);
+		for (samplecnt_t n = 0; n < cnt; ++n, src += stride) {
+			int16_t v;
+			memcpy (&v, src, sizeof (int16_t));
+			dst[n] = (float) v * (1.f / 32768.f);
+		}
+		break;
+
+	case SF_FORMAT_PCM_24:
+		src += _channel * 3;
+		for (samplecnt_t n = 0; n < cnt; ++n, src += stride) {
+			const unsigned char* b = (const unsigned char*) src;
+			int32_t v = (int32_t) (((uint32_t) b[0] << 8) | ((uint32_t) b[1] << 16) | ((uint32_t) b[2] << 24));
+			dst[n] = (float) v * (1.f / 2147483648.f);
+		}
+		break;
+
+	case SF_FORMAT_PCM_32:
+		src += _channel * sizeof (int32_t);
+		for (samplecnt_t n = 0; n < cnt; ++n, src += stride) {
+			int32_t v;
+			memcpy (&v, src, sizeof (int32_t));
+			dst[n] = (float) v * (1.f / 2147483648.f);
+		}
+		break;
+
+	default:
+		assert (0);
+		memset (dst, 0, sizeof (Sample) * cnt);
+		break;
+	}
+}
+
+void
+SndFileSource::prefetch (samplepos_t start, samplecnt_t cnt) const
+{
+#ifdef POSIX_FADV_WILLNEED
+	/* this is only a hint, never wait for a concurrent read */
+	Glib::Threads::Mutex::Lock lm (_read_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked () || (writable () && !_sndfile)) {
+		return;
+	}
+
+	if (const_cast<SndFileSource*>(this)->open ()) {
+		return;
+	}
+
+	const size_t frame_size = linear_frame_size (_info);
+
+	if (frame_size == 0) {
+		/* compressed data, libsndfile does its own buffering */
+		return;
+	}
+
+	if (_fd < 0 || start >= _length.samples ()) {
+		return;
+	}
+
+	cnt = min (cnt, _length.samples () - start);
+
+	/* the offset of the data chunk is not known, it is usually
+	 * small compared to the range, so just extend the range.
+	 */
+	off_t const header_slack = 65536;
+
+	posix_fadvise (_fd, (off_t) start * frame_size, (off_t) cnt * frame_size + header_slack, POSIX_FADV_WILLNEED);
+#endif
+}
+
 samplecnt_t
 SndFileSource::write_unlocked (Sample *data, samplecnt_t cnt)
 {
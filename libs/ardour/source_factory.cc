@@ -25,6 +25,7 @@
 #endif
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/error.h"
 
 #include "ardour/audio_playlist_source.h"
@@ -115,7 +116,12 @@ SourceFactory::init ()
 		return;
 	}
 	peak_thread_run = true;
-	for (int n = 0; n < 2; ++n) {
+	/* building peaks is mostly limited by disk I/O, but with many
+	 * sources (import of a sample library, sessions without peaks)
+	 * using all cores still helps.
+	 */
+	const uint32_t n_threads = std::max<uint32_t> (2, hardware_concurrency ());
+	for (uint32_t n = 0; n < n_threads; ++n) {
 		peak_thread_pool.push_back (PBD::Thread::create (&peak_thread_work));
 	}
 }
@@ -133,6 +139,22 @@ SourceFactory::terminate ()
 	}
 }
 
+void
+SourceFactory::prioritize_peakfile (AudioSource const* as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+
+	for (std::list<boost::weak_ptr<AudioSource>>::iterator i = files_with_peaks.begin (); i != files_with_peaks.end (); ++i) {
+		boost::shared_ptr<AudioSource> s (i->lock ());
+		if (s.get () == as) {
+			if (i != files_with_peaks.begin ()) {
+				files_with_peaks.splice (files_with_peaks.begin (), files_with_peaks, i);
+			}
+			return;
+		}
+	}
+}
+
 int
 SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 {
@@ -168,7 +190,7 @@ SourceFactory::createSilent (Session& s, const XMLNode& node, samplecnt_t nframe
 }
 
 boost::shared_ptr<Source>
-SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
+SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks, bool announce)
 {
 	DataType           type = DataType::AUDIO;
 	XMLProperty const* prop = node.property ("type");
@@ -190,7 +212,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 
 				ap->check_for_analysis_data_on_disk ();
 
-				SourceCreated (ap);
+				if (announce) {
+					SourceCreated (ap);
+				}
 				return ap;
 
 			} catch (failed_constructor&) {
@@ -206,7 +230,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 					throw failed_constructor ();
 				}
 				ret->check_for_analysis_data_on_disk ();
-				SourceCreated (ret);
+				if (announce) {
+					SourceCreated (ret);
+				}
 				return ret;
 			} catch (failed_constructor& err) {
 			}
@@ -222,7 +248,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 				}
 
 				ret->check_for_analysis_data_on_disk ();
-				SourceCreated (ret);
+				if (announce) {
+					SourceCreated (ret);
+				}
 				return ret;
 			} catch (...) {
 			}
@@ -236,7 +264,9 @@ SourceFactory::create (Session& s, const XMLNode& node, bool defer_peaks)
 			boost::shared_ptr<SMFSource> src (new SMFSource (s, node));
 			BOOST_MARK_SOURCE (src);
 			src->check_for_analysis_data_on_disk ();
-			SourceCreated (src);
+			if (announce) {
+				SourceCreated (src);
+			}
 			return src;
 		} catch (...) {
 		}
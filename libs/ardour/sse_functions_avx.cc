@@ -20,6 +20,8 @@
 #include <immintrin.h>
 #include <stdint.h>
 
+#include "ardour/types.h"
+
 
 void
 x86_sse_avx_find_peaks(const float* buf, uint32_t nframes, float *min, float *max)
@@ -115,3 +117,72 @@ x86_sse_avx_find_peaks(const float* buf, uint32_t nframes, float *min, float *ma
 }
 
 
+
+static inline float
+avx_hmin (__m256 v)
+{
+	__m128 x = _mm_min_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	x = _mm_min_ps (x, _mm_movehl_ps (x, x));
+	x = _mm_min_ss (x, _mm_shuffle_ps (x, x, _MM_SHUFFLE (1, 1, 1, 1)));
+	return _mm_cvtss_f32 (x);
+}
+
+static inline float
+avx_hmax (__m256 v)
+{
+	__m128 x = _mm_max_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+	x = _mm_max_ps (x, _mm_movehl_ps (x, x));
+	x = _mm_max_ss (x, _mm_shuffle_ps (x, x, _MM_SHUFFLE (1, 1, 1, 1)));
+	return _mm_cvtss_f32 (x);
+}
+
+/* Each peak is computed from overlapping unaligned loads: the first
+ * and last eight samples of the peak plus all whole vectors in between.
+ * Since min/max do not care about duplicates, no scalar tail is needed.
+ */
+void
+x86_sse_avx_reduce_peaks (const float* src, uint32_t nframes, uint32_t fpp, ARDOUR::PeakData* peaks)
+{
+	while (nframes > 0) {
+		const uint32_t n = fpp < nframes ? fpp : nframes;
+
+		if (n < 8) {
+			float a = src[0];
+			float b = src[0];
+			for (uint32_t i = 1; i < n; ++i) {
+				a = src[i] > a ? src[i] : a;
+				b = src[i] < b ? src[i] : b;
+			}
+			peaks->max = a;
+			peaks->min = b;
+		} else {
+			__m256 vmin0 = _mm256_loadu_ps (src);
+			__m256 vmax0 = vmin0;
+			__m256 vmin1 = _mm256_loadu_ps (src + n - 8);
+			__m256 vmax1 = vmin1;
+			uint32_t i   = 8;
+
+			for (; i + 16 <= n; i += 16) {
+				__m256 x0 = _mm256_loadu_ps (src + i);
+				__m256 x1 = _mm256_loadu_ps (src + i + 8);
+				vmin0 = _mm256_min_ps (vmin0, x0);
+				vmax0 = _mm256_max_ps (vmax0, x0);
+				vmin1 = _mm256_min_ps (vmin1, x1);
+				vmax1 = _mm256_max_ps (vmax1, x1);
+			}
+
+			if (i + 8 <= n) {
+				__m256 x0 = _mm256_loadu_ps (src + i);
+				vmin0 = _mm256_min_ps (vmin0, x0);
+				vmax0 = _mm256_max_ps (vmax0, x0);
+			}
+
+			peaks->max = avx_hmax (_mm256_max_ps (vmax0, vmax1));
+			peaks->min = avx_hmin (_mm256_min_ps (vmin0, vmin1));
+		}
+
+		++peaks;
+		src += n;
+		nframes -= n;
+	}
+}
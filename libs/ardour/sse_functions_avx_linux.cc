@@ -780,6 +780,65 @@ x86_sse_avx_mix_buffers_no_gain_aligned(float *dst, const float *src, uint32_t n
 	} while (0);
 }
 
+/**
+ * @brief x86-64 AVX optimized routine to reduce a buffer to peaks
+ *
+ * Each peak is computed from overlapping unaligned loads: the first and
+ * last eight samples of the peak plus all whole vectors in between, so no
+ * scalar tail is needed.
+ *
+ * @param[in] src Pointer to source buffer
+ * @param nframes Number of samples to process
+ * @param fpp Number of samples per peak
+ * @param[out] peaks Pointer to ceil (nframes / fpp) peaks
+ */
+void
+x86_sse_avx_reduce_peaks(const float *src, uint32_t nframes, uint32_t fpp, ARDOUR::PeakData *peaks)
+{
+	while (nframes > 0) {
+		const uint32_t n = fpp < nframes ? fpp : nframes;
+
+		if (n < 8) {
+			float a = src[0];
+			float b = src[0];
+			for (uint32_t i = 1; i < n; ++i) {
+				a = src[i] > a ? src[i] : a;
+				b = src[i] < b ? src[i] : b;
+			}
+			peaks->max = a;
+			peaks->min = b;
+		} else {
+			__m256 vmin0 = _mm256_loadu_ps(src);
+			__m256 vmax0 = vmin0;
+			__m256 vmin1 = _mm256_loadu_ps(src + n - 8);
+			__m256 vmax1 = vmin1;
+			uint32_t i = 8;
+
+			for (; i + 16 <= n; i += 16) {
+				__m256 x0 = _mm256_loadu_ps(src + i);
+				__m256 x1 = _mm256_loadu_ps(src + i + 8);
+				vmin0 = _mm256_min_ps(vmin0, x0);
+				vmax0 = _mm256_max_ps(vmax0, x0);
+				vmin1 = _mm256_min_ps(vmin1, x1);
+				vmax1 = _mm256_max_ps(vmax1, x1);
+			}
+
+			if (i + 8 <= n) {
+				__m256 x0 = _mm256_loadu_ps(src + i);
+				vmin0 = _mm256_min_ps(vmin0, x0);
+				vmax0 = _mm256_max_ps(vmax0, x0);
+			}
+
+			peaks->max = _mm256_cvtss_f32(avx_getmax_ps(_mm256_max_ps(vmax0, vmax1)));
+			peaks->min = _mm256_cvtss_f32(avx_getmin_ps(_mm256_min_ps(vmin0, vmin1)));
+		}
+
+		++peaks;
+		src += n;
+		nframes -= n;
+	}
+}
+
 /**
  * @brief Get the maximum value of packed float register
  * @param vmax Packed float 8x register
@@ -116,3 +116,106 @@ x86_sse_find_peaks(const ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float *
 
 
 
+
+/* The ramp g[i+1] = g[i] + coeff * (target - g[i]) is a one-pole lowpass,
+ * in closed form g[i] = target + (initial - target) * (1 - coeff)^i.
+ * This allows to compute 4 consecutive gain values at a time.
+ */
+float
+x86_sse_apply_gain_ramp (float* dst, const float* src, uint32_t nframes, float initial, float target, float coeff)
+{
+	const float r = 1.f - coeff;
+	float       d = initial - target;
+
+	if (nframes >= 4) {
+		const float r2 = r * r;
+		const __m128 vt  = _mm_set1_ps (target);
+		const __m128 vr4 = _mm_set1_ps (r2 * r2);
+		__m128       vd  = _mm_mul_ps (_mm_set1_ps (d), _mm_setr_ps (1.f, r, r2, r2 * r));
+
+		while (nframes >= 4) {
+			_mm_storeu_ps (dst, _mm_mul_ps (_mm_loadu_ps (src), _mm_add_ps (vt, vd)));
+			vd = _mm_mul_ps (vd, vr4);
+			src += 4;
+			dst += 4;
+			nframes -= 4;
+		}
+
+		d = _mm_cvtss_f32 (vd);
+	}
+
+	while (nframes > 0) {
+		*dst++ = *src++ * (target + d);
+		d *= r;
+		--nframes;
+	}
+
+	return target + d;
+}
+
+static inline float
+sse_hmin (__m128 v)
+{
+	v = _mm_min_ps (v, _mm_movehl_ps (v, v));
+	v = _mm_min_ss (v, _mm_shuffle_ps (v, v, _MM_SHUFFLE (1, 1, 1, 1)));
+	return _mm_cvtss_f32 (v);
+}
+
+static inline float
+sse_hmax (__m128 v)
+{
+	v = _mm_max_ps (v, _mm_movehl_ps (v, v));
+	v = _mm_max_ss (v, _mm_shuffle_ps (v, v, _MM_SHUFFLE (1, 1, 1, 1)));
+	return _mm_cvtss_f32 (v);
+}
+
+/* Each peak is computed from overlapping unaligned loads: the first
+ * and last four samples of the peak plus all whole vectors in between.
+ * Since min/max do not care about duplicates, no scalar tail is needed.
+ */
+void
+x86_sse_reduce_peaks (const float* src, uint32_t nframes, uint32_t fpp, ARDOUR::PeakData* peaks)
+{
+	while (nframes > 0) {
+		const uint32_t n = fpp < nframes ? fpp : nframes;
+
+		if (n < 4) {
+			float a = src[0];
+			float b = src[0];
+			for (uint32_t i = 1; i < n; ++i) {
+				a = src[i] > a ? src[i] : a;
+				b = src[i] < b ? src[i] : b;
+			}
+			peaks->max = a;
+			peaks->min = b;
+		} else {
+			__m128 vmin0 = _mm_loadu_ps (src);
+			__m128 vmax0 = vmin0;
+			__m128 vmin1 = _mm_loadu_ps (src + n - 4);
+			__m128 vmax1 = vmin1;
+			uint32_t i   = 4;
+
+			for (; i + 8 <= n; i += 8) {
+				__m128 x0 = _mm_loadu_ps (src + i);
+				__m128 x1 = _mm_loadu_ps (src + i + 4);
+				vmin0 = _mm_min_ps (vmin0, x0);
+				vmax0 = _mm_max_ps (vmax0, x0);
+				vmin1 = _mm_min_ps (vmin1, x1);
+				vmax1 = _mm_max_ps (vmax1, x1);
+			}
+
+			if (i + 4 <= n) {
+				__m128 x0 = _mm_loadu_ps (src + i);
+				vmin0 = _mm_min_ps (vmin0, x0);
+				vmax0 = _mm_max_ps (vmax0, x0);
+			}
+
+			peaks->max = sse_hmax (_mm_max_ps (vmax0, vmax1));
+			peaks->min = sse_hmin (_mm_min_ps (vmin0, vmin1));
+		}
+
+		++peaks;
+		src += n;
+		nframes -= n;
+	}
+}
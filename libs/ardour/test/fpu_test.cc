@@ -99,6 +99,34 @@ FPUTest::compare (std::string msg, size_t cnt, float max_diff)
 
 #if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
 
+void
+FPUTest::avx512fTest ()
+{
+#ifdef FPU_AVX512F_SUPPORT
+	PBD::FPU* fpu = PBD::FPU::instance ();
+	if (!fpu->has_avx512f ()) {
+		printf ("AVX-512 is not available at run-time\n");
+		return;
+	}
+
+	size_t align_max = 64;
+	CPPUNIT_ASSERT_MESSAGE ("Aligned Malloc", (((intptr_t)_test1) % align_max) == 0);
+	CPPUNIT_ASSERT_MESSAGE ("Aligned Malloc", (((intptr_t)_test2) % align_max) == 0);
+
+	compute_peak          = x86_avx512f_compute_peak;
+	find_peaks            = x86_avx512f_find_peaks;
+	apply_gain_to_buffer  = x86_avx512f_apply_gain_to_buffer;
+	mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
+	mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
+	copy_vector           = x86_avx512f_copy_vector;
+
+	/* built without FP contraction (no FMA), results must be bit-exact */
+	run (align_max);
+#else
+	printf ("AVX-512 is disabled at compile-time\n");
+#endif
+}
+
 void
 FPUTest::avxFmaTest ()
 {
@@ -2,14 +2,20 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 
 #include <glib.h>
+#include <glibmm/miscutils.h>
 
 #include "pbd/failed_constructor.h"
+#include "pbd/gstdio_compat.h"
 #include "pbd/timing.h"
+#include "pbd/xml++.h"
 
 #include "ardour/ardour.h"
 #include "ardour/audioengine.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 
 #include "test_ui.h"
@@ -33,13 +39,66 @@ pause_for_effect()
 	g_usleep(sleep_seconds*1000000);
 }
 
+/* Compare writing and reading the saved state as XML and in the binary format */
+static
+void
+benchmark_state_file (std::string const & path)
+{
+	XMLTree tree;
+
+	if (!tree.read (path)) {
+		std::cerr << "Could not read state file: " << path << std::endl;
+		return;
+	}
+
+	for (int binary = 0; binary < 2; ++binary) {
+		const std::string out_path = path + (binary ? ".binary" : ".xml");
+		const char*       format   = binary ? "binary" : "XML";
+
+		tree.set_binary (binary);
+
+		PBD::Timing write_timing;
+		tree.write (out_path);
+		write_timing.update();
+
+		PBD::Timing read_timing;
+		XMLTree in (out_path);
+		read_timing.update();
+
+		GStatBuf statbuf;
+		g_stat (out_path.c_str(), &statbuf);
+
+		std::cerr << "Write " << format << " state time : " << write_timing.elapsed()
+		          << " usecs" << std::endl;
+		std::cerr << "Read " << format << " state time : " << read_timing.elapsed()
+		          << " usecs (" << statbuf.st_size << " bytes)" << std::endl;
+
+		if (!in.root() || *in.root() != *tree.root()) {
+			std::cerr << "Read " << format << " state differs from the saved state" << std::endl;
+		}
+
+		g_remove (out_path.c_str());
+	}
+}
+
 int main (int argc, char* argv[])
 {
-	if (argc != 3) {
-		cerr << "Syntax: " << argv[0] << " <dir> <snapshot-name>\n";
+	bool binary = false;
+	int  arg    = 1;
+
+	if (argc > 1 && !strcmp (argv[1], "--binary")) {
+		binary = true;
+		++arg;
+	}
+
+	if (argc - arg != 2) {
+		cerr << "Syntax: " << argv[0] << " [--binary] <dir> <snapshot-name>\n";
 		exit (EXIT_FAILURE);
 	}
 
+	const char* dir      = argv[arg];
+	const char* snapshot = argv[arg + 1];
+
 	std::cerr << "ARDOUR::init" << std::endl;
 
 	PBD::Timing ardour_init_timing;
@@ -49,6 +108,9 @@ int main (int argc, char* argv[])
 
 	TestUI* test_ui = new TestUI();
 
+	/* save the session in the binary format */
+	Config->set_binary_session_state (binary);
+
 	std::cerr << "ARDOUR::init time : " << ardour_init_timing.elapsed()
 	          << " usecs" << std::endl;
 
@@ -56,14 +118,14 @@ int main (int argc, char* argv[])
 
 	create_and_start_dummy_backend ();
 
-	std::cerr << "Loading session: " << argv[2] << std::endl;
+	std::cerr << "Loading session: " << snapshot << std::endl;
 
 	PBD::Timing load_session_timing;
 
 	Session* s = 0;
 
 	try {
-		s = load_session (argv[1], argv[2]);
+		s = load_session (dir, snapshot);
 	} catch (failed_constructor& e) {
 		cerr << "failed_constructor: " << e.what() << "\n";
 		exit (EXIT_FAILURE);
@@ -87,7 +149,7 @@ int main (int argc, char* argv[])
 
 	pause_for_effect ();
 
-	std::cerr << "Saving session: " << argv[2] << std::endl;
+	std::cerr << "Saving session: " << snapshot << std::endl;
 
 	s->save_state("");
 
@@ -96,6 +158,8 @@ int main (int argc, char* argv[])
 	std::cerr << "Saving session time : " << save_session_timing.elapsed()
 	          << " usecs" << std::endl;
 
+	benchmark_state_file (Glib::build_filename (dir, string (snapshot) + statefile_suffix));
+
 	std::cerr << "AudioEngine::remove_session" << std::endl;
 
 	AudioEngine::instance()->remove_session ();
@@ -0,0 +1,249 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstring>
+
+#include "pbd/compose.h"
+
+#include "evoral/EventList.h"
+
+#include "ardour/midi_buffer.h"
+#include "ardour/midi_model.h"
+#include "ardour/midi_playlist.h"
+#include "ardour/midi_region.h"
+#include "ardour/midi_source.h"
+#include "ardour/parameter_types.h"
+#include "ardour/playlist_factory.h"
+#include "ardour/region_factory.h"
+#include "ardour/rt_midibuffer.h"
+#include "ardour/session.h"
+
+#include "midi_playlist_render_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MidiPlaylistRenderTest);
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+using namespace Temporal;
+
+void
+MidiPlaylistRenderTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	_source = _session->create_midi_source_for_session ("test");
+	_playlist = boost::dynamic_pointer_cast<MidiPlaylist> (PlaylistFactory::create (DataType::MIDI, *_session, "test"));
+
+	/* two notes per beat for 16 beats, with some on the same time */
+
+	boost::shared_ptr<MidiModel> model = _source->model ();
+	MidiModel::NoteDiffCommand*  cmd   = model->new_note_diff_command ();
+
+	for (int i = 0; i < 32; ++i) {
+		cmd->add (MidiModel::NotePtr (new Evoral::Note<Beats> (0, Beats::ticks (i * Beats::PPQN / 2), Beats::ticks (Beats::PPQN), 60 + (i % 12), 100)));
+		if (i % 4 == 0) {
+			cmd->add (MidiModel::NotePtr (new Evoral::Note<Beats> (0, Beats::ticks (i * Beats::PPQN / 2), Beats::ticks (Beats::PPQN / 2), 48, 90)));
+		}
+	}
+
+	model->apply_command (*_session, cmd);
+
+	PropertyList plist;
+	plist.add (Properties::start, timepos_t (Beats ()));
+	plist.add (Properties::length, timecnt_t (Beats (16, 0)));
+
+	for (int i = 0; i < 4; ++i) {
+		_r[i] = boost::dynamic_pointer_cast<MidiRegion> (RegionFactory::create (_source, plist));
+		_r[i]->set_name (string_compose ("mr%1", i));
+		_playlist->add_region (_r[i], timepos_t (Beats (i * 12, 0)));
+	}
+
+	/* overlap the first two regions */
+	_r[1]->set_position (timepos_t (Beats (8, 0)));
+}
+
+void
+MidiPlaylistRenderTest::tearDown ()
+{
+	_playlist.reset ();
+	_source.reset ();
+	for (int i = 0; i < 4; ++i) {
+		_r[i].reset ();
+	}
+
+	TestNeedingSession::tearDown ();
+}
+
+namespace {
+
+/* the order in which MidiPlaylist::render () used to sort events */
+struct EventsSortByTimeAndType {
+	bool operator() (const Evoral::Event<samplepos_t>* a, const Evoral::Event<samplepos_t>* b) {
+		if (a->time () == b->time ()) {
+			if (parameter_is_midi ((AutomationType)a->event_type ()) &&
+			    parameter_is_midi ((AutomationType)b->event_type ())) {
+				return !MidiBuffer::second_simultaneous_midi_byte_is_first (a->buffer ()[0], b->buffer ()[0]);
+			}
+		}
+		return a->time () < b->time ();
+	}
+};
+
+}
+
+/** Render all unmuted regions of _playlist from scratch, the way
+ *  MidiPlaylist::render () did before it cached rendered regions:
+ *  a single region is rendered directly, events of multiple regions are
+ *  collected in region-list order and sorted.
+ */
+void
+MidiPlaylistRenderTest::reference_render (RTMidiBuffer& dst)
+{
+	std::vector<boost::shared_ptr<MidiRegion> > regs;
+
+	boost::shared_ptr<RegionList> rl = _playlist->region_list ();
+	for (RegionList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		boost::shared_ptr<MidiRegion> mr = boost::dynamic_pointer_cast<MidiRegion> (*i);
+		if (mr && !mr->muted ()) {
+			regs.push_back (mr);
+		}
+	}
+
+	dst.clear ();
+
+	if (regs.size () == 1) {
+		regs.front ()->render (dst, 0, Sustained, 0);
+		return;
+	}
+
+	Evoral::EventList<samplepos_t> evlist;
+
+	for (std::vector<boost::shared_ptr<MidiRegion> >::const_iterator i = regs.begin (); i != regs.end (); ++i) {
+		(*i)->render (evlist, 0, Sustained, 0);
+	}
+
+	EventsSortByTimeAndType cmp;
+	evlist.sort (cmp);
+
+	for (Evoral::EventList<samplepos_t>::iterator e = evlist.begin (); e != evlist.end (); ++e) {
+		dst.write ((*e)->time (), (*e)->event_type (), (*e)->size (), (*e)->buffer ());
+		delete *e;
+	}
+}
+
+/** Render _playlist, which reuses what it rendered before, and compare it
+ *  with a render of each region from scratch.
+ */
+void
+MidiPlaylistRenderTest::check_render ()
+{
+	_playlist->render (0);
+
+	RTMidiBuffer reference;
+	reference_render (reference);
+
+	RTMidiBuffer& a (*_playlist->rendered ());
+	RTMidiBuffer& b (reference);
+
+	CPPUNIT_ASSERT_EQUAL (b.size (), a.size ());
+
+	for (size_t n = 0; n < a.size (); ++n) {
+		uint32_t       asize;
+		uint32_t       bsize;
+		uint8_t const* abuf = a.bytes (a[n], asize);
+		uint8_t const* bbuf = b.bytes (b[n], bsize);
+
+		CPPUNIT_ASSERT_EQUAL (b[n].timestamp, a[n].timestamp);
+		CPPUNIT_ASSERT_EQUAL (bsize, asize);
+		CPPUNIT_ASSERT (memcmp (abuf, bbuf, asize) == 0);
+	}
+}
+
+void
+MidiPlaylistRenderTest::moveTest ()
+{
+	check_render ();
+	CPPUNIT_ASSERT (_playlist->rendered ()->size () > 0);
+
+	/* into another region */
+	_r[3]->set_position (timepos_t (Beats (30, 0)));
+	check_render ();
+
+	/* to the start, changing the order of the regions */
+	_r[2]->set_position (timepos_t (Beats ()));
+	check_render ();
+
+	/* nothing changed */
+	check_render ();
+}
+
+void
+MidiPlaylistRenderTest::editTest ()
+{
+	check_render ();
+
+	boost::shared_ptr<MidiModel> model = _source->model ();
+	MidiModel::NoteDiffCommand*  cmd   = model->new_note_diff_command ();
+
+	cmd->add (MidiModel::NotePtr (new Evoral::Note<Beats> (1, Beats (3, 0), Beats (2, 0), 72, 64)));
+	model->apply_command (*_session, cmd);
+
+	/* all regions use the source */
+	check_render ();
+
+	_r[0]->set_length (timecnt_t (Beats (5, 0), _r[0]->position ()));
+	check_render ();
+}
+
+void
+MidiPlaylistRenderTest::muteTest ()
+{
+	check_render ();
+
+	_r[1]->set_muted (true);
+	check_render ();
+
+	_r[2]->set_muted (true);
+	_r[3]->set_muted (true);
+	check_render ();
+
+	/* only one region left */
+	_r[1]->set_muted (false);
+	_r[2]->set_muted (false);
+	check_render ();
+
+	_r[3]->set_muted (false);
+	check_render ();
+}
+
+void
+MidiPlaylistRenderTest::removeTest ()
+{
+	check_render ();
+
+	_playlist->remove_region (_r[1]);
+	check_render ();
+
+	_playlist->add_region (_r[1], timepos_t (Beats (20, 0)));
+	check_render ();
+
+	for (int i = 0; i < 4; ++i) {
+		_playlist->remove_region (_r[i]);
+	}
+	check_render ();
+	CPPUNIT_ASSERT (_playlist->rendered ()->empty ());
+}
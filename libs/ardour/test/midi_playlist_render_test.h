@@ -0,0 +1,53 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <boost/shared_ptr.hpp>
+
+#include "test_needing_session.h"
+
+namespace ARDOUR {
+	class MidiPlaylist;
+	class MidiRegion;
+	class MidiSource;
+	class RTMidiBuffer;
+}
+
+class MidiPlaylistRenderTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (MidiPlaylistRenderTest);
+	CPPUNIT_TEST (moveTest);
+	CPPUNIT_TEST (editTest);
+	CPPUNIT_TEST (muteTest);
+	CPPUNIT_TEST (removeTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void moveTest ();
+	void editTest ();
+	void muteTest ();
+	void removeTest ();
+
+private:
+	void check_render ();
+	void reference_render (ARDOUR::RTMidiBuffer&);
+
+	boost::shared_ptr<ARDOUR::MidiSource>   _source;
+	boost::shared_ptr<ARDOUR::MidiPlaylist> _playlist;
+	boost::shared_ptr<ARDOUR::MidiRegion>   _r[4];
+};
@@ -0,0 +1,97 @@
+#include <boost/bind.hpp>
+#include <glibmm/miscutils.h>
+
+#include "pbd/gstdio_compat.h"
+
+#include "ardour/session.h"
+#include "ardour/sndfilesource.h"
+#include "ardour/source_factory.h"
+
+#include "peak_build_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PeakBuildTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+void
+PeakBuildTest::peak_range_ready ()
+{
+	float  fraction;
+	double eta;
+
+	/* PeakRangeReady is emitted by the thread building the peaks,
+	 * which is the test thread here. Don't throw through the peak
+	 * builder, record -1 for "not building" and check that later.
+	 */
+	if (!_source->peak_build_progress (fraction, eta)) {
+		fraction = -1;
+	}
+	_fractions.push_back (fraction);
+}
+
+/** Build the peakfile of a source that spans several read chunks
+ *  and check that the reported progress rises to 1.
+ */
+void
+PeakBuildTest::progressTest ()
+{
+	std::string const test_wav_path = Glib::build_filename (new_test_output_dir (), "peak_build.wav");
+	bool const build_peakfiles = AudioSource::get_build_peakfiles ();
+
+	/* build_peaks_from_scratch () reads 64k samples at a time */
+	samplecnt_t const length = 5 * 65536 + 100;
+
+	{
+		AudioSource::set_build_peakfiles (false);
+
+		boost::shared_ptr<SndFileSource> s = boost::dynamic_pointer_cast<SndFileSource> (
+			SourceFactory::createWritable (DataType::AUDIO, *_session, test_wav_path, get_test_sample_rate (), false));
+		CPPUNIT_ASSERT (s);
+
+		std::vector<Sample> ramp (length);
+		for (samplecnt_t i = 0; i < length; ++i) {
+			ramp[i] = i / (float) length;
+		}
+		CPPUNIT_ASSERT_EQUAL (length, s->write (&ramp[0], length));
+	}
+
+	::g_unlink (_session->construct_peak_filepath (test_wav_path).c_str ());
+
+	_source.reset (new SndFileSource (*_session, test_wav_path, 0, Source::Flag (0)));
+
+	float  fraction;
+	double eta;
+	CPPUNIT_ASSERT (!_source->peak_build_progress (fraction, eta));
+
+	PBD::ScopedConnection c;
+	_source->PeakRangeReady.connect_same_thread (c, boost::bind (&PeakBuildTest::peak_range_ready, this));
+
+	AudioSource::set_build_peakfiles (true);
+	AudioSource::set_build_missing_peakfiles (true);
+
+	CPPUNIT_ASSERT_EQUAL (0, boost::dynamic_pointer_cast<AudioFileSource> (_source)->setup_peakfile ());
+
+	AudioSource::set_build_missing_peakfiles (false);
+	AudioSource::set_build_peakfiles (build_peakfiles);
+
+	CPPUNIT_ASSERT (!_fractions.empty ());
+
+	for (size_t i = 0; i < _fractions.size (); ++i) {
+		CPPUNIT_ASSERT (_fractions[i] > 0);
+		CPPUNIT_ASSERT (_fractions[i] <= 1);
+		if (i > 0) {
+			CPPUNIT_ASSERT (_fractions[i] >= _fractions[i - 1]);
+		}
+	}
+
+	CPPUNIT_ASSERT (_fractions.front () < 1);
+	CPPUNIT_ASSERT_EQUAL (1.f, _fractions.back ());
+
+	/* the build is over */
+	CPPUNIT_ASSERT (!_source->peak_build_progress (fraction, eta));
+
+	c.disconnect ();
+	_source.reset ();
+}
@@ -0,0 +1,23 @@
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "test_needing_session.h"
+
+namespace ARDOUR {
+	class AudioSource;
+}
+
+class PeakBuildTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (PeakBuildTest);
+	CPPUNIT_TEST (progressTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void progressTest ();
+
+private:
+	void peak_range_ready ();
+
+	boost::shared_ptr<ARDOUR::AudioSource> _source;
+	std::vector<float> _fractions;
+};
@@ -16,7 +16,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cstdlib>
+
 #include "ardour/playlist.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/region.h"
 #include "playlist_layering_test.h"
 
@@ -43,3 +46,89 @@ PlaylistLayeringTest::basicsTest ()
 	CPPUNIT_ASSERT_EQUAL (layer_t (1), _r[1]->layer ());
 	CPPUNIT_ASSERT_EQUAL (layer_t (2), _r[2]->layer ());
 }
+
+struct LayeringIndexSort {
+	bool operator() (boost::shared_ptr<Region> a, boost::shared_ptr<Region> b) {
+		return a->layering_index () < b->layering_index ();
+	}
+};
+
+/** Compare layers with the result of the plain layering rule: in the order
+ *  used by the last relayer, each region goes one layer above the highest
+ *  preceding region that it overlaps.
+ */
+void
+PlaylistLayeringTest::check_layers ()
+{
+	RegionList rl (_playlist->region_list_property ().rlist ());
+	rl.sort (LayeringIndexSort ());
+
+	RegionList placed;
+	for (auto const & r : rl) {
+		layer_t l = 0;
+		for (auto const & p : placed) {
+			if (p->overlap_equivalent (r)) {
+				l = max (l, p->layer () + 1);
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL (l, r->layer ());
+		placed.push_back (r);
+	}
+}
+
+/** Random edits, each of which only relayers part of the playlist,
+ *  must give the same layers as relayering everything.
+ */
+void
+PlaylistLayeringTest::incrementalTest ()
+{
+	srand (42);
+
+	for (int model = 0; model < 2; ++model) {
+		Config->set_layer_model (model == 0 ? Manual : LaterHigher);
+
+		for (int i = 0; i < 16; ++i) {
+			_playlist->add_region (_r[i], timepos_t (rand () % 2000));
+		}
+		check_layers ();
+
+		for (int n = 0; n < 500; ++n) {
+			boost::shared_ptr<Region> r = _r[rand () % 16];
+
+			switch (rand () % 6) {
+				case 0:
+					r->set_position (timepos_t (rand () % 2000));
+					break;
+				case 1:
+					r->set_position (r->position () + timecnt_t (rand () % 20));
+					break;
+				case 2:
+					r->raise ();
+					break;
+				case 3:
+					r->lower ();
+					break;
+				case 4:
+					if (rand () % 2) {
+						r->raise_to_top ();
+					} else {
+						r->lower_to_bottom ();
+					}
+					break;
+				case 5:
+					_playlist->remove_region (r);
+					check_layers ();
+					_playlist->add_region (r, timepos_t (rand () % 2000));
+					break;
+			}
+
+			check_layers ();
+		}
+
+		for (int i = 0; i < 16; ++i) {
+			_playlist->remove_region (_r[i]);
+		}
+	}
+
+	Config->set_layer_model (Manual);
+}
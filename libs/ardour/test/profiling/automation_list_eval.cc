@@ -0,0 +1,106 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "pbd/microseconds.h"
+
+#include "evoral/Curve.h"
+
+#include "ardour/ardour.h"
+#include "ardour/automation_list.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace Temporal;
+
+static const char* localedir = LOCALEDIR;
+
+int
+main (int argc, char* argv[])
+{
+	int n_points = 100000;
+	int lookups  = 1000000;
+
+	if (argc > 1) {
+		n_points = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		lookups = atoi (argv[2]);
+	}
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI ();
+
+	{
+		AutomationList al (Evoral::Parameter (GainAutomation), AudioTime);
+
+		/* one point every 64 samples */
+		const samplepos_t step = 64;
+		const samplepos_t len  = n_points * step;
+
+		PBD::microseconds_t start = PBD::get_microseconds ();
+
+		al.freeze ();
+		for (int i = 0; i < n_points; ++i) {
+			al.fast_simple_add (timepos_t (i * step), (i % 2) ? 1.0 : 0.5);
+		}
+		al.thaw ();
+
+		PBD::microseconds_t elapsed = PBD::get_microseconds () - start;
+		printf ("# %d points, %d lookups\n", n_points, lookups);
+		printf ("build                   %10.3f msec\n", elapsed / 1000.0);
+
+		/* random access */
+		srand (1);
+		double sum = 0;
+		start = PBD::get_microseconds ();
+		for (int i = 0; i < lookups; ++i) {
+			sum += al.eval (timepos_t ((samplepos_t) ((rand () / (double) RAND_MAX) * len)));
+		}
+		elapsed = PBD::get_microseconds () - start;
+		printf ("eval (random)           %10.4f usec/call\n", elapsed / (double) lookups);
+
+		/* sequential access, as during playback */
+		start = PBD::get_microseconds ();
+		for (int i = 0; i < lookups; ++i) {
+			sum += al.eval (timepos_t ((samplepos_t) i * len / lookups));
+		}
+		elapsed = PBD::get_microseconds () - start;
+		printf ("eval (sequential)       %10.4f usec/call\n", elapsed / (double) lookups);
+
+		/* event search, as used by AutomationControl during playback */
+		start = PBD::get_microseconds ();
+		timepos_t x;
+		double    y;
+		int       found = 0;
+		for (int i = 0; i < lookups; ++i) {
+			if (al.rt_safe_earliest_event_linear_unlocked (timepos_t ((samplepos_t) i * len / lookups), x, y, true)) {
+				++found;
+			}
+		}
+		elapsed = PBD::get_microseconds () - start;
+		printf ("earliest_event (linear) %10.4f usec/call\n", elapsed / (double) lookups);
+
+		/* curve rendering, 1024 samples per cycle */
+		const int nframes = 1024;
+		float     vec[nframes];
+		const int cycles  = len / nframes;
+		start = PBD::get_microseconds ();
+		for (int c = 0; c < cycles; ++c) {
+			al.curve ().get_vector (timepos_t ((samplepos_t) c * nframes), timepos_t ((samplepos_t) (c + 1) * nframes), vec, nframes);
+		}
+		elapsed = PBD::get_microseconds () - start;
+		printf ("curve get_vector        %10.4f usec/cycle (%d cycles)\n", elapsed / (double) cycles, cycles);
+
+		assert (found > 0);
+		assert (sum > 0);
+	}
+
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -1,3 +1,6 @@
+#include <cstdio>
+#include <cstdlib>
+
 #include "test_ui.h"
 #include "test_util.h"
 #include "ardour/ardour.h"
@@ -5,6 +8,7 @@
 #include "ardour/midi_region.h"
 #include "ardour/session.h"
 #include "ardour/playlist.h"
+#include "pbd/microseconds.h"
 #include "pbd/stateful_diff_command.h"
 
 using namespace std;
@@ -13,9 +17,36 @@ using namespace PBD;
 
 static const char* localedir = LOCALEDIR;
 
+/* a random position inside the extent, in the time-domain of the extent */
+static timepos_t
+random_position (pair<timepos_t, timepos_t> const & extent)
+{
+	int64_t const first = extent.first.val ();
+	int64_t const span  = max<int64_t> (1, extent.second.val () - first);
+	int64_t const v     = first + (int64_t) (span * (rand () / (RAND_MAX + 1.0)));
+	return extent.first.is_beats () ? timepos_t::from_ticks (v) : timepos_t::from_superclock (v);
+}
+
+static void
+report (char const* what, PBD::microseconds_t elapsed, int n, size_t found)
+{
+	printf ("%-22s %10.3f usec/call (%zu regions found)\n", what, elapsed / (double) n, found);
+}
+
+/* usage: lots_of_regions [copies [queries]] */
 int
 main (int argc, char* argv[])
 {
+	int copies  = 1000;
+	int queries = 10000;
+
+	if (argc > 1) {
+		copies = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		queries = atoi (argv[2]);
+	}
+
 	ARDOUR::init (true, localedir);
 	TestUI* test_ui = new TestUI();
 	create_and_start_dummy_backend ();
@@ -41,7 +72,7 @@ main (int argc, char* argv[])
 	session->begin_reversible_command ("foo");
 	playlist->clear_changes ();
 	timepos_t pos (region->last_sample() + 1);
-	playlist->duplicate (region, pos, 1000);
+	playlist->duplicate (region, pos, copies);
 	session->add_command (new StatefulDiffCommand (playlist));
 	session->commit_reversible_command ();
 
@@ -52,10 +83,57 @@ main (int argc, char* argv[])
 	session->begin_reversible_command ("foo");
 	playlist->clear_changes ();
 	timepos_t pos2 (region->last_sample() + 1);
-	playlist->duplicate (region, pos2, 1000);
+	playlist->duplicate (region, pos2, copies);
 	session->add_command (new StatefulDiffCommand (playlist));
 	session->commit_reversible_command ();
 
+	/* Query it */
+	pair<timepos_t, timepos_t> const extent (playlist->get_extent ());
+	timecnt_t const                  len (region->length ());
+	PBD::microseconds_t              start;
+	size_t                           found = 0;
+
+	printf ("# %zu regions, %d queries\n", playlist->region_list_property ().size (), queries);
+
+	srand (1);
+	start = PBD::get_microseconds ();
+	for (int i = 0; i < queries; ++i) {
+		found += playlist->regions_at (random_position (extent))->size ();
+	}
+	report ("regions_at", PBD::get_microseconds () - start, queries, found);
+
+	found = 0;
+	start = PBD::get_microseconds ();
+	for (int i = 0; i < queries; ++i) {
+		found += playlist->count_regions_at (random_position (extent));
+	}
+	report ("count_regions_at", PBD::get_microseconds () - start, queries, found);
+
+	found = 0;
+	start = PBD::get_microseconds ();
+	for (int i = 0; i < queries; ++i) {
+		found += playlist->top_region_at (random_position (extent)) ? 1 : 0;
+	}
+	report ("top_region_at", PBD::get_microseconds () - start, queries, found);
+
+	found = 0;
+	start = PBD::get_microseconds ();
+	for (int i = 0; i < queries; ++i) {
+		timepos_t const p (random_position (extent));
+		found += playlist->regions_touched (p, p + len)->size ();
+	}
+	report ("regions_touched", PBD::get_microseconds () - start, queries, found);
+
+	/* every edit updates the index in place (O(log N)) */
+	int const edits = max (1, queries / 100);
+	found = 0;
+	start = PBD::get_microseconds ();
+	for (int i = 0; i < edits; ++i) {
+		region->set_position (region->position ());
+		found += playlist->regions_at (random_position (extent))->size ();
+	}
+	report ("edit + regions_at", PBD::get_microseconds () - start, edits, found);
+
 	}
 
 	delete session;
@@ -0,0 +1,114 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+#include "pbd/microseconds.h"
+
+#include "ardour/ardour.h"
+#include "ardour/midi_model.h"
+#include "ardour/midi_region.h"
+#include "ardour/midi_track.h"
+#include "ardour/playlist.h"
+#include "ardour/session.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace Temporal;
+
+static const char* localedir = LOCALEDIR;
+
+static void
+report (char const* what, PBD::microseconds_t elapsed, size_t n_notes)
+{
+	printf ("%-22s %10.3f msec (%zu notes)\n", what, elapsed / 1000.0, n_notes);
+}
+
+/* usage: midi_model_edit [notes] */
+int
+main (int argc, char* argv[])
+{
+	int n_notes = 100000;
+
+	if (argc > 1) {
+		n_notes = atoi (argv[1]);
+	}
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI ();
+	create_and_start_dummy_backend ();
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
+
+	assert (session->get_routes ()->size () == 2);
+
+	{
+		boost::shared_ptr<MidiTrack> track = boost::dynamic_pointer_cast<MidiTrack> (session->get_routes ()->back ());
+		assert (track);
+
+		boost::shared_ptr<MidiRegion> region = boost::dynamic_pointer_cast<MidiRegion> (track->playlist ()->region_list_property ().rlist ().front ());
+		assert (region);
+
+		boost::shared_ptr<MidiModel> model = region->model ();
+		assert (model);
+
+		printf ("# %d notes\n", n_notes);
+
+		PBD::microseconds_t start;
+		MidiModel::NoteDiffCommand* cmd;
+
+		/* a 16th note drum pattern on 8 pitches */
+
+		start = PBD::get_microseconds ();
+		cmd   = model->new_note_diff_command ("add");
+		for (int i = 0; i < n_notes; ++i) {
+			cmd->add (MidiModel::new_note (9, Beats::ticks ((i / 8) * (Beats::PPQN / 4)), Beats::ticks (Beats::PPQN / 8), 36 + (i % 8), 64 + (i % 64)));
+		}
+		model->apply_command (*session, cmd);
+		report ("add", PBD::get_microseconds () - start, model->n_notes ());
+
+		start = PBD::get_microseconds ();
+		cmd   = model->new_note_diff_command ("transpose");
+		for (MidiModel::Notes::const_iterator i = model->notes ().begin (); i != model->notes ().end (); ++i) {
+			cmd->change (*i, MidiModel::NoteDiffCommand::NoteNumber, (uint8_t) ((*i)->note () + 12));
+		}
+		model->apply_command (*session, cmd);
+		report ("transpose", PBD::get_microseconds () - start, model->n_notes ());
+
+		start = PBD::get_microseconds ();
+		cmd   = model->new_note_diff_command ("nudge");
+		for (MidiModel::Notes::const_iterator i = model->notes ().begin (); i != model->notes ().end (); ++i) {
+			cmd->change (*i, MidiModel::NoteDiffCommand::StartTime, (*i)->time () + Beats::ticks (1));
+		}
+		model->apply_command (*session, cmd);
+		report ("nudge", PBD::get_microseconds () - start, model->n_notes ());
+
+		/* like selecting all notes */
+		int64_t sum = 0;
+		start = PBD::get_microseconds ();
+		for (MidiModel::Notes::const_iterator i = model->notes ().begin (); i != model->notes ().end (); ++i) {
+			sum += (*i)->velocity ();
+		}
+		report ("iterate", PBD::get_microseconds () - start, model->n_notes ());
+		assert (sum > 0);
+
+		start = PBD::get_microseconds ();
+		session->undo (1);
+		report ("undo nudge", PBD::get_microseconds () - start, model->n_notes ());
+
+		start = PBD::get_microseconds ();
+		cmd   = model->new_note_diff_command ("remove");
+		for (MidiModel::Notes::const_iterator i = model->notes ().begin (); i != model->notes ().end (); ++i) {
+			cmd->remove (*i);
+		}
+		model->apply_command (*session, cmd);
+		report ("remove", PBD::get_microseconds () - start, model->n_notes ());
+	}
+
+	delete session;
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
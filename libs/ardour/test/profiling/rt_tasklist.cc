@@ -0,0 +1,78 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "pbd/microseconds.h"
+
+#include "ardour/ardour.h"
+#include "ardour/rt_tasklist.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* a trivial task, so that the measurement is dominated by dispatch overhead */
+struct Counter {
+	Counter () : value (0) {}
+	void add (pframes_t n) { value += n; }
+	char     pad[64];
+	uint64_t value;
+};
+
+int
+main (int argc, char* argv[])
+{
+	int cycles = 10000;
+
+	if (argc > 1) {
+		cycles = atoi (argv[1]);
+	}
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI ();
+	create_and_start_dummy_backend ();
+
+	{
+		RTTaskList tl (1024);
+		Counter*   counters = new Counter[1024];
+
+		printf ("# tasks  usec/cycle  usec/task  (%d cycles)\n", cycles);
+
+		for (size_t n_tasks = 16; n_tasks <= 1024; n_tasks *= 2) {
+			/* warm up */
+			for (size_t i = 0; i < n_tasks; ++i) {
+				tl.push_back (RTTask::member<Counter, &Counter::add> (&counters[i], 1));
+			}
+			tl.process ();
+
+			PBD::microseconds_t start = PBD::get_microseconds ();
+
+			for (int c = 0; c < cycles; ++c) {
+				for (size_t i = 0; i < n_tasks; ++i) {
+					tl.push_back (RTTask::member<Counter, &Counter::add> (&counters[i], 1));
+				}
+				tl.process ();
+			}
+
+			PBD::microseconds_t elapsed = PBD::get_microseconds () - start;
+
+			printf ("%7zu  %10.3f  %9.4f\n", n_tasks, elapsed / (double)cycles, elapsed / (double)(cycles * n_tasks));
+		}
+
+		for (size_t i = 0; i < 1024; ++i) {
+			assert (counters[i].value > 0);
+		}
+
+		delete [] counters;
+	}
+
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "pbd/fpu.h"
+#include "pbd/malign.h"
+#include "pbd/microseconds.h"
+
+#include "ardour/mix.h"
+#include "ardour/runtime_functions.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+/* Throughput of every compiled-in and run-time supported variant of the
+ * runtime_functions.h kernels, checked against the default_* versions.
+ *
+ * usage: runtime_functions [block-size [iterations]]
+ */
+
+struct Variant {
+	Variant (string const& n, compute_peak_t cp, find_peaks_t fp, apply_gain_to_buffer_t ag, mix_buffers_with_gain_t mg, mix_buffers_no_gain_t mn, copy_vector_t cv, apply_gain_ramp_t gr, reduce_peaks_t rp, bool x)
+		: name (n), compute_peak (cp), find_peaks (fp), apply_gain_to_buffer (ag), mix_buffers_with_gain (mg), mix_buffers_no_gain (mn), copy_vector (cv), apply_gain_ramp (gr), reduce_peaks (rp), exact (x) {}
+
+	string                  name;
+	compute_peak_t          compute_peak;
+	find_peaks_t            find_peaks;
+	apply_gain_to_buffer_t  apply_gain_to_buffer;
+	mix_buffers_with_gain_t mix_buffers_with_gain;
+	mix_buffers_no_gain_t   mix_buffers_no_gain;
+	copy_vector_t           copy_vector;
+	apply_gain_ramp_t       apply_gain_ramp;
+	reduce_peaks_t          reduce_peaks;
+	bool                    exact; /* false if mix_buffers_with_gain may use FMA */
+};
+
+static float* src;
+static float* dst;
+static float* ref;
+
+static void
+fill (float* buf, size_t n, float scale)
+{
+	for (size_t i = 0; i < n; ++i) {
+		buf[i] = scale * sinf (i * 0.01f) / (1.f + (i % 7));
+	}
+}
+
+static size_t
+compare (float const* a, float const* b, size_t n, bool exact, float tolerance = FLT_EPSILON)
+{
+	size_t err = 0;
+	for (size_t i = 0; i < n; ++i) {
+		if (exact ? (a[i] != b[i]) : (fabsf (a[i] - b[i]) > tolerance)) {
+			++err;
+		}
+	}
+	return err;
+}
+
+/* compare against default_* at all (unaligned) offsets up to 64 and sizes up to 130 */
+static size_t
+verify (Variant const& v)
+{
+	const size_t len = 256;
+	size_t       err = 0;
+
+	for (size_t off = 0; off < 64; ++off) {
+		for (size_t cnt = 1; cnt < 130; ++cnt) {
+			float pk_a, pk_b, min_a, max_a, min_b, max_b;
+
+			fill (dst, len, 1.f); fill (ref, len, 1.f);
+			v.apply_gain_to_buffer (dst + off, cnt, 0.7f);
+			default_apply_gain_to_buffer (ref + off, cnt, 0.7f);
+			err += compare (dst, ref, len, true);
+
+			v.mix_buffers_with_gain (dst + off, src + off, cnt, 0.45f);
+			default_mix_buffers_with_gain (ref + off, src + off, cnt, 0.45f);
+			err += compare (dst, ref, len, v.exact);
+
+			fill (dst, len, 1.f); fill (ref, len, 1.f);
+			v.mix_buffers_no_gain (dst + off, src + off, cnt);
+			default_mix_buffers_no_gain (ref + off, src + off, cnt);
+			err += compare (dst, ref, len, true);
+
+			v.copy_vector (dst + off, src + off, cnt);
+			default_copy_vector (ref + off, src + off, cnt);
+			err += compare (dst, ref, len, true);
+
+			/* SIMD gain ramps are evaluated in closed form, not by recursion */
+			float g_a = v.apply_gain_ramp (dst + off, src + off, cnt, 1.f, 0.f, 0.0033f);
+			float g_b = default_apply_gain_ramp (ref + off, src + off, cnt, 1.f, 0.f, 0.0033f);
+			err += compare (dst, ref, len, false, 2e-5f);
+			err += fabsf (g_a - g_b) > 2e-5f ? 1 : 0;
+
+			pk_a = v.compute_peak (src + off, cnt, 0.f);
+			pk_b = default_compute_peak (src + off, cnt, 0.f);
+			err += pk_a != pk_b ? 1 : 0;
+
+			min_a = max_a = min_b = max_b = src[off];
+			v.find_peaks (src + off, cnt, &min_a, &max_a);
+			default_find_peaks (src + off, cnt, &min_b, &max_b);
+			err += (min_a != min_b || max_a != max_b) ? 1 : 0;
+
+			static const pframes_t fpps[] = { 1, 3, 4, 7, 8, 15, 16, 17, 33, 64, 100 };
+			for (size_t f = 0; f < sizeof (fpps) / sizeof (fpps[0]); ++f) {
+				PeakData pd_a[130];
+				PeakData pd_b[130];
+				v.reduce_peaks (src + off, cnt, fpps[f], pd_a);
+				default_reduce_peaks (src + off, cnt, fpps[f], pd_b);
+				for (size_t p = 0; p < (cnt + fpps[f] - 1) / fpps[f]; ++p) {
+					err += (pd_a[p].min != pd_b[p].min || pd_a[p].max != pd_b[p].max) ? 1 : 0;
+				}
+			}
+		}
+	}
+	return err;
+}
+
+static void
+report (char const* kernel, PBD::microseconds_t elapsed, size_t n_samples)
+{
+	printf ("  %-22s %9.1f Msamples/sec\n", kernel, elapsed > 0 ? n_samples / (double) elapsed : 0);
+}
+
+static void
+benchmark (Variant const& v, size_t n, size_t iterations)
+{
+	PBD::microseconds_t start;
+	float               pk = 0, mn = 0, mx = 0;
+
+	start = PBD::get_microseconds ();
+	for (size_t i = 0; i < iterations; ++i) {
+		pk = v.compute_peak (src, n, pk);
+	}
+	report ("compute_peak", PBD::get_microseconds () - start, n * iterations);
+
+	start = PBD::get_microseconds ();
+	for (size_t i = 0; i < iterations; ++i) {
+		v.find_peaks (src, n, &mn, &mx);
+	}
+	report ("find_peaks", PBD::get_microseconds () - start, n * iterations);
+
+	start = PBD::get_microseconds ();
+	for (size_t i = 0; i < iterations; ++i) {
+		v.apply_gain_to_buffer (dst, n, (i & 1) ? 0.5f : 2.f);
+	}
+	report ("apply_gain_to_buffer", PBD::get_microseconds () - start, n * iterations);
+
+	start = PBD::get_microseconds ();
+	for (size_t i = 0; i < iterations; ++i) {
+		v.mix_buffers_with_gain (dst, src, n, (i & 1) ? 0.5f : -0.5f);
+	}
+	report ("mix_buffers_with_gain", PBD::get_microseconds () - start, n * iterations);
+
+	start = PBD::get_microseconds ();
+	for (size_t i = 0; i < iterations; ++i) {
+		v.mix_buffers_no_gain (dst, src, n);
+	}
+	report ("mix_buffers_no_gain", PBD::get_microseconds () - start, n * iterations);
+
+	start = PBD::get_microseconds ();
+	for (size_t i = 0; i < iterations; ++i) {
+		v.copy_vector (dst, src, n);
+	}
+	report ("copy_vector", PBD::get_microseconds () - start, n * iterations);
+
+	start = PBD::get_microseconds ();
+	for (size_t i = 0; i < iterations; ++i) {
+		v.apply_gain_ramp (dst, src, n, (i & 1) ? 0.5f : 1.f, (i & 1) ? 1.f : 0.5f, 0.0033f);
+	}
+	report ("apply_gain_ramp", PBD::get_microseconds () - start, n * iterations);
+
+	/* peakfile resolution, and a typical zoomed-in waveform view */
+	static const pframes_t fpps[] = { 256, 16 };
+	for (size_t f = 0; f < sizeof (fpps) / sizeof (fpps[0]); ++f) {
+		vector<PeakData> peaks (n / fpps[f] + 1);
+		char             name[32];
+
+		start = PBD::get_microseconds ();
+		for (size_t i = 0; i < iterations; ++i) {
+			v.reduce_peaks (src, n, fpps[f], &peaks[0]);
+		}
+		snprintf (name, sizeof (name), "reduce_peaks (%u)", fpps[f]);
+		report (name, PBD::get_microseconds () - start, n * iterations);
+	}
+}
+
+int
+main (int argc, char* argv[])
+{
+	size_t n          = 1024;
+	size_t iterations = 100000;
+
+	if (argc > 1) {
+		n = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		iterations = atoi (argv[2]);
+	}
+
+	const size_t len = max (n, (size_t) 256) + 64;
+	cache_aligned_malloc ((void**) &src, sizeof (float) * len);
+	cache_aligned_malloc ((void**) &dst, sizeof (float) * len);
+	cache_aligned_malloc ((void**) &ref, sizeof (float) * len);
+	fill (src, len, 0.8f);
+	fill (dst, len, 1.f);
+
+	PBD::FPU* fpu = PBD::FPU::instance ();
+
+	vector<Variant> variants;
+
+	variants.push_back (Variant ("default", default_compute_peak, default_find_peaks, default_apply_gain_to_buffer, default_mix_buffers_with_gain, default_mix_buffers_no_gain, default_copy_vector, default_apply_gain_ramp, default_reduce_peaks, true));
+
+#if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
+	if (fpu->has_sse ()) {
+		variants.push_back (Variant ("SSE", x86_sse_compute_peak, x86_sse_find_peaks, x86_sse_apply_gain_to_buffer, x86_sse_mix_buffers_with_gain, x86_sse_mix_buffers_no_gain, default_copy_vector, x86_sse_apply_gain_ramp, x86_sse_reduce_peaks, true));
+	}
+	if (fpu->has_avx ()) {
+		variants.push_back (Variant ("AVX", x86_sse_avx_compute_peak, x86_sse_avx_find_peaks, x86_sse_avx_apply_gain_to_buffer, x86_sse_avx_mix_buffers_with_gain, x86_sse_avx_mix_buffers_no_gain, x86_sse_avx_copy_vector, x86_sse_apply_gain_ramp, x86_sse_avx_reduce_peaks, true));
+	}
+#ifdef FPU_AVX_FMA_SUPPORT
+	if (fpu->has_avx () && fpu->has_fma ()) {
+		variants.push_back (Variant ("AVX+FMA", x86_sse_avx_compute_peak, x86_sse_avx_find_peaks, x86_sse_avx_apply_gain_to_buffer, x86_fma_mix_buffers_with_gain, x86_sse_avx_mix_buffers_no_gain, x86_sse_avx_copy_vector, x86_sse_apply_gain_ramp, x86_sse_avx_reduce_peaks, false));
+	}
+#endif
+#ifdef FPU_AVX512F_SUPPORT
+	if (fpu->has_avx512f ()) {
+		variants.push_back (Variant ("AVX-512F", x86_avx512f_compute_peak, x86_avx512f_find_peaks, x86_avx512f_apply_gain_to_buffer, x86_avx512f_mix_buffers_with_gain, x86_avx512f_mix_buffers_no_gain, x86_avx512f_copy_vector, x86_avx512f_apply_gain_ramp, x86_avx512f_reduce_peaks, true));
+	}
+#endif
+#elif defined ARM_NEON_SUPPORT
+	if (fpu->has_neon ()) {
+		variants.push_back (Variant ("NEON", arm_neon_compute_peak, arm_neon_find_peaks, arm_neon_apply_gain_to_buffer, arm_neon_mix_buffers_with_gain, arm_neon_mix_buffers_no_gain, arm_neon_copy_vector, arm_neon_apply_gain_ramp, arm_neon_reduce_peaks, false));
+	}
+#endif
+
+	int rv = 0;
+
+	printf ("# block size: %zu, iterations: %zu\n", n, iterations);
+
+	for (vector<Variant>::const_iterator v = variants.begin (); v != variants.end (); ++v) {
+		size_t err = verify (*v);
+		printf ("%s: %s\n", v->name.c_str (), err == 0 ? (v->exact ? "bit-exact" : "matches within FLT_EPSILON") : "MISMATCH");
+		if (err) {
+			rv = 1;
+		}
+		benchmark (*v, n, iterations);
+	}
+
+	cache_aligned_free (src);
+	cache_aligned_free (dst);
+	cache_aligned_free (ref);
+
+	PBD::FPU::destroy ();
+	return rv;
+}
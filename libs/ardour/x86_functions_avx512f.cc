@@ -0,0 +1,371 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef FPU_AVX512F_SUPPORT
+
+#include "ardour/mix.h"
+
+#include <immintrin.h>
+
+#ifndef __AVX512F__
+#error "__AVX512F__ must be enabled for this module to work"
+#endif
+
+/* With AVX-512 unaligned loads/stores of aligned data are as fast as the
+ * aligned variants, and masked loads/stores take care of the tail. So
+ * there is no need for scalar pre/post-loops here.
+ */
+
+static inline __mmask16
+tail_mask (uint32_t nframes)
+{
+	return (__mmask16)((1u << nframes) - 1);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for compute peak procedure
+ * @param src Pointer to source buffer
+ * @param nframes Number of frames to process
+ * @param current Current peak value
+ * @return float New peak value
+ */
+float
+x86_avx512f_compute_peak (const float* src, uint32_t nframes, float current)
+{
+	__m512 vmax0 = _mm512_set1_ps (current);
+	__m512 vmax1 = vmax0;
+
+	while (nframes >= 32) {
+		vmax0 = _mm512_max_ps (vmax0, _mm512_abs_ps (_mm512_loadu_ps (src + 0)));
+		vmax1 = _mm512_max_ps (vmax1, _mm512_abs_ps (_mm512_loadu_ps (src + 16)));
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		vmax0 = _mm512_max_ps (vmax0, _mm512_abs_ps (_mm512_loadu_ps (src)));
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		vmax1 = _mm512_mask_max_ps (vmax1, m, vmax1, _mm512_abs_ps (_mm512_maskz_loadu_ps (m, src)));
+	}
+
+	return _mm512_reduce_max_ps (_mm512_max_ps (vmax0, vmax1));
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for find peak procedure
+ * @param src Pointer to source buffer
+ * @param nframes Number of frames to process
+ * @param[in,out] minf Current minimum value, updated
+ * @param[in,out] maxf Current maximum value, updated
+ */
+void
+x86_avx512f_find_peaks (const float* src, uint32_t nframes, float* minf, float* maxf)
+{
+	__m512 vmin = _mm512_set1_ps (*minf);
+	__m512 vmax = _mm512_set1_ps (*maxf);
+
+	while (nframes >= 32) {
+		__m512 x0 = _mm512_loadu_ps (src + 0);
+		__m512 x1 = _mm512_loadu_ps (src + 16);
+		vmin = _mm512_min_ps (vmin, _mm512_min_ps (x0, x1));
+		vmax = _mm512_max_ps (vmax, _mm512_max_ps (x0, x1));
+		src += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		__m512 x0 = _mm512_loadu_ps (src);
+		vmin = _mm512_min_ps (vmin, x0);
+		vmax = _mm512_max_ps (vmax, x0);
+		src += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512 x0 = _mm512_maskz_loadu_ps (m, src);
+		vmin = _mm512_mask_min_ps (vmin, m, vmin, x0);
+		vmax = _mm512_mask_max_ps (vmax, m, vmax, x0);
+	}
+
+	*minf = _mm512_reduce_min_ps (vmin);
+	*maxf = _mm512_reduce_max_ps (vmax);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for apply gain routine
+ * @param[in,out] dst Pointer to the destination buffer, which gets updated
+ * @param nframes Number of frames (or samples) to process
+ * @param gain Gain to apply
+ */
+void
+x86_avx512f_apply_gain_to_buffer (float* dst, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		__m512 x0 = _mm512_loadu_ps (dst + 0);
+		__m512 x1 = _mm512_loadu_ps (dst + 16);
+		_mm512_storeu_ps (dst + 0, _mm512_mul_ps (g, x0));
+		_mm512_storeu_ps (dst + 16, _mm512_mul_ps (g, x1));
+		dst += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_mul_ps (g, _mm512_loadu_ps (dst)));
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_mul_ps (g, _mm512_maskz_loadu_ps (m, dst)));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing buffer with gain.
+ *
+ * This deliberately does not use fused multiply-add, in order to produce
+ * the same result as default_mix_buffers_with_gain().
+ *
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ * @param gain Gain to apply
+ */
+void
+x86_avx512f_mix_buffers_with_gain (float* dst, const float* src, uint32_t nframes, float gain)
+{
+	const __m512 g = _mm512_set1_ps (gain);
+
+	while (nframes >= 32) {
+		__m512 s0 = _mm512_loadu_ps (src + 0);
+		__m512 s1 = _mm512_loadu_ps (src + 16);
+		__m512 d0 = _mm512_loadu_ps (dst + 0);
+		__m512 d1 = _mm512_loadu_ps (dst + 16);
+		_mm512_storeu_ps (dst + 0, _mm512_add_ps (d0, _mm512_mul_ps (s0, g)));
+		_mm512_storeu_ps (dst + 16, _mm512_add_ps (d1, _mm512_mul_ps (s1, g)));
+		src += 32;
+		dst += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		__m512 s0 = _mm512_loadu_ps (src);
+		__m512 d0 = _mm512_loadu_ps (dst);
+		_mm512_storeu_ps (dst, _mm512_add_ps (d0, _mm512_mul_ps (s0, g)));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512 s0 = _mm512_maskz_loadu_ps (m, src);
+		__m512 d0 = _mm512_maskz_loadu_ps (m, dst);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (d0, _mm512_mul_ps (s0, g)));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing buffer without gain.
+ *
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_mix_buffers_no_gain (float* dst, const float* src, uint32_t nframes)
+{
+	while (nframes >= 32) {
+		__m512 s0 = _mm512_loadu_ps (src + 0);
+		__m512 s1 = _mm512_loadu_ps (src + 16);
+		__m512 d0 = _mm512_loadu_ps (dst + 0);
+		__m512 d1 = _mm512_loadu_ps (dst + 16);
+		_mm512_storeu_ps (dst + 0, _mm512_add_ps (d0, s0));
+		_mm512_storeu_ps (dst + 16, _mm512_add_ps (d1, s1));
+		src += 32;
+		dst += 32;
+		nframes -= 32;
+	}
+
+	if (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_add_ps (_mm512_loadu_ps (dst), _mm512_loadu_ps (src)));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		__m512 s0 = _mm512_maskz_loadu_ps (m, src);
+		__m512 d0 = _mm512_maskz_loadu_ps (m, dst);
+		_mm512_mask_storeu_ps (dst, m, _mm512_add_ps (d0, s0));
+	}
+}
+
+/**
+ * @brief Copy vector from one location to another
+ *
+ * @param[out] dst Pointer to destination buffer
+ * @param[in] src Pointer to source buffer
+ * @param nframes Number of samples to copy
+ */
+void
+x86_avx512f_copy_vector (float* dst, const float* src, uint32_t nframes)
+{
+	while (nframes >= 64) {
+		__m512 s0 = _mm512_loadu_ps (src + 0);
+		__m512 s1 = _mm512_loadu_ps (src + 16);
+		__m512 s2 = _mm512_loadu_ps (src + 32);
+		__m512 s3 = _mm512_loadu_ps (src + 48);
+		_mm512_storeu_ps (dst + 0, s0);
+		_mm512_storeu_ps (dst + 16, s1);
+		_mm512_storeu_ps (dst + 32, s2);
+		_mm512_storeu_ps (dst + 48, s3);
+		src += 64;
+		dst += 64;
+		nframes -= 64;
+	}
+
+	while (nframes >= 16) {
+		_mm512_storeu_ps (dst, _mm512_loadu_ps (src));
+		src += 16;
+		dst += 16;
+		nframes -= 16;
+	}
+
+	if (nframes > 0) {
+		const __mmask16 m = tail_mask (nframes);
+		_mm512_mask_storeu_ps (dst, m, _mm512_maskz_loadu_ps (m, src));
+	}
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to copy a buffer applying a gain ramp
+ *
+ * The ramp g[i+1] = g[i] + coeff * (target - g[i]) is computed in closed form,
+ * g[i] = target + (initial - target) * (1 - coeff)^i, 16 samples at a time.
+ *
+ * @param[out] dst Pointer to destination buffer, may be the same as src
+ * @param[in] src Pointer to source buffer
+ * @param nframes Number of samples to process
+ * @param initial Gain of the first sample
+ * @param target Gain to approach
+ * @param coeff Lowpass coefficient
+ * @return gain following the last sample
+ */
+float
+x86_avx512f_apply_gain_ramp (float* dst, const float* src, uint32_t nframes, float initial, float target, float coeff)
+{
+	const float r = 1.f - coeff;
+	float       d = initial - target;
+
+	if (nframes >= 16) {
+		float p[16];
+		p[0] = 1.f;
+		for (int i = 1; i < 16; ++i) {
+			p[i] = p[i - 1] * r;
+		}
+
+		const __m512 vt   = _mm512_set1_ps (target);
+		const __m512 vr16 = _mm512_set1_ps (p[15] * r);
+		__m512       vd   = _mm512_mul_ps (_mm512_set1_ps (d), _mm512_loadu_ps (p));
+
+		while (nframes >= 16) {
+			_mm512_storeu_ps (dst, _mm512_mul_ps (_mm512_loadu_ps (src), _mm512_add_ps (vt, vd)));
+			vd = _mm512_mul_ps (vd, vr16);
+			src += 16;
+			dst += 16;
+			nframes -= 16;
+		}
+
+		d = _mm_cvtss_f32 (_mm512_castps512_ps128 (vd));
+	}
+
+	while (nframes > 0) {
+		*dst++ = *src++ * (target + d);
+		d *= r;
+		--nframes;
+	}
+
+	return target + d;
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to reduce a buffer to peaks
+ *
+ * Peaks of at least 16 samples use overlapping loads of their first and last
+ * 16 samples, shorter ones a masked load padded with their first sample.
+ *
+ * @param[in] src Pointer to source buffer
+ * @param nframes Number of samples to process
+ * @param fpp Number of samples per peak
+ * @param[out] peaks Pointer to ceil (nframes / fpp) peaks
+ */
+void
+x86_avx512f_reduce_peaks (const float* src, uint32_t nframes, uint32_t fpp, ARDOUR::PeakData* peaks)
+{
+	while (nframes > 0) {
+		const uint32_t n = fpp < nframes ? fpp : nframes;
+
+		__m512 vmin0, vmax0, vmin1, vmax1;
+
+		if (n < 16) {
+			vmin0 = _mm512_mask_loadu_ps (_mm512_set1_ps (src[0]), tail_mask (n), src);
+			vmin1 = vmin0;
+		} else {
+			vmin0 = _mm512_loadu_ps (src);
+			vmin1 = _mm512_loadu_ps (src + n - 16);
+		}
+
+		vmax0 = vmin0;
+		vmax1 = vmin1;
+
+		uint32_t i = 16;
+
+		for (; i + 32 <= n; i += 32) {
+			__m512 x0 = _mm512_loadu_ps (src + i);
+			__m512 x1 = _mm512_loadu_ps (src + i + 16);
+			vmin0 = _mm512_min_ps (vmin0, x0);
+			vmax0 = _mm512_max_ps (vmax0, x0);
+			vmin1 = _mm512_min_ps (vmin1, x1);
+			vmax1 = _mm512_max_ps (vmax1, x1);
+		}
+
+		if (i + 16 <= n) {
+			__m512 x0 = _mm512_loadu_ps (src + i);
+			vmin0 = _mm512_min_ps (vmin0, x0);
+			vmax0 = _mm512_max_ps (vmax0, x0);
+		}
+
+		peaks->max = _mm512_reduce_max_ps (_mm512_max_ps (vmax0, vmax1));
+		peaks->min = _mm512_reduce_min_ps (_mm512_min_ps (vmin0, vmin1));
+
+		++peaks;
+		src += n;
+		nframes -= n;
+	}
+}
+
+#endif
@@ -38,6 +38,7 @@
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <iterator>
 #include <utility>
 
 #include "evoral/ControlList.h"
@@ -73,10 +74,8 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc,
 	_frozen = 0;
 	_changed_when_thawed = false;
 	_lookup_cache.left = timepos_t::max (_time_domain);
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
 	_search_cache.left = timepos_t::max (_time_domain);
-	_search_cache.first = _events.end();
+	_index_dirty = false;
 	_sort_pending = false;
 	new_write_pass = true;
 	_in_write_pass = false;
@@ -94,9 +93,7 @@ ControlList::ControlList (const ControlList& other)
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.first = _events.end();
+	_index_dirty = false;
 	_sort_pending = false;
 	new_write_pass = true;
 	_in_write_pass = false;
@@ -117,9 +114,7 @@ ControlList::ControlList (const ControlList& other, timepos_t const & start, tim
 {
 	_frozen = 0;
 	_changed_when_thawed = false;
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
-	_search_cache.first = _events.end();
+	_index_dirty = false;
 	_sort_pending = false;
 
 	/* now grab the relevant points, and shift them back if necessary */
@@ -320,7 +315,7 @@ ControlList::list_merge (ControlList const& other, boost::function<double(double
 			if (found) {
 				continue;
 			}
-			float val = callback (unlocked_eval ((*i)->when), (*i)->value);
+			float val = callback (list_eval ((*i)->when), (*i)->value);
 			nel.push_back (new ControlEvent ((*i)->when, val));
 		}
 		nel.sort (event_time_less_than);
@@ -435,7 +430,18 @@ ControlList::fast_simple_add (timepos_t const & time, double value)
 	assert (time.time_domain() == _time_domain);
 	_events.insert (_events.end(), new ControlEvent (time, value));
 
-	mark_dirty ();
+	if (!_frozen && !_index_dirty && (_index.empty () || _index.back ().when <= time)) {
+		/* avoid rebuilding the index for each point */
+		_index.push_back (IndexEntry (_events.back ()));
+		_lookup_cache.left = timepos_t::max (_time_domain);
+		_search_cache.left = timepos_t::max (_time_domain);
+		if (_curve) {
+			_curve->mark_dirty ();
+		}
+	} else {
+		mark_dirty ();
+	}
+
 	if (_frozen) {
 		_sort_pending = true;
 	}
@@ -574,7 +580,7 @@ ControlList::add_guard_point (timepos_t const & time, timecnt_t const & offset)
 	ControlEvent cp (when, 0.0);
 	most_recent_insert_iterator = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
 
-	double eval_value = unlocked_eval (when);
+	double eval_value = list_eval (when);
 
 	if (most_recent_insert_iterator == _events.end()) {
 
@@ -1055,11 +1061,11 @@ ControlList::shift (timepos_t const & time, timecnt_t const & distance)
 			 * for "remove time". The time [pos.. pos-frames] is removed.
 			 * and everyhing after, moved backwards.
 			 */
-			v0 = unlocked_eval (pos);
-			v1 = unlocked_eval (pos.earlier (distance));
+			v0 = list_eval (pos);
+			v1 = list_eval (pos.earlier (distance));
 			erase_range_internal (pos, pos.earlier (distance), _events);
 		} else {
-			v0 = v1 = unlocked_eval (pos);
+			v0 = v1 = list_eval (pos);
 		}
 
 		bool dst_guard_exists = false;
@@ -1192,24 +1198,61 @@ ControlList::thaw ()
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
 		}
+
+		if (_index_dirty) {
+			mark_dirty ();
+		}
 	}
 	maybe_signal_changed ();
 }
 
+const ControlList::EventList&
+ControlList::script_events ()
+{
+	Glib::Threads::RWLock::WriterLock lm (_lock);
+	/* the caller may modify the events behind our back, fall back to
+	 * the list until the next edit rebuilds the index.
+	 */
+	_index_dirty = true;
+	return _events;
+}
+
 void
 ControlList::mark_dirty () const
 {
+	if (_frozen) {
+		_index_dirty = true;
+	} else {
+		unlocked_update_index ();
+	}
+
 	_lookup_cache.left = timepos_t::max (_time_domain);
-	_lookup_cache.range.first = _events.end();
-	_lookup_cache.range.second = _events.end();
+	_lookup_cache.range.first = 0;
+	_lookup_cache.range.second = 0;
 	_search_cache.left = timepos_t::max (_time_domain);
-	_search_cache.first = _events.end();
+	_search_cache.first = 0;
 
 	if (_curve) {
 		_curve->mark_dirty();
 	}
 }
 
+/** Rebuild the event index from the event list, caller must hold the writer lock
+ * (or be the only user of this list).
+ */
+void
+ControlList::unlocked_update_index () const
+{
+	_index.clear ();
+	_index.reserve (_events.size ());
+
+	for (const_iterator i = _events.begin (); i != _events.end (); ++i) {
+		_index.push_back (IndexEntry (*i));
+	}
+
+	_index_dirty = false;
+}
+
 void
 ControlList::truncate_end (timepos_t const & last_time)
 {
@@ -1269,7 +1312,7 @@ ControlList::truncate_end (timepos_t const & last_time)
 
 			/* shortening end */
 
-			last_val = unlocked_eval (last_coordinate);
+			last_val = list_eval (last_coordinate);
 			last_val = max ((double) _desc.lower, last_val);
 			last_val = min ((double) _desc.upper, last_val);
 
@@ -1371,7 +1414,7 @@ ControlList::truncate_start (timecnt_t const & overall)
 			/* shrinking at front */
 
 			first_legal_coordinate = _events.back()->when.earlier (overall_length);
-			first_legal_value = unlocked_eval (first_legal_coordinate);
+			first_legal_value = list_eval (first_legal_coordinate);
 			first_legal_value = max ((double)_desc.lower, first_legal_value);
 			first_legal_value = min ((double)_desc.upper, first_legal_value);
 
@@ -1414,42 +1457,70 @@ ControlList::truncate_start (timecnt_t const & overall)
 	maybe_signal_changed ();
 }
 
+/* accessors, so that the lookup code below works on both the event
+ * list and the event index.
+ */
+static inline timepos_t const & ev_when (ControlList::const_iterator i) { return (*i)->when; }
+static inline double ev_value (ControlList::const_iterator i) { return (*i)->value; }
+static inline timepos_t const & ev_when (ControlList::EventIndex::const_iterator i) { return i->when; }
+static inline double ev_value (ControlList::EventIndex::const_iterator i) { return i->value; }
+
 double
 ControlList::unlocked_eval (timepos_t const & xtime) const
 {
-	pair<EventList::iterator,EventList::iterator> range;
-	int32_t npoints;
+	if (_index_dirty) {
+		/* modified while frozen, the index is not up to date */
+		return list_eval (xtime);
+	}
+	EventIndex const & index (_index);
+	return eval_events (index.begin(), index.end(), xtime, true);
+}
+
+double
+ControlList::list_eval (timepos_t const & xtime) const
+{
+	return eval_events (_events.begin(), _events.end(), xtime, false);
+}
+
+template<typename Iter> double
+ControlList::eval_events (Iter begin, Iter end, timepos_t const & xtime, bool use_cache) const
+{
 	timepos_t lpos, upos;
 	double lval, uval;
 	double fraction;
 	double xx;
 	double ll;
+	int32_t npoints;
 
-	const_iterator length_check_iter = _events.begin();
+	Iter length_check_iter = begin;
 	for (npoints = 0; npoints < 4; ++npoints, ++length_check_iter) {
-		if (length_check_iter == _events.end()) {
+		if (length_check_iter == end) {
 			break;
 		}
 	}
 
-	switch (npoints) {
-	case 0:
+	if (npoints == 0) {
 		return _desc.normal;
+	}
 
+	Iter last = end;
+	--last;
+
+	switch (npoints) {
 	case 1:
-		return _events.front()->value;
+		return ev_value (begin);
 
 	case 2:
-		if (xtime >= _events.back()->when) {
-			return _events.back()->value;
-		} else if (xtime <= _events.front()->when) {
-			return _events.front()->value;
+		if (xtime >= ev_when (last)) {
+			return ev_value (last);
+		} else if (xtime <= ev_when (begin)) {
+			return ev_value (begin);
 		}
 
-		lpos = _events.front()->when;
-		lval = _events.front()->value;
-		upos = _events.back()->when;
-		uval = _events.back()->value;
+		lpos = ev_when (begin);
+		lval = ev_value (begin);
+		upos = ev_when (last);
+		uval = ev_value (last);
 
 		xx = lpos.distance (xtime).distance().val();
 		ll = lpos.distance (upos).distance().val();
@@ -1471,21 +1542,53 @@ ControlList::unlocked_eval (timepos_t const & xtime) const
 		}
 
 	default:
-		if (xtime >= _events.back()->when) {
-			return _events.back()->value;
-		} else if (xtime <= _events.front()->when) {
-			return _events.front()->value;
+		if (xtime >= ev_when (last)) {
+			return ev_value (last);
+		} else if (xtime <= ev_when (begin)) {
+			return ev_value (begin);
 		}
 
-		return multipoint_eval (xtime);
+		return multipoint_eval (begin, end, xtime, use_cache);
 	}
 
 	abort(); /*NOTREACHED*/ /* stupid gcc */
 	return _desc.normal;
 }
 
-double
-ControlList::multipoint_eval (timepos_t const & xtime) const
+/** Find the events equivalent to @p xtime in the index, using (and updating) the lookup cache
+ * if @p use_cache is true.
+ */
+pair<ControlList::EventIndex::const_iterator, ControlList::EventIndex::const_iterator>
+ControlList::lookup_range (EventIndex::const_iterator begin, EventIndex::const_iterator end, timepos_t const & xtime, bool use_cache) const
+{
+	if (!use_cache) {
+		return equal_range (begin, end, xtime, TimeComparator ());
+	}
+
+	/* Only do the range lookup if xtime is in a different range than last time
+	 * this was called (or if the lookup cache has been marked "dirty" (left<0) */
+	if ((_lookup_cache.left == timepos_t::max (_time_domain)) ||
+	    ((_lookup_cache.left > xtime) ||
+	     (_lookup_cache.range.second >= (EventIndex::size_type) (end - begin)) ||
+	     (begin[_lookup_cache.range.second].when < xtime))) {
+
+		pair<EventIndex::const_iterator, EventIndex::const_iterator> range = equal_range (begin, end, xtime, TimeComparator ());
+
+		_lookup_cache.range.first = range.first - begin;
+		_lookup_cache.range.second = range.second - begin;
+	}
+
+	return make_pair (begin + _lookup_cache.range.first, begin + _lookup_cache.range.second);
+}
+
+pair<ControlList::const_iterator, ControlList::const_iterator>
+ControlList::lookup_range (const_iterator begin, const_iterator end, timepos_t const & xtime, bool) const
+{
+	return equal_range (begin, end, xtime, TimeComparator ());
+}
+
+template<typename Iter> double
+ControlList::multipoint_eval (Iter begin, Iter end, timepos_t const & xtime, bool use_cache) const
 {
 	timepos_t upos, lpos;
 	double uval, lval;
@@ -1494,55 +1597,44 @@ ControlList::multipoint_eval (timepos_t const & xtime) const
 	/* "Stepped" lookup (no interpolation) */
 	/* FIXME: no cache.  significant? */
 	if (_interpolation == Discrete) {
-		const ControlEvent cp (xtime, 0);
-		EventList::const_iterator i = lower_bound (_events.begin(), _events.end(), &cp, time_comparator);
+		Iter i = lower_bound (begin, end, xtime, TimeComparator ());
 
 		// shouldn't have made it to multipoint_eval
-		assert(i != _events.end());
+		assert(i != end);
 
-		if (i == _events.begin() || (*i)->when == xtime)
-			return (*i)->value;
+		if (i == begin || ev_when (i) == xtime)
+			return ev_value (i);
 		else
-			return (*(--i))->value;
-	}
-
-	/* Only do the range lookup if xtime is in a different range than last time
-	 * this was called (or if the lookup cache has been marked "dirty" (left<0) */
-	if ((_lookup_cache.left == timepos_t::max (_time_domain)) ||
-	    ((_lookup_cache.left > xtime) ||
-	     (_lookup_cache.range.first == _events.end()) ||
-	     ((*_lookup_cache.range.second)->when < xtime))) {
-
-		const ControlEvent cp (xtime, 0);
-
-		_lookup_cache.range = equal_range (_events.begin(), _events.end(), &cp, time_comparator);
+			return ev_value (--i);
 	}
 
-	pair<const_iterator,const_iterator> range = _lookup_cache.range;
+	pair<Iter,Iter> range = lookup_range (begin, end, xtime, use_cache);
 
 	if (range.first == range.second) {
 
 		/* x does not exist within the list as a control point */
 
-		_lookup_cache.left = xtime;
+		if (use_cache) {
+			_lookup_cache.left = xtime;
+		}
 
-		if (range.first != _events.begin()) {
+		if (range.first != begin) {
 			--range.first;
-			lpos = (*range.first)->when;
-			lval = (*range.first)->value;
+			lpos = ev_when (range.first);
+			lval = ev_value (range.first);
 		}  else {
 			/* we're before the first point */
 			// return _default_value;
-			return _events.front()->value;
+			return ev_value (begin);
 		}
 
-		if (range.second == _events.end()) {
+		if (range.second == end) {
 			/* we're after the last point */
-			return _events.back()->value;
+			return ev_value (--end);
 		}
 
-		upos = (*range.second)->when;
-		uval = (*range.second)->value;
+		upos = ev_when (range.second);
+		uval = ev_value (range.second);
 
 		fraction = (double) lpos.distance (xtime).distance().val() / (double) lpos.distance (upos).distance().val();
 
@@ -1565,8 +1657,10 @@ ControlList::multipoint_eval (timepos_t const & xtime) const
 	}
 
 	/* x is a control point in the data */
-	_lookup_cache.left = timepos_t::max (_time_domain);
-	return (*range.first)->value;
+	if (use_cache) {
+		_lookup_cache.left = timepos_t::max (_time_domain);
+	}
+	return ev_value (range.first);
 }
 
 void
@@ -1574,29 +1668,49 @@ ControlList::build_search_cache_if_necessary (timepos_t const & start_time) cons
 {
 	timepos_t start = start_time;
 
-	if (_events.empty()) {
+	EventIndex const & index (_index);
+
+	if (index.empty()) {
 		/* Empty, nothing to cache, move to end. */
-		_search_cache.first = _events.end();
+		_search_cache.first = 0;
 		_search_cache.left = timepos_t::max (_time_domain);
 		return;
 	} else if ((_search_cache.left == timepos_t::max (_time_domain)) || (_search_cache.left > start)) {
 		/* Marked dirty (left == max), or we're too far forward, re-search. */
 
-		const ControlEvent start_point (start, 0);
-
-		_search_cache.first = lower_bound (_events.begin(), _events.end(), &start_point, time_comparator);
+		_search_cache.first = lower_bound (index.begin(), index.end(), start, TimeComparator ()) - index.begin();
 		_search_cache.left = start;
 	}
 
 	/* We now have a search cache that is not too far right, but it may be too
 	   far left and need to be advanced. */
 
-	while (_search_cache.first != end() && (*_search_cache.first)->when < start) {
+	while (_search_cache.first < index.size() && index[_search_cache.first].when < start) {
 		++_search_cache.first;
 	}
 	_search_cache.left = start;
 }
 
+/** Find the first event at or after @p start (after it if @p inclusive is false),
+ * using the search cache if @p use_cache is true.
+ */
+template<typename Iter> Iter
+ControlList::search_events (Iter begin, Iter end, timepos_t const & start, bool inclusive, bool use_cache) const
+{
+	if (!use_cache) {
+		if (inclusive) {
+			return lower_bound (begin, end, start, TimeComparator ());
+		}
+		return upper_bound (begin, end, start, TimeComparator ());
+	}
+
+	build_search_cache_if_necessary (start);
+
+	Iter i = begin;
+	std::advance (i, _search_cache.first);
+	return i;
+}
+
 /** Get the earliest event after \a start without interpolation.
  *
  * If an event is found, \a x and \a y are set to its coordinates.
@@ -1606,26 +1720,37 @@ ControlList::build_search_cache_if_necessary (timepos_t const & start_time) cons
  */
 bool
 ControlList::rt_safe_earliest_event_discrete_unlocked (timepos_t const & start_time, timepos_t & x, double& y, bool inclusive) const
+{
+	if (_index_dirty) {
+		/* modified while frozen, the index is not up to date */
+		return earliest_event_discrete (_events.begin(), _events.end(), start_time, x, y, inclusive, false);
+	}
+	return earliest_event_discrete (_index.begin(), _index.end(), start_time, x, y, inclusive, true);
+}
+
+template<typename Iter> bool
+ControlList::earliest_event_discrete (Iter begin, Iter end, timepos_t const & start_time, timepos_t & x, double& y, bool inclusive, bool use_cache) const
 {
 	timepos_t start = start_time;
 
-	build_search_cache_if_necessary (start);
+	Iter first = search_events (begin, end, start, inclusive, use_cache);
 
-	if (_search_cache.first != _events.end()) {
-		const ControlEvent* const first = *_search_cache.first;
+	if (first != end) {
 
-		const bool past_start = (inclusive ? first->when >= start : first->when > start);
+		const bool past_start = (inclusive ? ev_when (first) >= start : ev_when (first) > start);
 
 		/* Earliest points is in range, return it */
 		if (past_start) {
 
-			x = first->when;
-			y = first->value;
+			x = ev_when (first);
+			y = ev_value (first);
 
-			/* Move left of cache to this point
-			 * (Optimize for immediate call this cycle within range) */
-			_search_cache.left = first->when;
-			++_search_cache.first;
+			if (use_cache) {
+				/* Move left of cache to this point
+				 * (Optimize for immediate call this cycle within range) */
+				_search_cache.left = x;
+				++_search_cache.first;
+			}
 
 			assert(x >= start);
 			return true;
@@ -1650,8 +1775,6 @@ ControlList::rt_safe_earliest_event_discrete_unlocked (timepos_t const & start_t
 bool
 ControlList::rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t const & start_time, Temporal::timepos_t & x, double& y, bool inclusive, Temporal::timecnt_t min_x_delta) const
 {
-	timepos_t start = start_time;
-
 	/* the max value is given as an out-of-bounds default value, when the
 	   true default is zero, but the time-domain is not known at compile
 	   time. This allows us to reset it to zero with the correct time
@@ -1664,29 +1787,41 @@ ControlList::rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t const &
 		min_x_delta = Temporal::timecnt_t (time_domain());
 	}
 
+	if (_index_dirty) {
+		/* modified while frozen, the index is not up to date */
+		return earliest_event_linear (_events.begin(), _events.end(), start_time, x, y, inclusive, min_x_delta, false);
+	}
+	return earliest_event_linear (_index.begin(), _index.end(), start_time, x, y, inclusive, min_x_delta, true);
+}
+
+template<typename Iter> bool
+ControlList::earliest_event_linear (Iter begin, Iter end, Temporal::timepos_t const & start_time, Temporal::timepos_t & x, double& y, bool inclusive, Temporal::timecnt_t const & min_x_delta, bool use_cache) const
+{
+	timepos_t start = start_time;
+
 	// cout << "earliest_event(start: " << start << ", x: " << x << ", y: " << y << ", inclusive: " << inclusive <<  ") mxd " << min_x_delta << endl;
 
-	const_iterator length_check_iter = _events.begin();
-	if (_events.empty()) {
+	if (begin == end) {
 		/* no events, so we cannot interpolate */
 		return false;
-	} else if (_events.end() == ++length_check_iter) {
+	} else if (std::next (begin) == end) {
 		/* one event, which decomposes to the same logic as the discrete one */
-		return rt_safe_earliest_event_discrete_unlocked (start + min_x_delta, x, y, inclusive);
+		return earliest_event_discrete (begin, end, start + min_x_delta, x, y, inclusive, use_cache);
 	}
 
 	if (min_x_delta > 0) {
 		/* if there is an event between [start ... start + min_x_delta], use it,
 		 */
-		build_search_cache_if_necessary (start);
-		const ControlEvent* first = *_search_cache.first;
-		if (_search_cache.first != _events.end()) {
-			if (((first->when > start) || (inclusive && first->when == start)) && first->when < start + min_x_delta) {
-				x = first->when;
-				y = first->value;
-				/* Move left of cache to this point
-				 * (Optimize for immediate call this cycle within range) */
-				_search_cache.left = x;
+		Iter first = search_events (begin, end, start, inclusive, use_cache);
+		if (first != end) {
+			if (((ev_when (first) > start) || (inclusive && ev_when (first) == start)) && ev_when (first) < start + min_x_delta) {
+				x = ev_when (first);
+				y = ev_value (first);
+				if (use_cache) {
+					/* Move left of cache to this point
+					 * (Optimize for immediate call this cycle within range) */
+					_search_cache.left = x;
+				}
 				return true;
 			}
 		}
@@ -1699,63 +1834,71 @@ ControlList::rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t const &
 	start += min_x_delta;
 
 	// Hack to avoid infinitely repeating the same event
-	build_search_cache_if_necessary (start);
+	Iter pos = search_events (begin, end, start, true, use_cache);
 
-	if (_search_cache.first == _events.end()) {
+	if (pos == end) {
 		/* No points in the future, so no steps (towards them) in the future */
 		return false;
 	}
 
-	const ControlEvent* first = NULL;
-	const ControlEvent* next = NULL;
+	Iter first;
+	Iter next;
 
-	if (_search_cache.first == _events.begin() || (*_search_cache.first)->when <= start) {
+	if (pos == begin || ev_when (pos) <= start) {
 		/* Start is after first */
-		first = *_search_cache.first;
-		++_search_cache.first;
-		if (_search_cache.first == _events.end()) {
+		first = pos;
+		next = std::next (pos);
+		if (use_cache) {
+			++_search_cache.first;
+		}
+		if (next == end) {
 			/* no later events, nothing to interpolate towards */
 			return false;
 		}
-		next = *_search_cache.first;
 
 	} else {
 		/* Start is before first */
-		assert (_search_cache.first != _events.begin());
-		const_iterator prev = _search_cache.first;
-		--prev;
-		first = *prev;
-		next = *_search_cache.first;
+		first = std::prev (pos);
+		next = pos;
 	}
 
-	if (inclusive && first->when == start) {
+	const timepos_t first_when = ev_when (first);
+	const double    first_value = ev_value (first);
+	const timepos_t next_when = ev_when (next);
+	const double    next_value = ev_value (next);
+
+	if (inclusive && first_when == start) {
 		/* existing point matches start */
 
-		x = first->when;
-		y = first->value;
-		/* Move left of cache to this point
-		 * (Optimize for immediate call this cycle within range)
-		 */
-		_search_cache.left = first->when;
+		x = first_when;
+		y = first_value;
+		if (use_cache) {
+			/* Move left of cache to this point
+			 * (Optimize for immediate call this cycle within range)
+			 */
+			_search_cache.left = first_when;
+		}
 		return true;
-	} else if (next->when < start || (!inclusive && next->when == start)) {
+	} else if (next_when < start || (!inclusive && next_when == start)) {
 		/* "Next" is before the start, no points left. */
 		return false;
 	}
 
-	if (fabs (first->value - next->value) <= 1) {
+	if (fabs (first_value - next_value) <= 1) {
 
 		/* delta between the two spanning points is <= 1,
 		   consider the next point as the answer, but only if the next
 		   point is actually beyond @param start.
 		*/
 
-		if (next->when > start) {
-			x = next->when;
-			y = next->value;
-			/* Move left of cache to this point
-			 * (Optimize for immediate call this cycle within range) */
-			_search_cache.left = next->when;
+		if (next_when > start) {
+			x = next_when;
+			y = next_value;
+			if (use_cache) {
+				/* Move left of cache to this point
+				 * (Optimize for immediate call this cycle within range) */
+				_search_cache.left = next_when;
+			}
 			return true;
 		} else {
 			/* no suitable point can be determined */
@@ -1763,23 +1906,23 @@ ControlList::rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t const &
 		}
 	}
 
-	const double slope = (next->value - first->value) / (double) first->when.distance (next->when).distance().val();
+	const double slope = (next_value - first_value) / (double) first_when.distance (next_when).distance().val();
 
 	//cerr << "start y: " << start_y << endl;
 
-	//y = first->value + (slope * fabs(start - first->when));
-	y = first->value;
+	//y = first_value + (slope * fabs(start - first_when));
+	y = first_value;
 
-	if (first->value < next->value) { // ramping up
+	if (first_value < next_value) { // ramping up
 		y = ceil(y);
 	} else { // ramping down
 		y = floor(y);
 	}
 
 	if (_time_domain == AudioTime) {
-		x = first->when + timepos_t (samplepos_t ((y - first->value) / (double)slope));
+		x = first_when + timepos_t (samplepos_t ((y - first_value) / (double)slope));
 	} else {
-		x = first->when + timepos_t::from_ticks ((y - first->value) / (double)slope);
+		x = first_when + timepos_t::from_ticks ((y - first_value) / (double)slope);
 	}
 
 	/* Now iterate until x has a suitable relationship to start (depending
@@ -1788,43 +1931,46 @@ ControlList::rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t const &
 	 * point.
 	 */
 
-	const double delta = (first->value < next->value) ? 1.0 /* ramping up */ : -1.0; /* ramping down */
+	const double delta = (first_value < next_value) ? 1.0 /* ramping up */ : -1.0; /* ramping down */
 
-	while ((inclusive && x < start) || (x <= start && y != next->value)) {
+	while ((inclusive && x < start) || (x <= start && y != next_value)) {
 
 		y += delta;
 
 		if (_time_domain == AudioTime) {
-			x = first->when + timepos_t (samplepos_t ((y - first->value) / (double)slope));
+			x = first_when + timepos_t (samplepos_t ((y - first_value) / (double)slope));
 		} else {
-			x = first->when + timepos_t::from_ticks (int64_t ((y - first->value) / (double)slope));
+			x = first_when + timepos_t::from_ticks (int64_t ((y - first_value) / (double)slope));
 		}
 	}
 
-	assert ((y >= first->value && y <= next->value) || (y <= first->value && y >= next->value) );
+	assert ((y >= first_value && y <= next_value) || (y <= first_value && y >= next_value) );
 
 	const bool past_start = (inclusive ? x >= start : x > start);
 
 	if (past_start) {
-		/* Move left of cache to this point
-		 * (Optimize for immediate call this cycle within range) */
-		_search_cache.left = x;
+		if (use_cache) {
+			/* Move left of cache to this point
+			 * (Optimize for immediate call this cycle within range) */
+			_search_cache.left = x;
+		}
 		assert(inclusive ? x >= start : x > start);
 		return true;
 	}
 
 	if (inclusive) {
-		x = next->when;
-		_search_cache.left = next->when;
+		x = next_when;
 	} else {
 		x = start;
+	}
+
+	if (use_cache) {
 		_search_cache.left = x;
 	}
 
 	return true;
 }
 
-
 /** @param start Start position in model coordinates.
  *  @param end End position in model coordinates.
  *  @param op 0 = cut, 1 = copy, 2 = clear.
@@ -1868,11 +2014,11 @@ ControlList::cut_copy_clear (timepos_t const & start_time, timepos_t const & end
 		   at "end".
 		*/
 
-		double end_value = unlocked_eval (end);
+		double end_value = list_eval (end);
 
 		if ((*s)->when != start) {
 
-			double val = unlocked_eval (start);
+			double val = list_eval (start);
 
 			if (op == 0) { // cut
 				if (start > _events.front()->when) {
@@ -202,7 +202,7 @@ Curve::get_vector (Temporal::timepos_t const & x0, Temporal::timepos_t const & x
 void
 Curve::_get_vector (Temporal::timepos_t const & x0, Temporal::timepos_t const & x1, float *vec, int32_t veclen) const
 {
-	double rx, lx, hx;
+	double lx, hx;
 	const double start = x0.val();
 	const double end = x1.val();
 	double max_x;
@@ -368,119 +368,167 @@ Curve::_get_vector (Temporal::timepos_t const & x0, Temporal::timepos_t const &
 		solve ();
 	}
 
-	rx = lx;
-
 	double dx = 0.;
 
 	if (veclen > 1) {
 		dx = (hx - lx) / (veclen - 1);
 	}
 
-	for (i = 0; i < veclen; ++i, rx += dx) {
-		vec[i] = multipoint_eval (x0.is_beats() ? Temporal::timepos_t::from_ticks (rx) : Temporal::timepos_t::from_superclock (rx));
+	if (_list.index_valid ()) {
+		render (_list.event_index().begin(), _list.event_index().end(), lx, dx, vec, veclen);
+	} else {
+		/* the list was modified while frozen, use the list itself */
+		render (_list.events().begin(), _list.events().end(), lx, dx, vec, veclen);
 	}
 }
 
-double
-Curve::multipoint_eval (Temporal::timepos_t const & x) const
+static inline double ev_when (ControlList::EventList::const_iterator i) { return (*i)->when.val(); }
+static inline double ev_value (ControlList::EventList::const_iterator i) { return (*i)->value; }
+static inline const ControlEvent* ev_event (ControlList::EventList::const_iterator i) { return *i; }
+static inline double ev_when (ControlList::EventIndex::const_iterator i) { return i->when.val(); }
+static inline double ev_value (ControlList::EventIndex::const_iterator i) { return i->value; }
+static inline const ControlEvent* ev_event (ControlList::EventIndex::const_iterator i) { return i->event; }
+
+/* for std::upper_bound() using raw time values */
+struct WhenComparator {
+	bool operator() (double x, const ControlEvent* ev) const { return x < ev->when.val(); }
+	bool operator() (double x, ControlList::IndexEntry const & e) const { return x < e.when.val(); }
+};
+
+/** Fill @p vec with @p veclen values at x = lx + i * dx, walking the list
+ * segment by segment rather than searching for every single sample.
+ */
+template<typename Iter> void
+Curve::render (Iter begin, Iter end, double lx, double dx, float* vec, int32_t veclen) const
 {
-	pair<ControlList::EventList::const_iterator,ControlList::EventList::const_iterator> range;
-
-	ControlList::LookupCache& lookup_cache = _list.lookup_cache();
-
-	if ((lookup_cache.left == Temporal::timepos_t::max (_list.time_domain())) ||
-	    ((lookup_cache.left > x) ||
-	     (lookup_cache.range.first == _list.events().end()) ||
-	     ((*lookup_cache.range.second)->when < x))) {
-
-		ControlEvent cp (x, 0.0);
-
-		lookup_cache.range = equal_range (_list.events().begin(), _list.events().end(), &cp, ControlList::time_comparator);
-	}
-
-	range = lookup_cache.range;
-
-	/* EITHER
+	Iter after = upper_bound (begin, end, lx, WhenComparator());
+	int32_t i = 0;
 
-	   a) x is an existing control point, so first == existing point, second == next point
+	while (i < veclen) {
 
-	   OR
+		const double rx = lx + i * dx;
 
-	   b) x is between control points, so range is empty (first == second, points to where
-	       to insert x)
-
-	*/
-
-	if (range.first == range.second) {
-
-		/* x does not exist within the list as a control point */
+		while (after != end && ev_when (after) <= rx) {
+			++after;
+		}
 
-		lookup_cache.left = x;
+		if (after == begin) {
+			/* before the first point */
+			vec[i++] = ev_value (begin);
+			continue;
+		}
 
-		if (range.first == _list.events().begin()) {
-			/* we're before the first point */
-			// return default_value;
-			return _list.events().front()->value;
+		if (after == end) {
+			/* at or after the last point */
+			const float val = ev_value (--end);
+			for (; i < veclen; ++i) {
+				vec[i] = val;
+			}
+			break;
 		}
 
-		if (range.second == _list.events().end()) {
-			/* we're after the last point */
-			return _list.events().back()->value;
+		Iter before = after;
+		--before;
+
+		/* number of samples before the next point */
+		int32_t n = veclen - i;
+		if (dx > 0) {
+			n = (int32_t) min ((double) n, ceil ((ev_when (after) - rx) / dx));
+			n = max (n, 1);
 		}
 
-		ControlEvent* after = (*range.second);
-		range.second--;
-		ControlEvent* before = (*range.second);
+		render_segment (ev_when (before), ev_value (before), ev_when (after), ev_value (after), ev_event (after), rx, dx, vec + i, n);
+		i += n;
+	}
+}
 
-		double vdelta = after->value - before->value;
+/** Interpolate @p n values between two adjacent points, starting at @p rx.
+ *
+ * Per-segment constants are computed once, and the linear and spline
+ * cases are plain loops without dependencies between iterations so that
+ * the compiler can vectorize them.
+ */
+void
+Curve::render_segment (double bw, double bv, double aw, double av, const ControlEvent* ev, double rx, double dx, float* vec, int32_t n) const
+{
+	const double vdelta = av - bv;
 
-		if (vdelta == 0.0) {
-			return before->value;
+	if (vdelta == 0.0) {
+		for (int32_t i = 0; i < n; ++i) {
+			vec[i] = bv;
 		}
+		return;
+	}
+
+	const double trange = aw - bw;
+	const double f0 = (rx - bw) / trange;
+	const double df = dx / trange;
 
-		double aw = after->when.val();
-		double bw = before->when.val();
-
-		double tdelta = x.val() - bw;
-		double trange = aw - bw;
-
-		switch (_list.interpolation()) {
-			case ControlList::Discrete:
-				return before->value;
-			case ControlList::Logarithmic:
-				return interpolate_logarithmic (before->value, after->value, tdelta / trange, _list.descriptor().lower, _list.descriptor().upper);
-			case ControlList::Exponential:
-				return interpolate_gain (before->value, after->value, tdelta / trange, _list.descriptor().upper);
-			case ControlList::Curved:
-				if (after->coeff) {
-					ControlEvent* ev = after;
-
-					/* As of Jan 2020, we only use Curved
-					 * for fade in/out curves (of audio
-					 * regions).
-					 *
-					 * This means that x is a relatively
-					 * small value (an offset into the
-					 * fade) amd we do not need to worry
-					 * about the square or cube overflowing
-					 * a double type. They can overflow an
-					 * int64_t by around 6 seconds.
-					 */
-
-					const double xv = x.val();
-					double xv2 = xv * xv;
-					return ev->coeff[0] + (ev->coeff[1] * xv) + (ev->coeff[2] * xv2) + (ev->coeff[3] * xv2 * xv);
+	switch (_list.interpolation()) {
+		case ControlList::Discrete:
+			for (int32_t i = 0; i < n; ++i) {
+				vec[i] = bv;
+			}
+			return;
+		case ControlList::Logarithmic:
+			{
+				/* interpolate_logarithmic() */
+				assert (bv > 0 && bv * av > 0);
+				const double ratio = av / bv;
+				for (int32_t i = 0; i < n; ++i) {
+					vec[i] = bv * pow (ratio, min (1.0, f0 + i * df));
 				}
-				/* fallthrough */
-			case ControlList::Linear:
-				return before->value + (vdelta * (tdelta / trange));
-		}
+			}
+			return;
+		case ControlList::Exponential:
+			{
+				/* interpolate_gain(), with the positions of both ends computed once */
+				const double upper = _list.descriptor().upper;
+				const double from = bv + TINY_NUMBER;
+				const double to = av + TINY_NUMBER;
+				if (fabs (to - from) < TINY_NUMBER) {
+					for (int32_t i = 0; i < n; ++i) {
+						vec[i] = to;
+					}
+					return;
+				}
+				const double g0 = gain_to_position (from * 2. / upper);
+				const double diff = gain_to_position (to * 2. / upper) - g0;
+				for (int32_t i = 0; i < n; ++i) {
+					vec[i] = position_to_gain (g0 + (f0 + i * df) * diff) * upper / 2.;
+				}
+			}
+			return;
+		case ControlList::Curved:
+			if (ev->coeff) {
+				/* As of Jan 2020, we only use Curved
+				 * for fade in/out curves (of audio
+				 * regions).
+				 *
+				 * This means that x is a relatively
+				 * small value (an offset into the
+				 * fade) amd we do not need to worry
+				 * about the square or cube overflowing
+				 * a double type. They can overflow an
+				 * int64_t by around 6 seconds.
+				 */
+				const double c0 = ev->coeff[0];
+				const double c1 = ev->coeff[1];
+				const double c2 = ev->coeff[2];
+				const double c3 = ev->coeff[3];
+				for (int32_t i = 0; i < n; ++i) {
+					const double xv = rx + i * dx;
+					vec[i] = c0 + xv * (c1 + xv * (c2 + xv * c3));
+				}
+				return;
+			}
+			/* fallthrough */
+		case ControlList::Linear:
+			for (int32_t i = 0; i < n; ++i) {
+				vec[i] = bv + vdelta * (f0 + i * df);
+			}
+			return;
 	}
-
-	/* x is a control point in the data */
-	/* invalidate the cached range because its not usable */
-	lookup_cache.left = Temporal::timepos_t::max (_list.time_domain());
-	return (*range.first)->value;
 }
 
 } // namespace Evoral
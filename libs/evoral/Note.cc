@@ -18,6 +18,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <glib.h>
@@ -31,8 +32,8 @@ namespace Evoral {
 
 template<typename Time>
 Note<Time>::Note(uint8_t chan, Time t, Time l, uint8_t n, uint8_t v)
-	: _on_event (MIDI_EVENT, t, 3, NULL, true)
-	, _off_event (MIDI_EVENT, t + l, 3, NULL, true)
+	: _on_event (MIDI_EVENT, t, 3, _on_buffer, false)
+	, _off_event (MIDI_EVENT, t + l, 3, _off_buffer, false)
 {
 	assert(chan < 16);
 
@@ -55,11 +56,16 @@ Note<Time>::Note(uint8_t chan, Time t, Time l, uint8_t n, uint8_t v)
 
 template<typename Time>
 Note<Time>::Note(const Note<Time>& copy)
-	: _on_event(copy._on_event, true)
-	, _off_event(copy._off_event, true)
+	: _on_event (MIDI_EVENT, copy.time(), 3, _on_buffer, false)
+	, _off_event (MIDI_EVENT, copy.end_time(), 3, _off_buffer, false)
 {
-	assert(_on_event.buffer());
-	assert(_off_event.buffer());
+	memcpy (_on_buffer, copy._on_buffer, sizeof (_on_buffer));
+	memcpy (_off_buffer, copy._off_buffer, sizeof (_off_buffer));
+
+	/* like copying the events, a copy gets new IDs */
+	_on_event.set_id (next_event_id ());
+	_off_event.set_id (next_event_id ());
+
 	/*
 	  assert(copy._on_event.size == 3);
 	  _on_event.buffer = _on_event_buffer;
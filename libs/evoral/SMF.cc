@@ -246,6 +246,52 @@ SMF::seek_to_start() const
 	}
 }
 
+/** Seek to the first event at or after \a pulses (in SMF ticks).
+ *
+ * The events of the track are in memory and in time order, so this is a
+ * bisection rather than a read from the start of the track.
+ *
+ * \return the time (in SMF ticks) that the delta time of the next event
+ * read by read_event() is relative to.
+ */
+uint64_t
+SMF::seek_to_time(uint64_t pulses) const
+{
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+
+	if (!_smf_track) {
+		cerr << "WARNING: SMF seek_to_time() with no track" << endl;
+		return 0;
+	}
+
+	const size_t n_events = _smf_track->number_of_events;
+
+	size_t lo = 1;
+	size_t hi = n_events + 1;
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (smf_track_get_event_by_number (_smf_track, mid)->time_pulses < pulses) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo > n_events) {
+		/* nothing at or after pulses */
+		_smf_track->next_event_number = 0;
+		return n_events ? smf_track_get_event_by_number (_smf_track, n_events)->time_pulses : 0;
+	}
+
+	smf_event_t* event = smf_track_get_event_by_number (_smf_track, lo);
+
+	_smf_track->next_event_number  = lo;
+	_smf_track->time_of_next_event = event->time_pulses;
+
+	return event->time_pulses - event->delta_time_pulses;
+}
+
 /** Read an event from the current position in file.
  *
  * File position MUST be at the beginning of a delta time, or this will die very messily.
@@ -0,0 +1,638 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include "pbd/gstdio_compat.h"
+
+#include "evoral/SMFIndex.h"
+#include "evoral/midi_util.h"
+
+using namespace std;
+
+namespace Evoral {
+
+static const char     index_magic[4] = { 'E', 'v', 'I', 'x' };
+static const uint32_t index_version  = 1;
+
+template<typename T> static bool
+write_value (FILE* f, T const & value)
+{
+	return fwrite (&value, sizeof (T), 1, f) == 1;
+}
+
+template<typename T> static bool
+read_value (FILE* f, T& value)
+{
+	return fread (&value, sizeof (T), 1, f) == 1;
+}
+
+/** @return the big endian number of @a n bytes at @a buf */
+static uint32_t
+read_be (uint8_t const* buf, size_t n)
+{
+	uint32_t value = 0;
+	for (size_t i = 0; i < n; ++i) {
+		value = (value << 8) | buf[i];
+	}
+	return value;
+}
+
+static bool
+file_stat (std::string const & path, uint64_t& size, int64_t& mtime)
+{
+	GStatBuf statbuf;
+
+	if (g_stat (path.c_str (), &statbuf)) {
+		return false;
+	}
+
+	size  = statbuf.st_size;
+	mtime = statbuf.st_mtime;
+	return true;
+}
+
+SMFIndex::SMFIndex ()
+{
+	clear ();
+}
+
+void
+SMFIndex::clear ()
+{
+	_file_size        = 0;
+	_file_mtime       = 0;
+	_track            = 0;
+	_ppqn             = 0;
+	_track_start      = 0;
+	_track_end        = 0;
+	_empty            = true;
+	_length_pulses    = 0;
+	_n_note_on_events = 0;
+	_has_pgm_change   = false;
+	_lowest_note      = 127;
+	_highest_note     = 0;
+
+	_used_channels.reset ();
+	_buckets.clear ();
+}
+
+/** Index the SMF at @a path, by reading it once.
+ *
+ * Only the events of @a track (1-based) are indexed, the other tracks only
+ * add to the length, channel and note information.
+ *
+ * \return  0 on success
+ *         -1 if the file can not be read, or does not use tempo-based time
+ *         -2 if the file exists but specified track does not exist
+ */
+int
+SMFIndex::build (std::string const & path, int track)
+{
+	assert (track >= 1);
+
+	clear ();
+
+	if (!file_stat (path, _file_size, _file_mtime)) {
+		return -1;
+	}
+
+	FILE* f = g_fopen (path.c_str (), "rb");
+
+	if (!f) {
+		return -1;
+	}
+
+	uint8_t header[14];
+
+	if (fread (header, 1, sizeof (header), f) != sizeof (header) || memcmp (header, "MThd", 4)) {
+		fclose (f);
+		return -1;
+	}
+
+	const uint32_t header_size = read_be (header + 4, 4);
+	const uint16_t num_tracks  = read_be (header + 10, 2);
+	const uint16_t division    = read_be (header + 12, 2);
+
+	if (header_size < 6 || division == 0 || (division & 0x8000)) {
+		/* SMPTE-based time is not supported, as in Evoral::SMF */
+		fclose (f);
+		return -1;
+	}
+
+	_track = track;
+	_ppqn  = division;
+
+	uint64_t pos = 8 + header_size;
+	int      n   = 0;
+
+	while (n < num_tracks && fseek (f, pos, SEEK_SET) == 0) {
+
+		uint8_t chunk[8];
+
+		if (fread (chunk, 1, sizeof (chunk), f) != sizeof (chunk)) {
+			break;
+		}
+
+		const uint64_t start = pos + sizeof (chunk);
+		const uint64_t end   = start + read_be (chunk + 4, 4);
+
+		if (!memcmp (chunk, "MTrk", 4)) {
+			++n;
+			if (n == track) {
+				_track_start = start;
+				_track_end   = std::min (end, _file_size);
+			}
+			scan_track (path, start, std::min (end, _file_size), n == track);
+		}
+
+		pos = end;
+	}
+
+	fclose (f);
+
+	return (n < track) ? -2 : 0;
+}
+
+void
+SMFIndex::scan_track (std::string const & path, uint64_t start, uint64_t end, bool indexed)
+{
+	Reader reader (path, start, end);
+
+	uint64_t   time         = 0; /* in SMF ticks */
+	uint64_t   bucket       = 0;
+	uint32_t   scratch_size = 0;
+	uint32_t   delta_t      = 0;
+	uint32_t   size         = 0;
+	uint8_t*   buf          = 0;
+	event_id_t note_id;
+	int        ret;
+
+	while (true) {
+
+		const uint64_t offset = reader._pos;
+		const uint8_t  status = reader._status;
+		const uint64_t base   = time;
+
+		if ((ret = reader.read_event (&delta_t, &size, &buf, &note_id)) < 0) {
+			break;
+		}
+
+		time += delta_t;
+
+		/* meta-events start buckets too, so that a note ID is read
+		 * together with the note it belongs to.
+		 */
+		if (indexed && (_buckets.empty () || time / _ppqn > bucket)) {
+			Bucket b = { time, base, offset, status };
+			_buckets.push_back (b);
+			bucket = time / _ppqn;
+		}
+
+		if (ret == 0) {
+			continue;
+		}
+
+		_empty         = false;
+		_length_pulses = std::max (_length_pulses, time);
+
+		const uint8_t type = buf[0] & 0xf0;
+
+		if (type >= 0x80 && type <= 0xe0) {
+			_used_channels.set (buf[0] & 0x0f);
+			switch (type) {
+			case MIDI_CMD_NOTE_ON:
+				++_n_note_on_events;
+				_lowest_note  = std::min (_lowest_note, buf[1]);
+				_highest_note = std::max (_highest_note, buf[1]);
+				break;
+			case MIDI_CMD_PGM_CHANGE:
+				_has_pgm_change = true;
+				break;
+			default:
+				break;
+			}
+		}
+
+		/* keep the capacity of buf, to minimize reallocs in read_event */
+		scratch_size = std::max (scratch_size, size);
+		size = scratch_size;
+	}
+
+	free (buf);
+}
+
+/** Load an index that was saved with save().
+ *
+ * \return 0 on success, -1 if there is no valid index of @a track of the
+ * file at @a path as it is now.
+ */
+int
+SMFIndex::load (std::string const & index_path, std::string const & path, int track)
+{
+	clear ();
+
+	uint64_t file_size;
+	int64_t  file_mtime;
+
+	if (!file_stat (path, file_size, file_mtime)) {
+		return -1;
+	}
+
+	FILE* f = g_fopen (index_path.c_str (), "rb");
+
+	if (!f) {
+		return -1;
+	}
+
+	char     magic[4];
+	uint32_t version;
+	uint32_t used_channels;
+	uint8_t  empty;
+	uint8_t  has_pgm_change;
+	uint64_t n_buckets;
+
+	bool ok = fread (magic, 1, sizeof (magic), f) == sizeof (magic)
+		&& !memcmp (magic, index_magic, sizeof (magic))
+		&& read_value (f, version) && version == index_version
+		&& read_value (f, _file_size) && _file_size == file_size
+		&& read_value (f, _file_mtime) && _file_mtime == file_mtime
+		&& read_value (f, _track) && _track == track
+		&& read_value (f, _ppqn) && _ppqn != 0
+		&& read_value (f, _track_start)
+		&& read_value (f, _track_end)
+		&& read_value (f, empty)
+		&& read_value (f, _length_pulses)
+		&& read_value (f, used_channels)
+		&& read_value (f, _n_note_on_events)
+		&& read_value (f, has_pgm_change)
+		&& read_value (f, _lowest_note)
+		&& read_value (f, _highest_note)
+		&& read_value (f, n_buckets)
+		&& n_buckets <= _file_size;
+
+	if (ok) {
+		_buckets.resize (n_buckets);
+		for (Buckets::iterator b = _buckets.begin (); ok && b != _buckets.end (); ++b) {
+			ok = read_value (f, b->time)
+				&& read_value (f, b->base)
+				&& read_value (f, b->offset)
+				&& read_value (f, b->status);
+		}
+	}
+
+	fclose (f);
+
+	if (!ok) {
+		clear ();
+		return -1;
+	}
+
+	_empty          = empty;
+	_has_pgm_change = has_pgm_change;
+	_used_channels  = UsedChannels (used_channels);
+
+	return 0;
+}
+
+/** Save the index to a file, in the byte order of this machine.
+ * \return 0 on success
+ */
+int
+SMFIndex::save (std::string const & index_path) const
+{
+	FILE* f = g_fopen (index_path.c_str (), "wb");
+
+	if (!f) {
+		return -1;
+	}
+
+	const uint8_t  empty          = _empty;
+	const uint8_t  has_pgm_change = _has_pgm_change;
+	const uint32_t used_channels  = _used_channels.to_ulong ();
+	const uint64_t n_buckets      = _buckets.size ();
+
+	bool ok = fwrite (index_magic, 1, sizeof (index_magic), f) == sizeof (index_magic)
+		&& write_value (f, index_version)
+		&& write_value (f, _file_size)
+		&& write_value (f, _file_mtime)
+		&& write_value (f, _track)
+		&& write_value (f, _ppqn)
+		&& write_value (f, _track_start)
+		&& write_value (f, _track_end)
+		&& write_value (f, empty)
+		&& write_value (f, _length_pulses)
+		&& write_value (f, used_channels)
+		&& write_value (f, _n_note_on_events)
+		&& write_value (f, has_pgm_change)
+		&& write_value (f, _lowest_note)
+		&& write_value (f, _highest_note)
+		&& write_value (f, n_buckets);
+
+	for (Buckets::const_iterator b = _buckets.begin (); ok && b != _buckets.end (); ++b) {
+		ok = write_value (f, b->time)
+			&& write_value (f, b->base)
+			&& write_value (f, b->offset)
+			&& write_value (f, b->status);
+	}
+
+	if (fclose (f) || !ok) {
+		::g_unlink (index_path.c_str ());
+		return -1;
+	}
+
+	return 0;
+}
+
+SMFIndex::Reader::Reader (SMFIndex const & index, std::string const & path)
+	: _index (&index)
+	, _file (g_fopen (path.c_str (), "rb"))
+	, _start (index._track_start)
+	, _end (index._track_end)
+	, _pos (0)
+	, _status (0)
+{
+	seek (_start);
+}
+
+SMFIndex::Reader::Reader (std::string const & path, uint64_t start, uint64_t end)
+	: _index (0)
+	, _file (g_fopen (path.c_str (), "rb"))
+	, _start (start)
+	, _end (end)
+	, _pos (0)
+	, _status (0)
+{
+	seek (_start);
+}
+
+SMFIndex::Reader::~Reader ()
+{
+	if (_file) {
+		fclose (_file);
+	}
+}
+
+void
+SMFIndex::Reader::seek (uint64_t pos)
+{
+	if (_file && pos <= _end && fseek (_file, pos, SEEK_SET) == 0) {
+		_pos = pos;
+	} else {
+		_pos = _end;
+	}
+}
+
+int
+SMFIndex::Reader::read_byte ()
+{
+	if (!_file || _pos >= _end) {
+		return -1;
+	}
+
+	const int c = getc (_file);
+
+	if (c == EOF) {
+		_pos = _end;
+		return -1;
+	}
+
+	++_pos;
+	return c;
+}
+
+bool
+SMFIndex::Reader::read_var_len (uint32_t* value)
+{
+	*value = 0;
+
+	/* at most 4 bytes, see smf_extract_vlq() */
+	for (int i = 0; i < 4; ++i) {
+		const int c = read_byte ();
+		if (c < 0) {
+			return false;
+		}
+		*value = (*value << 7) | (c & 0x7f);
+		if (!(c & 0x80)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool
+SMFIndex::Reader::read_bytes (uint8_t* buf, uint32_t size)
+{
+	if (!_file || _pos + size > _end || fread (buf, 1, size, _file) != size) {
+		_pos = _end;
+		return false;
+	}
+
+	_pos += size;
+	return true;
+}
+
+/** Seek to the first event of the beat that contains @a pulses (in SMF ticks).
+ *
+ * This is a bisection of the index, followed by a single seek in the file.
+ * Events before @a pulses may be read next, it is up to the caller to skip
+ * them.
+ *
+ * \return the time (in SMF ticks) that the delta time of the next event is
+ * relative to.
+ */
+uint64_t
+SMFIndex::Reader::seek_to_time (uint64_t pulses)
+{
+	_status = 0;
+
+	if (!_index) {
+		seek (_start);
+		return 0;
+	}
+
+	Buckets const & buckets (_index->_buckets);
+
+	/* find the first bucket that starts after pulses */
+
+	size_t lo = 0;
+	size_t hi = buckets.size ();
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (buckets[mid].time <= pulses) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo == 0) {
+		seek (_start);
+		return 0;
+	}
+
+	Bucket const & b (buckets[lo - 1]);
+
+	seek (b.offset);
+	_status = b.status;
+
+	return b.base;
+}
+
+/** Read the next event of the track from the file.
+ *
+ * This works like Evoral::SMF::read_event(), but events that are not valid
+ * MIDI are skipped like meta-events, instead of ending the track.
+ *
+ * \return event length (including status byte) on success, 0 if event was
+ * a meta event, or -1 on EOF (or end of track).
+ */
+int
+SMFIndex::Reader::read_event (uint32_t* delta_t, uint32_t* size, uint8_t** buf, event_id_t* note_id)
+{
+	assert (delta_t);
+	assert (size);
+	assert (buf);
+	assert (note_id);
+
+	uint32_t delta;
+
+	if (!read_var_len (&delta)) {
+		return -1;
+	}
+
+	const int c = read_byte ();
+
+	if (c < 0) {
+		return -1;
+	}
+
+	uint8_t status;
+	int     running_data = -1;
+
+	if (c < 0x80) {
+		if (!_status) {
+			/* data without a status: corrupt track */
+			return -1;
+		}
+		status       = _status;
+		running_data = c;
+	} else {
+		status = c;
+	}
+
+	*delta_t = delta;
+
+	if (status == 0xff) {
+
+		*note_id = -1; /* no note id in this meta-event */
+
+		const int type = read_byte ();
+		uint32_t  len;
+
+		if (type < 0 || type == 0x2f || !read_var_len (&len) || _pos + len > _end) {
+			/* end of track */
+			return -1;
+		}
+
+		const uint64_t next = _pos + len;
+
+		if (type == 0x7f && len >= 3) { // Sequencer-specific
+			uint8_t id[2];
+			uint32_t value;
+			if (read_bytes (id, 2) &&
+			    id[0] == 0x99 && // Evoral
+			    id[1] == 0x1 &&  // Evoral Note ID
+			    read_var_len (&value)) {
+				*note_id = value;
+			}
+		}
+
+		seek (next);
+		return 0; /* this is a meta-event */
+	}
+
+	uint32_t event_size;
+	uint32_t len = 0;
+
+	if (status == 0xf0 || status == 0xf7) {
+		if (!read_var_len (&len)) {
+			return -1;
+		}
+		/* 0xf7 escapes arbitrary bytes, 0xf0 starts a sysex */
+		event_size = (status == 0xf0) ? len + 1 : len;
+	} else if (status < 0xf0) {
+		_status    = status;
+		event_size = midi_event_size (status);
+	} else {
+		/* system common and real-time messages are not valid in a SMF */
+		return -1;
+	}
+
+	if (event_size == 0) {
+		*note_id = -1;
+		return 0;
+	}
+
+	// Make sure we have enough scratch buffer
+	if (*size < event_size) {
+		*buf = (uint8_t*) realloc (*buf, event_size);
+	}
+	assert (*buf);
+	*size = event_size;
+
+	uint8_t* b = *buf;
+
+	if (status == 0xf0) {
+		b[0] = status;
+		if (!read_bytes (b + 1, len)) {
+			return -1;
+		}
+	} else if (status == 0xf7) {
+		if (!read_bytes (b, len)) {
+			return -1;
+		}
+	} else {
+		uint32_t n = 0;
+		b[n++] = status;
+		if (running_data >= 0) {
+			b[n++] = running_data;
+		}
+		if (!read_bytes (b + n, event_size - n)) {
+			return -1;
+		}
+	}
+
+	if ((b[0] & 0xF0) == 0x90 && b[2] == 0) {
+		/* normalize note on with velocity 0 to proper note off */
+		b[0] = 0x80 | (b[0] & 0x0F);  /* note off */
+		b[2] = 0x40;  /* default velocity */
+	}
+
+	if (!midi_event_is_valid (b, event_size)) {
+		*note_id = -1;
+		return 0;
+	}
+
+	return event_size;
+}
+
+} /* namespace Evoral */
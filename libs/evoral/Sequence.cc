@@ -28,6 +28,8 @@
 #include <stdint.h>
 #include <cstdio>
 
+#include <boost/make_shared.hpp>
+
 #if __clang__
 #include "evoral/Note.h"
 #endif
@@ -505,8 +507,7 @@ Sequence<Time>::Sequence(const Sequence<Time>& other)
 	, _highest_note(other._highest_note)
 {
 	for (typename Notes::const_iterator i = other._notes.begin(); i != other._notes.end(); ++i) {
-		NotePtr n (new Note<Time> (**i));
-		_notes.insert (n);
+		_notes.insert (new_note (**i));
 	}
 
 	for (typename SysExes::const_iterator i = other._sysexes.begin(); i != other._sysexes.end(); ++i) {
@@ -844,7 +845,8 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 			 * so the search_note has all other properties unset.
 			 */
 
-			NotePtr search_note (new Note<Time>(0, Time(), Time(), note->note(), 0));
+			Note<Time> search (0, Time(), Time(), note->note(), 0);
+			NotePtr    search_note (NotePtr (), &search); /* unowned, for searching only */
 
 			for (j = p.lower_bound (search_note); j != p.end() && (*j)->note() == note->note(); ++j) {
 
@@ -1004,7 +1006,7 @@ Sequence<Time>::append_note_on_unlocked (const Event<Time>& ev, event_id_t evid)
 	/* nascent (incoming notes without a note-off ...yet) have a duration
 	   that extends to Beats::max()
 	*/
-	NotePtr note(new Note<Time>(ev.channel(), ev.time(), std::numeric_limits<Temporal::Beats>::max() - ev.time(), ev.note(), ev.velocity()));
+	NotePtr note (new_note (ev.channel(), ev.time(), std::numeric_limits<Temporal::Beats>::max() - ev.time(), ev.note(), ev.velocity()));
 	assert (note->end_time() == std::numeric_limits<Temporal::Beats>::max());
 	note->set_id (evid);
 
@@ -1147,7 +1149,8 @@ bool
 Sequence<Time>::contains_unlocked (const NotePtr& note) const
 {
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<Time>(0, Time(), Time(), note->note()));
+	Note<Time> search (0, Time(), Time(), note->note());
+	NotePtr    search_note (NotePtr (), &search); /* unowned, for searching only */
 
 	for (typename Pitches::const_iterator i = p.lower_bound (search_note);
 	     i != p.end() && (*i)->note() == note->note(); ++i) {
@@ -1176,7 +1179,8 @@ Sequence<Time>::overlaps_unlocked (const NotePtr& note, const NotePtr& without)
 	Time ea  = note->end_time();
 
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<Time>(0, Time(), Time(), note->note()));
+	Note<Time> search (0, Time(), Time(), note->note());
+	NotePtr    search_note (NotePtr (), &search); /* unowned, for searching only */
 
 	for (typename Pitches::const_iterator i = p.lower_bound (search_note);
 	     i != p.end() && (*i)->note() == note->note(); ++i) {
@@ -1199,6 +1203,20 @@ Sequence<Time>::overlaps_unlocked (const NotePtr& note, const NotePtr& without)
 	return false;
 }
 
+template<typename Time>
+typename Sequence<Time>::NotePtr
+Sequence<Time>::new_note (uint8_t chan, Time time, Time len, uint8_t note, uint8_t vel)
+{
+	return boost::allocate_shared<Note<Time> > (boost::fast_pool_allocator<Note<Time> > (), chan, time, len, note, vel);
+}
+
+template<typename Time>
+typename Sequence<Time>::NotePtr
+Sequence<Time>::new_note (Note<Time> const & other)
+{
+	return boost::allocate_shared<Note<Time> > (boost::fast_pool_allocator<Note<Time> > (), other);
+}
+
 template<typename Time>
 void
 Sequence<Time>::set_notes (const typename Sequence<Time>::Notes& n)
@@ -1213,7 +1231,8 @@ template<typename Time>
 typename Sequence<Time>::Notes::const_iterator
 Sequence<Time>::note_lower_bound (Time t) const
 {
-	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
+	Note<Time> search (0, t, Time(), 0, 0);
+	NotePtr    search_note (NotePtr (), &search); /* unowned, for searching only */
 	typename Sequence<Time>::Notes::const_iterator i = _notes.lower_bound(search_note);
 	assert(i == _notes.end() || (*i)->time() >= t);
 	return i;
@@ -1248,7 +1267,8 @@ template<typename Time>
 typename Sequence<Time>::Notes::iterator
 Sequence<Time>::note_lower_bound (Time t)
 {
-	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
+	Note<Time> search (0, t, Time(), 0, 0);
+	NotePtr    search_note (NotePtr (), &search); /* unowned, for searching only */
 	typename Sequence<Time>::Notes::iterator i = _notes.lower_bound(search_note);
 	assert(i == _notes.end() || (*i)->time() >= t);
 	return i;
@@ -1310,7 +1330,8 @@ Sequence<Time>::get_notes_by_pitch (Notes& n, NoteOperator op, uint8_t val, int
 		}
 
 		const Pitches& p (pitches (c));
-		NotePtr search_note(new Note<Time>(0, Time(), Time(), val, 0));
+		Note<Time> search (0, Time(), Time(), val, 0);
+		NotePtr    search_note (NotePtr (), &search); /* unowned, for searching only */
 		typename Pitches::const_iterator i;
 		switch (op) {
 		case PitchEqual:
@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -278,23 +279,57 @@ public:
 		return a->when < b->when;
 	}
 
-	/** Lookup cache for eval functions, range contains equivalent values */
+	/** Position and value of an event, see event_index() */
+	struct IndexEntry {
+		IndexEntry (const ControlEvent* ev) : when (ev->when), value (ev->value), event (ev) {}
+		Temporal::timepos_t when;
+		double              value;
+		const ControlEvent* event;
+	};
+
+	typedef std::vector<IndexEntry> EventIndex;
+
+	/** Compare events or index entries with a time, for std::lower_bound() and friends */
+	struct TimeComparator {
+		bool operator() (const ControlEvent* a, Temporal::timepos_t const & t) const { return a->when < t; }
+		bool operator() (Temporal::timepos_t const & t, const ControlEvent* a) const { return t < a->when; }
+		bool operator() (IndexEntry const & a, Temporal::timepos_t const & t) const { return a.when < t; }
+		bool operator() (Temporal::timepos_t const & t, IndexEntry const & a) const { return t < a.when; }
+	};
+
+	/** Lookup cache for eval functions, range contains equivalent values (as offsets into event_index()) */
 	struct LookupCache {
-		LookupCache() : left (std::numeric_limits<Temporal::timepos_t>::max()) {}
+		LookupCache() : left (std::numeric_limits<Temporal::timepos_t>::max()), range (0, 0) {}
 		Temporal::timepos_t left;  /* leftmost x coordinate used when finding "range" */
-		std::pair<ControlList::const_iterator,ControlList::const_iterator> range;
+		std::pair<EventIndex::size_type, EventIndex::size_type> range;
 	};
 
-	/** Lookup cache for point finding, range contains points after left */
+	/** Lookup cache for point finding, range contains points after left (as offset into event_index()) */
 	struct SearchCache {
-		SearchCache () : left (std::numeric_limits<Temporal::timepos_t>::max()) {}
+		SearchCache () : left (std::numeric_limits<Temporal::timepos_t>::max()), first (0) {}
 		Temporal::timepos_t left;  /* leftmost x coordinate used when finding "first" */
-		ControlList::const_iterator first;
+		EventIndex::size_type first;
 	};
 
 	/** @return the list of events */
 	const EventList& events() const { return _events; }
 
+	/** API for Lua binding: scripts may change the returned events in place,
+	 * so the index is not used until the list is next modified or thawed.
+	 */
+	const EventList& script_events();
+
+	/** @return a contiguous copy of the events' positions and values, sorted by time.
+	 *
+	 * This is what eval and search functions use. It is rebuilt whenever the
+	 * list is modified, except while the list is frozen, in which case it is
+	 * rebuilt by thaw() and index_valid() returns false until then. The same
+	 * goes for a list whose events were handed out by script_events().
+	 * Caller must hold the lock.
+	 */
+	const EventIndex& event_index() const { return _index; }
+	bool index_valid () const { return !_index_dirty; }
+
 	// FIXME: const violations for Curve
 	Glib::Threads::RWLock& lock()       const { return _lock; }
 	LookupCache& lookup_cache() const { return _lookup_cache; }
@@ -366,10 +401,21 @@ public:
 
   protected:
 
-	/** Called by unlocked_eval() to handle cases of 3 or more control points. */
-	double multipoint_eval (Temporal::timepos_t const & x) const;
+	/** Evaluate the current list rather than the index, for use while modifying it (writer lock held). */
+	double list_eval (Temporal::timepos_t const & x) const;
+
+	template<typename Iter> double eval_events (Iter begin, Iter end, Temporal::timepos_t const & x, bool use_cache) const;
+	template<typename Iter> double multipoint_eval (Iter begin, Iter end, Temporal::timepos_t const & x, bool use_cache) const;
+
+	std::pair<EventIndex::const_iterator, EventIndex::const_iterator> lookup_range (EventIndex::const_iterator, EventIndex::const_iterator, Temporal::timepos_t const &, bool use_cache) const;
+	std::pair<const_iterator, const_iterator> lookup_range (const_iterator, const_iterator, Temporal::timepos_t const &, bool use_cache) const;
 
 	void build_search_cache_if_necessary (Temporal::timepos_t const & start) const;
+	template<typename Iter> Iter search_events (Iter begin, Iter end, Temporal::timepos_t const & start, bool inclusive, bool use_cache) const;
+	template<typename Iter> bool earliest_event_discrete (Iter begin, Iter end, Temporal::timepos_t const & start, Temporal::timepos_t & x, double& y, bool inclusive, bool use_cache) const;
+	template<typename Iter> bool earliest_event_linear (Iter begin, Iter end, Temporal::timepos_t const & start, Temporal::timepos_t & x, double& y, bool inclusive, Temporal::timecnt_t const & min_x_delta, bool use_cache) const;
+
+	void unlocked_update_index () const;
 
 	boost::shared_ptr<ControlList> cut_copy_clear (Temporal::timepos_t const &, Temporal::timepos_t const &, int op);
 	bool erase_range_internal (Temporal::timepos_t const & start, Temporal::timepos_t const & end, EventList &);
@@ -386,6 +432,8 @@ public:
 
 	mutable LookupCache   _lookup_cache;
 	mutable SearchCache   _search_cache;
+	mutable EventIndex    _index;
+	mutable bool          _index_dirty;
 
 	mutable Glib::Threads::RWLock _lock;
 
@@ -29,6 +29,7 @@
 namespace Evoral {
 
 class ControlList;
+class ControlEvent;
 
 class LIBEVORAL_API Curve : public boost::noncopyable
 {
@@ -43,7 +44,8 @@ public:
 	void mark_dirty() const { _dirty = true; }
 
 private:
-	double multipoint_eval (Temporal::timepos_t const & x) const;
+	template<typename Iter> void render (Iter begin, Iter end, double lx, double dx, float* vec, int32_t veclen) const;
+	void render_segment (double bw, double bv, double aw, double av, const ControlEvent* ev, double rx, double dx, float* vec, int32_t n) const;
 
 	void _get_vector (Temporal::timepos_t const & x0, Temporal::timepos_t const & x1, float *arg, int32_t veclen) const;
 
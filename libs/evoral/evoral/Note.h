@@ -107,7 +107,10 @@ public:
 	inline const Event<Time>& off_event() const { return _off_event; }
 
 private:
-	// Event buffers are self-contained
+	// Event buffers are self-contained, and part of the note to avoid
+	// two more heap allocations per note
+	uint8_t     _on_buffer[3];
+	uint8_t     _off_buffer[3];
 	Event<Time> _on_event;
 	Event<Time> _off_event;
 };
@@ -69,8 +69,9 @@ public:
 	int  create(const std::string& path, int track=1, uint16_t ppqn=19200);
 	void close();
 
-	void seek_to_start() const;
-	int  seek_to_track(int track);
+	void     seek_to_start() const;
+	uint64_t seek_to_time(uint64_t pulses) const;
+	int      seek_to_track(int track);
 
 	int read_event(uint32_t* delta_t, uint32_t* size, uint8_t** buf, event_id_t* note_id) const;
 
@@ -0,0 +1,130 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EVORAL_SMF_INDEX_HPP
+#define EVORAL_SMF_INDEX_HPP
+
+#include <bitset>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "evoral/visibility.h"
+#include "evoral/types.h"
+
+namespace Evoral {
+
+/** Index of the event offsets of one track of a Standard MIDI File.
+ *
+ * The index holds the file position of the first event in every beat of the
+ * track, so that events can be read straight from the file without loading
+ * it into memory, which is what libsmf (and so Evoral::SMF) does. It is built
+ * with a single pass over the file, which also collects the information that
+ * a source needs before its events are read (length, channels used etc.)
+ *
+ * An index can be saved to a file of its own. Loading it fails if the MIDI
+ * file has changed since, and then it needs to be built again.
+ */
+class LIBEVORAL_API SMFIndex {
+public:
+	typedef std::bitset<16> UsedChannels;
+
+	SMFIndex ();
+
+	int build (std::string const & path, int track = 1);
+	int load (std::string const & index_path, std::string const & path, int track = 1);
+	int save (std::string const & index_path) const;
+
+	uint16_t ppqn () const { return _ppqn; }
+
+	/** @return true iff no track of the file has any MIDI events */
+	bool     is_empty () const { return _empty; }
+	/** @return time of the last MIDI event of the file, in ticks */
+	uint64_t length_pulses () const { return _length_pulses; }
+
+	UsedChannels const & used_channels () const { return _used_channels; }
+	uint64_t n_note_on_events () const { return _n_note_on_events; }
+	bool     has_pgm_change () const { return _has_pgm_change; }
+	uint8_t  lowest_note () const { return _lowest_note; }
+	uint8_t  highest_note () const { return _highest_note; }
+
+	/** Reads the events of the indexed track from the file.
+	 *
+	 * A Reader has a file and read position of its own, so any number of
+	 * them can be used at the same time. Its methods work like those of
+	 * Evoral::SMF with the same name.
+	 */
+	class LIBEVORAL_API Reader {
+	public:
+		Reader (SMFIndex const &, std::string const & path);
+		~Reader ();
+
+		uint64_t seek_to_time (uint64_t pulses);
+		int      read_event (uint32_t* delta_t, uint32_t* size, uint8_t** buf, event_id_t* note_id);
+
+	private:
+		friend class SMFIndex;
+
+		Reader (std::string const & path, uint64_t start, uint64_t end);
+
+		void seek (uint64_t pos);
+		int  read_byte ();
+		bool read_var_len (uint32_t* value);
+		bool read_bytes (uint8_t* buf, uint32_t size);
+
+		SMFIndex const* _index;
+		FILE*           _file;
+		uint64_t        _start;  ///< file position of the first event of the track
+		uint64_t        _end;    ///< file position of the end of the track
+		uint64_t        _pos;
+		uint8_t         _status; ///< running status
+	};
+
+private:
+	struct Bucket {
+		uint64_t time;   ///< time of the first event of the bucket, in ticks
+		uint64_t base;   ///< time of the event before it, which its delta time is relative to
+		uint64_t offset; ///< file position of the delta time of the first event
+		uint8_t  status; ///< running status at that file position
+	};
+
+	typedef std::vector<Bucket> Buckets;
+
+	void clear ();
+	void scan_track (std::string const & path, uint64_t start, uint64_t end, bool indexed);
+
+	uint64_t     _file_size;
+	int64_t      _file_mtime;
+	int          _track;
+	uint16_t     _ppqn;
+	uint64_t     _track_start;
+	uint64_t     _track_end;
+
+	bool         _empty;
+	uint64_t     _length_pulses;
+	UsedChannels _used_channels;
+	uint64_t     _n_note_on_events;
+	bool         _has_pgm_change;
+	uint8_t      _lowest_note;
+	uint8_t      _highest_note;
+
+	Buckets      _buckets;
+};
+
+} /* namespace Evoral */
+
+#endif /* EVORAL_SMF_INDEX_HPP */
@@ -29,6 +29,7 @@
 #include <list>
 #include <utility>
 #include <boost/shared_ptr.hpp>
+#include <boost/pool/pool_alloc.hpp>
 #include <glibmm/threads.h>
 
 #include "evoral/visibility.h"
@@ -89,6 +90,15 @@ public:
 	typedef typename boost::weak_ptr<Evoral::Note<Time> >         WeakNotePtr;
 	typedef typename boost::shared_ptr<const Evoral::Note<Time> > constNotePtr;
 
+	/** Notes and the nodes of the containers below come from pools shared
+	 *  by all sequences. A model with many notes then does not need a heap
+	 *  allocation for each note, and its notes are close together in memory.
+	 *  Notes may outlive the sequence (e.g. in undo history), which is why
+	 *  the pools are not owned by a sequence.
+	 */
+	static NotePtr new_note (uint8_t chan, Time time, Time len, uint8_t note, uint8_t vel = 0x40);
+	static NotePtr new_note (Note<Time> const & other);
+
 	typedef boost::shared_ptr<Glib::Threads::RWLock::ReaderLock> ReadLock;
 	typedef boost::shared_ptr<WriteLockImpl>                     WriteLock;
 
@@ -152,7 +162,7 @@ public:
 		}
 	};
 
-	typedef std::multiset<NotePtr, EarlierNoteComparator> Notes;
+	typedef std::multiset<NotePtr, EarlierNoteComparator, boost::fast_pool_allocator<NotePtr> > Notes;
 	inline       Notes& notes()       { return _notes; }
 	inline const Notes& notes() const { return _notes; }
 
@@ -196,7 +206,7 @@ public:
 		}
 	};
 
-	typedef std::multiset<SysExPtr, EarlierSysExComparator> SysExes;
+	typedef std::multiset<SysExPtr, EarlierSysExComparator, boost::fast_pool_allocator<SysExPtr> > SysExes;
 	inline       SysExes& sysexes()       { return _sysexes; }
 	inline const SysExes& sysexes() const { return _sysexes; }
 
@@ -209,7 +219,7 @@ public:
 		}
 	};
 
-	typedef std::multiset<PatchChangePtr, EarlierPatchChangeComparator> PatchChanges;
+	typedef std::multiset<PatchChangePtr, EarlierPatchChangeComparator, boost::fast_pool_allocator<PatchChangePtr> > PatchChanges;
 	inline       PatchChanges& patch_changes ()       { return _patch_changes; }
 	inline const PatchChanges& patch_changes () const { return _patch_changes; }
 
@@ -326,7 +336,7 @@ protected:
 		return 0;
 	}
 
-	typedef std::multiset<NotePtr, NoteNumberComparator>  Pitches;
+	typedef std::multiset<NotePtr, NoteNumberComparator, boost::fast_pool_allocator<NotePtr> > Pitches;
 	inline       Pitches& pitches(uint8_t chan)       { return _pitches[chan&0xf]; }
 	inline const Pitches& pitches(uint8_t chan) const { return _pitches[chan&0xf]; }
 
@@ -354,7 +364,7 @@ private:
 	SysExes      _sysexes;
 	PatchChanges _patch_changes;
 
-	typedef std::multiset<NotePtr, EarlierNoteComparator> WriteNotes;
+	typedef std::multiset<NotePtr, EarlierNoteComparator, boost::fast_pool_allocator<NotePtr> > WriteNotes;
 	WriteNotes _write_notes[16];
 
 	/** Current bank number on each channel so that we know what
@@ -217,6 +217,36 @@ CurveTest::threePointDiscete ()
 	CPPUNIT_ASSERT_EQUAL(1.6, cl->unlocked_eval(160.));
 }
 
+void
+CurveTest::multiPointVector ()
+{
+	float vec[1024];
+
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+
+	cl->create_curve ();
+
+	/* many short segments, so that a single get_vector()
+	 * call spans several of them.
+	 */
+	for (int i = 0; i < 64; ++i) {
+		cl->fast_simple_add (i * 100.0, (i % 2) ? 1.0 : 0.25 + i / 64.0);
+	}
+
+	ControlList::InterpolationStyle const styles[] = { ControlList::Linear, ControlList::Discrete, ControlList::Exponential };
+
+	for (size_t s = 0; s < sizeof (styles) / sizeof (styles[0]); ++s) {
+		cl->set_interpolation (styles[s]);
+
+		cl->curve ().get_vector (50.0, 50.0 + 1023 * 5, vec, 1024);
+		for (int i = 0; i < 1024; ++i) {
+			char msg[64];
+			snprintf (msg, 64, "style %d at i=%d", (int) styles[s], i);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE (msg, cl->unlocked_eval (50.0 + i * 5), vec[i], 1e-5);
+		}
+	}
+}
+
 void
 CurveTest::ctrlListEval ()
 {
@@ -293,6 +323,36 @@ CurveTest::ctrlListEval ()
 	CPPUNIT_ASSERT_EQUAL(9.0, cl->unlocked_eval(999.));
 }
 
+void
+CurveTest::frozenEarliestEvent ()
+{
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	Temporal::timepos_t x;
+	double y;
+
+	cl->fast_simple_add (Temporal::timepos_t (Temporal::samplepos_t (0)), 2.0);
+
+	cl->freeze ();
+	cl->add (Temporal::timepos_t (Temporal::samplepos_t (100)), 4.0, false, false);
+
+	// The index is only rebuilt on thaw, events added meanwhile must be found
+	CPPUNIT_ASSERT (!cl->index_valid ());
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (Temporal::timepos_t (Temporal::samplepos_t (50)), x, y, true));
+	CPPUNIT_ASSERT (x == Temporal::timepos_t (Temporal::samplepos_t (100)));
+	CPPUNIT_ASSERT_EQUAL (4.0, y);
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t (Temporal::samplepos_t (0)), x, y, false));
+	CPPUNIT_ASSERT_EQUAL (3.0, y);
+
+	cl->thaw ();
+
+	CPPUNIT_ASSERT (cl->index_valid ());
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (Temporal::timepos_t (Temporal::samplepos_t (50)), x, y, true));
+	CPPUNIT_ASSERT (x == Temporal::timepos_t (Temporal::samplepos_t (100)));
+	CPPUNIT_ASSERT_EQUAL (4.0, y);
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t (Temporal::samplepos_t (0)), x, y, false));
+	CPPUNIT_ASSERT_EQUAL (3.0, y);
+}
+
 void
 CurveTest::constrainedCubic ()
 {
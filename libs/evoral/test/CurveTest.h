@@ -12,7 +12,9 @@ class CurveTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (threePointLinear);
 	CPPUNIT_TEST (threePointDiscete);
 	CPPUNIT_TEST (constrainedCubic);
+	CPPUNIT_TEST (multiPointVector);
 	CPPUNIT_TEST (ctrlListEval);
+	CPPUNIT_TEST (frozenEarliestEvent);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -22,7 +24,9 @@ public:
 	void threePointLinear ();
 	void threePointDiscete ();
 	void constrainedCubic ();
+	void multiPointVector ();
 	void ctrlListEval ();
+	void frozenEarliestEvent ();
 
 private:
 	boost::shared_ptr<Evoral::ControlList> TestCtrlList() {
@@ -1,9 +1,15 @@
 #include "SMFTest.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
 #include "pbd/file_utils.h"
+#include "pbd/gstdio_compat.h"
+
+#include "evoral/SMFIndex.h"
 
 using namespace std;
 
@@ -117,3 +123,292 @@ SMFTest::writeTest ()
 
 	// TODO: Check files are actually equivalent
 }
+
+void
+SMFTest::seekTest ()
+{
+	TestSMF smf;
+	string  testdata_path;
+	CPPUNIT_ASSERT (find_file (test_search_path (), "TakeFive.mid", testdata_path));
+
+	smf.open(testdata_path);
+	CPPUNIT_ASSERT(!smf.is_empty());
+
+	/* read all (non-meta) event times from the start */
+	vector<uint64_t> times;
+	uint64_t time    = 0;
+	uint32_t delta_t = 0;
+	uint32_t size    = 0;
+	uint8_t* buf     = NULL;
+	int      ret;
+
+	smf.seek_to_start();
+	while ((ret = smf.read_event(&delta_t, &size, &buf)) >= 0) {
+		time += delta_t;
+		if (ret > 0) {
+			times.push_back (time);
+		}
+	}
+
+	CPPUNIT_ASSERT (!times.empty());
+
+	/* seeking must find the same first event at or after the seek time */
+	const uint64_t targets[] = { 0, 1, times[times.size() / 3], times[times.size() / 3] + 1, times.back(), times.back() + 1 };
+
+	for (size_t t = 0; t < sizeof (targets) / sizeof (targets[0]); ++t) {
+		vector<uint64_t>::const_iterator expected = lower_bound (times.begin(), times.end(), targets[t]);
+
+		time = smf.seek_to_time (targets[t]);
+		while ((ret = smf.read_event(&delta_t, &size, &buf)) == 0) {
+			time += delta_t;
+		}
+
+		if (expected == times.end()) {
+			CPPUNIT_ASSERT_EQUAL (-1, ret);
+		} else {
+			CPPUNIT_ASSERT (ret > 0);
+			CPPUNIT_ASSERT_EQUAL (*expected, time + delta_t);
+		}
+	}
+
+	free (buf);
+}
+
+/** An event read by SMF::read_event() or SMFIndex::Reader::read_event(),
+ * meta-events are only kept if they carry a note ID.
+ */
+struct IndexTestEvent {
+	IndexTestEvent (uint64_t t, int r, const uint8_t* buf, uint32_t size, event_id_t i)
+		: time (t), ret (r), bytes (buf, buf + size), id (i) {}
+
+	bool operator== (IndexTestEvent const & other) const {
+		return time == other.time && ret == other.ret && bytes == other.bytes && id == other.id;
+	}
+
+	uint64_t        time;
+	int             ret;
+	vector<uint8_t> bytes;
+	event_id_t      id;
+};
+
+typedef vector<IndexTestEvent> IndexTestEvents;
+
+template<typename Cursor> static IndexTestEvents
+read_all_events (Cursor& cursor, uint64_t time)
+{
+	IndexTestEvents events;
+	uint32_t        delta_t = 0;
+	uint32_t        size    = 0;
+	uint8_t*        buf     = NULL;
+	event_id_t      id      = -1;
+	int             ret;
+
+	while ((ret = cursor.read_event (&delta_t, &size, &buf, &id)) >= 0) {
+		time += delta_t;
+		if (ret > 0) {
+			events.push_back (IndexTestEvent (time, ret, buf, ret, -1));
+		} else if (id >= 0) {
+			events.push_back (IndexTestEvent (time, 0, NULL, 0, id));
+		}
+	}
+
+	free (buf);
+	return events;
+}
+
+/** Write a type 0 SMF with 96 PPQN and a single track with @p size bytes of events */
+static void
+write_smf (string const & path, const uint8_t* track, uint32_t size)
+{
+	const uint8_t header[] = {
+		'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+		'M', 'T', 'r', 'k', uint8_t (size >> 24), uint8_t (size >> 16), uint8_t (size >> 8), uint8_t (size)
+	};
+
+	FILE* f = g_fopen (path.c_str (), "wb");
+	CPPUNIT_ASSERT (f);
+	CPPUNIT_ASSERT_EQUAL (sizeof (header), fwrite (header, 1, sizeof (header), f));
+	CPPUNIT_ASSERT_EQUAL (size_t (size), fwrite (track, 1, size, f));
+	CPPUNIT_ASSERT_EQUAL (0, fclose (f));
+}
+
+/* a note ID, two notes using running status, and note-ons with velocity 0 */
+static const uint8_t running_status_track[] = {
+	0x00, 0xff, 0x7f, 0x03, 0x99, 0x01, 0x05, // note ID 5
+	0x00, 0x90, 0x3c, 0x64,                   // note on C4 @ 0
+	0x60, 0x3e, 0x64,                         // note on D4 @ 96
+	0x00, 0x3c, 0x00,                         // note off C4 @ 96
+	0x60, 0x3e, 0x00,                         // note off D4 @ 192
+	0x00, 0xff, 0x2f, 0x00                    // end of track
+};
+
+void
+SMFTest::indexReadTest ()
+{
+	TestSMF smf;
+	string  testdata_path;
+	CPPUNIT_ASSERT (find_file (test_search_path (), "TakeFive.mid", testdata_path));
+
+	smf.open(testdata_path);
+	CPPUNIT_ASSERT(!smf.is_empty());
+
+	smf.seek_to_start();
+	const IndexTestEvents expected = read_all_events (static_cast<SMF&> (smf), 0);
+	CPPUNIT_ASSERT (!expected.empty());
+
+	SMFIndex index;
+	CPPUNIT_ASSERT_EQUAL (0, index.build (testdata_path));
+	CPPUNIT_ASSERT_EQUAL (smf.ppqn(), index.ppqn());
+	CPPUNIT_ASSERT (!index.is_empty());
+
+	SMFIndex::Reader reader (index, testdata_path);
+
+	/* from the start */
+	CPPUNIT_ASSERT (read_all_events (reader, reader.seek_to_time (0)) == expected);
+
+	/* after a seek the reader starts at the first event of a beat, so
+	 * it reads a tail of the track which includes all events at or after
+	 * the seek time.
+	 */
+	const uint64_t ppqn = index.ppqn();
+	const uint64_t last = expected.back().time;
+
+	vector<uint64_t> targets;
+	for (uint64_t beat = 0; beat * ppqn <= last + ppqn; beat += 7) {
+		targets.push_back (beat * ppqn);
+		targets.push_back (beat * ppqn + 1);
+		if (beat > 0) {
+			targets.push_back (beat * ppqn - 1);
+		}
+	}
+	targets.push_back (expected[expected.size() / 2].time);
+	targets.push_back (last);
+
+	for (vector<uint64_t>::const_iterator t = targets.begin(); t != targets.end(); ++t) {
+		const uint64_t        base   = reader.seek_to_time (*t);
+		const IndexTestEvents events = read_all_events (reader, base);
+
+		CPPUNIT_ASSERT (base <= *t);
+		CPPUNIT_ASSERT (events.size() <= expected.size());
+
+		IndexTestEvents::const_iterator tail = expected.end() - events.size();
+		CPPUNIT_ASSERT (equal (events.begin(), events.end(), tail));
+		CPPUNIT_ASSERT (tail == expected.begin() || (tail - 1)->time < *t);
+	}
+}
+
+void
+SMFTest::indexRunningStatusTest ()
+{
+	const string output_dir_path = PBD::tmp_writable_directory (PACKAGE, "indexRunningStatusTest");
+	const string path            = Glib::build_filename (output_dir_path, "RunningStatus.mid");
+
+	write_smf (path, running_status_track, sizeof (running_status_track));
+
+	SMFIndex index;
+	CPPUNIT_ASSERT_EQUAL (0, index.build (path));
+	CPPUNIT_ASSERT_EQUAL (uint16_t (96), index.ppqn());
+	CPPUNIT_ASSERT_EQUAL (uint64_t (192), index.length_pulses());
+	CPPUNIT_ASSERT_EQUAL (uint64_t (2), index.n_note_on_events());
+	CPPUNIT_ASSERT_EQUAL (uint8_t (0x3c), index.lowest_note());
+	CPPUNIT_ASSERT_EQUAL (uint8_t (0x3e), index.highest_note());
+	CPPUNIT_ASSERT (index.used_channels().test (0));
+	CPPUNIT_ASSERT_EQUAL (size_t (1), index.used_channels().count());
+
+	SMFIndex::Reader      reader (index, path);
+	const IndexTestEvents events = read_all_events (reader, reader.seek_to_time (0));
+
+	const uint8_t c_on[]  = { 0x90, 0x3c, 0x64 };
+	const uint8_t d_on[]  = { 0x90, 0x3e, 0x64 };
+	const uint8_t c_off[] = { 0x80, 0x3c, 0x40 };
+	const uint8_t d_off[] = { 0x80, 0x3e, 0x40 };
+
+	IndexTestEvents expected;
+	expected.push_back (IndexTestEvent (0, 0, NULL, 0, 5));
+	expected.push_back (IndexTestEvent (0, 3, c_on, 3, -1));
+	expected.push_back (IndexTestEvent (96, 3, d_on, 3, -1));
+	expected.push_back (IndexTestEvent (96, 3, c_off, 3, -1));
+	expected.push_back (IndexTestEvent (192, 3, d_off, 3, -1));
+
+	CPPUNIT_ASSERT (events == expected);
+
+	/* the same as libsmf */
+	TestSMF smf;
+	CPPUNIT_ASSERT_EQUAL (0, smf.open (path));
+	smf.seek_to_start();
+	CPPUNIT_ASSERT (read_all_events (static_cast<SMF&> (smf), 0) == expected);
+
+	/* the second beat starts with a running status event */
+	const uint64_t        base = reader.seek_to_time (100);
+	const IndexTestEvents tail = read_all_events (reader, base);
+	CPPUNIT_ASSERT_EQUAL (uint64_t (0), base);
+	CPPUNIT_ASSERT (equal (tail.begin(), tail.end(), expected.end() - 3));
+	CPPUNIT_ASSERT_EQUAL (size_t (3), tail.size());
+}
+
+void
+SMFTest::indexStaleTest ()
+{
+	const string output_dir_path = PBD::tmp_writable_directory (PACKAGE, "indexStaleTest");
+	const string path            = Glib::build_filename (output_dir_path, "Stale.mid");
+	const string index_path      = Glib::build_filename (output_dir_path, "Stale.midx");
+
+	write_smf (path, running_status_track, sizeof (running_status_track));
+
+	SMFIndex index;
+	CPPUNIT_ASSERT_EQUAL (0, index.build (path));
+	CPPUNIT_ASSERT_EQUAL (0, index.save (index_path));
+
+	SMFIndex loaded;
+	CPPUNIT_ASSERT_EQUAL (0, loaded.load (index_path, path));
+	CPPUNIT_ASSERT_EQUAL (index.length_pulses(), loaded.length_pulses());
+	CPPUNIT_ASSERT_EQUAL (index.n_note_on_events(), loaded.n_note_on_events());
+	{
+		SMFIndex::Reader a (index, path);
+		SMFIndex::Reader b (loaded, path);
+		CPPUNIT_ASSERT (read_all_events (a, a.seek_to_time (100)) == read_all_events (b, b.seek_to_time (100)));
+	}
+
+	/* not an index of another track */
+	CPPUNIT_ASSERT_EQUAL (-1, loaded.load (index_path, path, 2));
+
+	/* a corrupt index is rejected, and can be rebuilt */
+	FILE* f = g_fopen (index_path.c_str (), "r+b");
+	CPPUNIT_ASSERT (f);
+	CPPUNIT_ASSERT_EQUAL (size_t (4), fwrite ("junk", 1, 4, f));
+	CPPUNIT_ASSERT_EQUAL (0, fclose (f));
+
+	CPPUNIT_ASSERT_EQUAL (-1, loaded.load (index_path, path));
+	CPPUNIT_ASSERT_EQUAL (0, index.build (path));
+	CPPUNIT_ASSERT_EQUAL (0, index.save (index_path));
+	CPPUNIT_ASSERT_EQUAL (0, loaded.load (index_path, path));
+
+	/* a truncated index is rejected */
+	uint8_t head[16];
+	f = g_fopen (index_path.c_str (), "rb");
+	CPPUNIT_ASSERT (f);
+	CPPUNIT_ASSERT_EQUAL (sizeof (head), fread (head, 1, sizeof (head), f));
+	CPPUNIT_ASSERT_EQUAL (0, fclose (f));
+	f = g_fopen (index_path.c_str (), "wb");
+	CPPUNIT_ASSERT (f);
+	CPPUNIT_ASSERT_EQUAL (sizeof (head), fwrite (head, 1, sizeof (head), f));
+	CPPUNIT_ASSERT_EQUAL (0, fclose (f));
+
+	CPPUNIT_ASSERT_EQUAL (-1, loaded.load (index_path, path));
+	CPPUNIT_ASSERT_EQUAL (0, index.save (index_path));
+
+	/* an index of the file as it was before it changed is rejected */
+	const uint8_t shorter_track[] = {
+		0x00, 0x90, 0x3c, 0x64,
+		0x60, 0x3c, 0x00,
+		0x00, 0xff, 0x2f, 0x00
+	};
+	write_smf (path, shorter_track, sizeof (shorter_track));
+
+	CPPUNIT_ASSERT_EQUAL (-1, loaded.load (index_path, path));
+	CPPUNIT_ASSERT_EQUAL (0, index.build (path));
+	CPPUNIT_ASSERT_EQUAL (0, index.save (index_path));
+	CPPUNIT_ASSERT_EQUAL (0, loaded.load (index_path, path));
+	CPPUNIT_ASSERT_EQUAL (uint64_t (96), loaded.length_pulses());
+	CPPUNIT_ASSERT_EQUAL (uint64_t (1), loaded.n_note_on_events());
+}
@@ -57,6 +57,10 @@ class SMFTest : public CppUnit::TestFixture
 	CPPUNIT_TEST(createNewFileTest);
 	CPPUNIT_TEST(takeFiveTest);
 	CPPUNIT_TEST(writeTest);
+	CPPUNIT_TEST(seekTest);
+	CPPUNIT_TEST(indexReadTest);
+	CPPUNIT_TEST(indexRunningStatusTest);
+	CPPUNIT_TEST(indexStaleTest);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -77,6 +81,10 @@ public:
 	void createNewFileTest();
 	void takeFiveTest();
 	void writeTest();
+	void seekTest();
+	void indexReadTest();
+	void indexRunningStatusTest();
+	void indexStaleTest();
 
 private:
 	DummyTypeMap*     type_map;
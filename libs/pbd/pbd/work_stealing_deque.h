@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _pbd_work_stealing_deque_h_
+#define _pbd_work_stealing_deque_h_
+
+#include <cassert>
+#include <cstddef>
+#include <stdint.h>
+
+#include <glib.h>
+
+#include "pbd/g_atomic_compat.h"
+
+namespace PBD {
+
+/* Bounded lock-free single-owner, multiple-thief deque.
+ *
+ * The owning thread pushes and pops at the bottom (LIFO), other
+ * threads may concurrently steal from the top (FIFO).
+ *
+ * After D. Chase, Y. Lev "Dynamic Circular Work-Stealing Deque" (SPAA 2005),
+ * without the dynamic resize: the buffer must be reserved large enough
+ * in advance (and not while the deque is in use).
+ *
+ * glib atomic operations imply a full memory barrier, which
+ * provides the store/load ordering required between bottom and top.
+ *
+ * T is expected to be a pointer or other trivially copyable type.
+ */
+template <typename T>
+class /*LIBPBD_API*/ WorkStealingDeque
+{
+public:
+	WorkStealingDeque (size_t buffer_size = 8)
+		: _buffer (0)
+		, _buffer_mask (0)
+	{
+		reserve (buffer_size);
+	}
+
+	~WorkStealingDeque ()
+	{
+		delete[] _buffer;
+	}
+
+	/* not RT safe, must not be called concurrently with push/pop/steal */
+	void
+	reserve (size_t buffer_size)
+	{
+		size_t sz;
+		for (sz = 2; sz < buffer_size; sz <<= 1) ;
+		if (_buffer_mask >= sz - 1) {
+			return;
+		}
+		delete[] _buffer;
+		_buffer      = new T[sz];
+		_buffer_mask = sz - 1;
+		clear ();
+	}
+
+	/* must not be called concurrently with push/pop/steal */
+	void
+	clear ()
+	{
+		g_atomic_int_set (&_top, 0);
+		g_atomic_int_set (&_bottom, 0);
+	}
+
+	/* number of entries, only approximate while thieves are active */
+	size_t
+	size () const
+	{
+		gint b = g_atomic_int_get (&_bottom);
+		gint t = g_atomic_int_get (&_top);
+		return b > t ? b - t : 0;
+	}
+
+	bool
+	empty () const
+	{
+		return size () == 0;
+	}
+
+	/** Owner thread only: add an entry at the bottom
+	 * @return false if the deque is full, the entry was not added
+	 */
+	bool
+	push (T const& data)
+	{
+		gint b = g_atomic_int_get (&_bottom);
+		gint t = g_atomic_int_get (&_top);
+		if ((size_t)(b - t) > _buffer_mask) {
+			return false;
+		}
+		_buffer[b & _buffer_mask] = data;
+		g_atomic_int_set (&_bottom, b + 1);
+		return true;
+	}
+
+	/** Owner thread only: take the most recently pushed entry */
+	bool
+	pop (T& data)
+	{
+		gint b = g_atomic_int_get (&_bottom) - 1;
+		g_atomic_int_set (&_bottom, b);
+		gint t = g_atomic_int_get (&_top);
+
+		if (t > b) {
+			/* empty */
+			g_atomic_int_set (&_bottom, b + 1);
+			return false;
+		}
+
+		data = _buffer[b & _buffer_mask];
+
+		if (t == b) {
+			/* last entry, race against thieves */
+			bool rv = g_atomic_int_compare_and_exchange (&_top, t, t + 1);
+			g_atomic_int_set (&_bottom, b + 1);
+			return rv;
+		}
+		return true;
+	}
+
+	/** Any thread: take the oldest entry */
+	bool
+	steal (T& data)
+	{
+		gint t = g_atomic_int_get (&_top);
+		gint b = g_atomic_int_get (&_bottom);
+
+		if (t >= b) {
+			return false;
+		}
+
+		data = _buffer[t & _buffer_mask];
+		return g_atomic_int_compare_and_exchange (&_top, t, t + 1);
+	}
+
+private:
+	WorkStealingDeque (WorkStealingDeque const&);
+	WorkStealingDeque& operator= (WorkStealingDeque const&);
+
+	T*     _buffer;
+	size_t _buffer_mask;
+
+	/* keep thieves and owner on separate cache-lines */
+	char _pad0[64];
+	GATOMIC_QUAL gint _top;
+	char _pad1[64];
+	GATOMIC_QUAL gint _bottom;
+	char _pad2[64];
+};
+
+} /* namespace */
+
+#endif
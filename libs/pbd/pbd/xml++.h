@@ -87,6 +87,14 @@ public:
 	int compression() const { return _compression; }
 	int set_compression(int);
 
+	/* write() uses a compact binary encoding of the node tree instead of
+	 * XML. read() accepts either, and sets this to match the file read.
+	 */
+	bool binary() const { return _binary; }
+	void set_binary(bool yn) { _binary = yn; }
+
+	static bool is_binary(const std::string& fn);
+
 	bool read() { return read_internal(false); }
 	bool read(const std::string& fn) { set_filename(fn); return read_internal(false); }
 	bool read_and_validate() { return read_internal(true); }
@@ -104,11 +112,14 @@ public:
 
 private:
 	bool read_internal(bool validate);
+	bool read_binary();
+	bool write_binary() const;
 
 	std::string _filename;
 	XMLNode*    _root;
 	xmlDocPtr   _doc;
 	int         _compression;
+	bool        _binary;
 };
 
 class LIBPBD_API XMLNode {
@@ -83,6 +83,55 @@ XMLTest::testXMLFilenameEncoding ()
 	}
 }
 
+void
+XMLTest::testBinaryRoundTrip ()
+{
+	std::string testsession_path;
+	CPPUNIT_ASSERT (find_file (test_search_path (), "TestSession.ardour", testsession_path));
+
+	XMLTree xml (testsession_path);
+	CPPUNIT_ASSERT (xml.root ());
+	CPPUNIT_ASSERT (!xml.binary ());
+
+	const string output_dir  = test_output_directory ("BinaryRoundTrip");
+	const string binary_path = Glib::build_filename (output_dir, "TestSession.binary");
+	const string xml_path    = Glib::build_filename (output_dir, "TestSession.ardour");
+
+	xml.set_binary (true);
+	CPPUNIT_ASSERT (xml.write (binary_path));
+	CPPUNIT_ASSERT (XMLTree::is_binary (binary_path));
+	CPPUNIT_ASSERT (!XMLTree::is_binary (testsession_path));
+
+	/* reading detects the format */
+	XMLTree binary (binary_path);
+	CPPUNIT_ASSERT (binary.root ());
+	CPPUNIT_ASSERT (binary.binary ());
+	CPPUNIT_ASSERT (*binary.root () == *xml.root ());
+
+	/* XPath also works without a libxml2 document */
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, binary.find ("/Session")->size ());
+
+	/* and back to XML */
+	binary.set_binary (false);
+	CPPUNIT_ASSERT (binary.write (xml_path));
+
+	XMLTree exported (xml_path);
+	CPPUNIT_ASSERT (exported.root ());
+	CPPUNIT_ASSERT (!exported.binary ());
+	CPPUNIT_ASSERT (*exported.root () == *xml.root ());
+
+	/* a truncated file is rejected */
+	gchar* contents;
+	gsize  length;
+	CPPUNIT_ASSERT (g_file_get_contents (binary_path.c_str (), &contents, &length, NULL));
+	CPPUNIT_ASSERT (length > 100);
+	CPPUNIT_ASSERT (g_file_set_contents (binary_path.c_str (), contents, 100, NULL));
+	g_free (contents);
+
+	XMLTree truncated;
+	CPPUNIT_ASSERT (!truncated.read (binary_path));
+	CPPUNIT_ASSERT (!truncated.root ());
+}
 
 static const char * const root_node_name = "Session";
 static const char * const child_node_name = "Child";
@@ -225,6 +274,7 @@ test_xml_document (const std::string& test_name,
 	const std::string output_file_basename = Glib::build_filename (test_output_dir, test_name);
 
 	TimingData create_timing_data, write_timing_data, read_timing_data;
+	TimingData write_binary_timing_data, read_binary_timing_data;
 
 	for (uint32_t iter = 0; iter < test_iterations; ++iter) {
 
@@ -258,14 +308,35 @@ test_xml_document (const std::string& test_name,
 		// check that what we have read is identical to what was written
 		CPPUNIT_ASSERT (*read_doc.root() == *test_xml.root());
 
+		const std::string binary_file_path = output_file_basename + buf + ".bin";
+
+		test_xml.set_binary (true);
+
+		write_binary_timing_data.start_timing ();
+
+		test_xml.write (binary_file_path);
+
+		write_binary_timing_data.add_elapsed ();
+
+		read_binary_timing_data.start_timing ();
+
+		XMLTree read_binary_doc (binary_file_path);
+
+		read_binary_timing_data.add_elapsed ();
+
+		CPPUNIT_ASSERT (*read_binary_doc.root() == *test_xml.root());
+
 		// These files are too big to keep around
 		CPPUNIT_ASSERT (g_remove (output_file_path.c_str ()) == 0);
+		CPPUNIT_ASSERT (g_remove (binary_file_path.c_str ()) == 0);
 	}
 
 	std::cerr << std::endl;
 	std::cerr << "   Create : " << create_timing_data.summary ();
 	std::cerr << "   Write : " << write_timing_data.summary ();
 	std::cerr << "   Read : " << read_timing_data.summary ();
+	std::cerr << "   Write binary : " << write_binary_timing_data.summary ();
+	std::cerr << "   Read binary : " << read_binary_timing_data.summary ();
 }
 
 void
@@ -5,6 +5,7 @@ class XMLTest : public CppUnit::TestFixture
 {
 	CPPUNIT_TEST_SUITE (XMLTest);
 	CPPUNIT_TEST (testXMLFilenameEncoding);
+	CPPUNIT_TEST (testBinaryRoundTrip);
 	CPPUNIT_TEST (testPerfSmallXMLDocument);
 	CPPUNIT_TEST (testPerfMediumXMLDocument);
 	CPPUNIT_TEST (testPerfLargeXMLDocument);
@@ -12,6 +13,7 @@ class XMLTest : public CppUnit::TestFixture
 
 public:
 	void testXMLFilenameEncoding ();
+	void testBinaryRoundTrip ();
 	void testPerfSmallXMLDocument ();
 	void testPerfMediumXMLDocument ();
 	void testPerfLargeXMLDocument ();
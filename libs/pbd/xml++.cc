@@ -7,7 +7,11 @@
 
 #include <string.h>
 #include <iostream>
+#include <map>
 
+#include <glib.h>
+
+#include "pbd/gstdio_compat.h"
 #include "pbd/xml++.h"
 
 #include <libxml/debugXML.h>
@@ -22,11 +26,199 @@ static XMLNode*           readnode(xmlNodePtr);
 static void               writenode(xmlDocPtr, XMLNode*, xmlNodePtr, int);
 static XMLSharedNodeList* find_impl(xmlXPathContext* ctxt, const string& xpath);
 
+/* Binary encoding of an XMLNode tree:
+ *
+ *   magic (8 bytes), format version (1 byte), root node
+ *
+ *   node    : name, flags (1 byte, bit 0: content node), [content],
+ *             number of properties, (name, value) * n,
+ *             number of children, node * n
+ *
+ * Numbers are unsigned LEB128. Values and content are a length followed
+ * by the bytes. Node and property names are interned: a name is either 0
+ * followed by a length and the bytes, which adds it to the table of names,
+ * or 1 + its index in that table.
+ */
+static const char    binary_magic[8] = { 'A', 'r', 'd', 'o', 'u', 'r', 'X', 'B' };
+static const uint8_t binary_version  = 1;
+
+namespace {
+
+class BinaryWriter {
+public:
+	void write_number (uint64_t n) {
+		do {
+			uint8_t b = n & 0x7f;
+			n >>= 7;
+			if (n) {
+				b |= 0x80;
+			}
+			_buf += (char) b;
+		} while (n);
+	}
+
+	void write_string (const string& s) {
+		write_number (s.length ());
+		_buf += s;
+	}
+
+	void write_name (const string& s) {
+		map<string, uint64_t>::iterator i = _names.find (s);
+		if (i != _names.end ()) {
+			write_number (i->second + 1);
+		} else {
+			write_number (0);
+			write_string (s);
+			_names.insert (make_pair (s, (uint64_t) _names.size ()));
+		}
+	}
+
+	void write_node (const XMLNode& n) {
+		write_name (n.name ());
+		_buf += (char) (n.is_content () ? 1 : 0);
+		if (n.is_content ()) {
+			write_string (n.content ());
+		}
+
+		const XMLPropertyList& props = n.properties ();
+		write_number (props.size ());
+		for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+			write_name ((*i)->name ());
+			write_string ((*i)->value ());
+		}
+
+		const XMLNodeList& children = n.children ();
+		write_number (children.size ());
+		for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+			write_node (**i);
+		}
+	}
+
+	string& buffer () { return _buf; }
+
+private:
+	string                _buf;
+	map<string, uint64_t> _names;
+};
+
+class BinaryReader {
+public:
+	BinaryReader (const char* buf, size_t len)
+		: _pos (buf)
+		, _end (buf + len)
+	{}
+
+	bool read_number (uint64_t& n) {
+		n = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (_pos == _end) {
+				return false;
+			}
+			const uint8_t b = *_pos++;
+			n |= (uint64_t) (b & 0x7f) << shift;
+			if (!(b & 0x80)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool read_string (string& s) {
+		uint64_t len;
+		if (!read_number (len) || len > (uint64_t) (_end - _pos)) {
+			return false;
+		}
+		s.assign (_pos, len);
+		_pos += len;
+		return true;
+	}
+
+	bool read_name (string& s) {
+		uint64_t n;
+		if (!read_number (n)) {
+			return false;
+		}
+		if (n == 0) {
+			if (!read_string (s)) {
+				return false;
+			}
+			_names.push_back (s);
+			return true;
+		}
+		if (n > _names.size ()) {
+			return false;
+		}
+		s = _names[n - 1];
+		return true;
+	}
+
+	XMLNode* read_node () {
+		string   name;
+		string   value;
+		uint64_t n;
+
+		if (!read_name (name) || _pos == _end) {
+			return 0;
+		}
+
+		const uint8_t flags = *_pos++;
+		XMLNode*      node;
+
+		if (flags & 1) {
+			if (!read_string (value)) {
+				return 0;
+			}
+			node = new XMLNode (name, value);
+		} else {
+			node = new XMLNode (name);
+		}
+
+		if (!read_number (n)) {
+			delete node;
+			return 0;
+		}
+
+		for (uint64_t i = 0; i < n; ++i) {
+			if (!read_name (name) || !read_string (value)) {
+				delete node;
+				return 0;
+			}
+			node->set_property (name.c_str (), value);
+		}
+
+		if (!read_number (n)) {
+			delete node;
+			return 0;
+		}
+
+		for (uint64_t i = 0; i < n; ++i) {
+			XMLNode* child = read_node ();
+			if (!child) {
+				delete node;
+				return 0;
+			}
+			node->add_child_nocopy (*child);
+		}
+
+		return node;
+	}
+
+	bool at_end () const { return _pos == _end; }
+
+private:
+	const char*    _pos;
+	const char*    _end;
+	vector<string> _names;
+};
+
+} // anonymous namespace
+
 XMLTree::XMLTree()
 	: _filename()
 	, _root(0)
 	, _doc (0)
 	, _compression(0)
+	, _binary(false)
 {
 }
 
@@ -35,6 +227,7 @@ XMLTree::XMLTree(const string& fn, bool validate)
 	, _root(0)
 	, _doc (0)
 	, _compression(0)
+	, _binary(false)
 {
 	read_internal(validate);
 }
@@ -44,6 +237,7 @@ XMLTree::XMLTree(const XMLTree* from)
 	, _root(new XMLNode(*from->root()))
 	, _doc (xmlCopyDoc (from->_doc, 1))
 	, _compression(from->compression())
+	, _binary(from->binary())
 {
 
 }
@@ -85,6 +279,12 @@ XMLTree::read_internal(bool validate)
 		_doc = 0;
 	}
 
+	_binary = is_binary (_filename);
+
+	if (_binary) {
+		return read_binary ();
+	}
+
 	/* Calling this prevents libxml2 from treating whitespace as active
 	   nodes. It needs to be called before we create a parser context.
 	*/
@@ -123,6 +323,75 @@ XMLTree::read_internal(bool validate)
 	return true;
 }
 
+bool
+XMLTree::is_binary (const string& fn)
+{
+	char  magic[sizeof (binary_magic)];
+	FILE* f = g_fopen (fn.c_str (), "rb");
+
+	if (!f) {
+		return false;
+	}
+
+	const bool rv = fread (magic, 1, sizeof (magic), f) == sizeof (magic) && memcmp (magic, binary_magic, sizeof (magic)) == 0;
+
+	fclose (f);
+
+	return rv;
+}
+
+bool
+XMLTree::read_binary ()
+{
+	gchar* buf;
+	gsize  len;
+
+	if (!g_file_get_contents (_filename.c_str (), &buf, &len, NULL)) {
+		return false;
+	}
+
+	if (len <= sizeof (binary_magic) || (uint8_t) buf[sizeof (binary_magic)] != binary_version) {
+		std::cerr << "XMLTree: unsupported binary format in " << _filename << std::endl;
+		g_free (buf);
+		return false;
+	}
+
+	const size_t header = sizeof (binary_magic) + 1;
+	BinaryReader reader (buf + header, len - header);
+
+	_root = reader.read_node ();
+
+	if (_root && !reader.at_end ()) {
+		delete _root;
+		_root = 0;
+	}
+
+	g_free (buf);
+
+	return _root != 0;
+}
+
+bool
+XMLTree::write_binary () const
+{
+	BinaryWriter writer;
+
+	writer.buffer ().append (binary_magic, sizeof (binary_magic));
+	writer.buffer () += (char) binary_version;
+	writer.write_node (*_root);
+
+	FILE* f = g_fopen (_filename.c_str (), "wb");
+
+	if (!f) {
+		return false;
+	}
+
+	const string& buf = writer.buffer ();
+	const bool    ok  = fwrite (buf.data (), 1, buf.length (), f) == buf.length ();
+
+	return (fclose (f) == 0) && ok;
+}
+
 bool
 XMLTree::read_buffer (char const* buffer, bool to_tree_doc)
 {
@@ -161,6 +430,10 @@ XMLTree::write() const
 	XMLNodeList children;
 	int result;
 
+	if (_binary) {
+		return write_binary ();
+	}
+
 	xmlKeepBlanksDefault(0);
 	doc = xmlNewDoc(xml_version);
 	xmlSetDocCompressMode(doc, _compression);
@@ -469,9 +742,10 @@ XMLTree::find(const string xpath, XMLNode* node) const
 	xmlXPathContext* ctxt;
 	xmlDocPtr doc = 0;
 
-	if (node) {
+	if (node || !_doc) {
+		/* no document if the tree was read from a binary file */
 		doc = xmlNewDoc(xml_version);
-		writenode(doc, node, doc->children, 1);
+		writenode(doc, node ? node : _root, doc->children, 1);
 		ctxt = xmlXPathNewContext(doc);
 	} else {
 		ctxt = xmlXPathNewContext(_doc);
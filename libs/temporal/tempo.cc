@@ -673,6 +673,217 @@ TempoMapPoint::end_float ()
 
 /* TEMPOMAP */
 
+namespace {
+
+/* The times of a sequence of points, in one time domain */
+template<typename T>
+struct IndexColumn
+{
+	IndexColumn () : sorted (true) {}
+
+	std::vector<T> times;
+	bool           sorted;
+
+	void push_back (T const & t) {
+		if (!times.empty() && t < times.back()) {
+			sorted = false;
+		}
+		times.push_back (t);
+	}
+
+	/* @return the number of points before @param t, or at or before @param
+	 * t if @param can_match is true.
+	 */
+	size_t count (T const & t, bool can_match) const {
+		if (can_match) {
+			return std::upper_bound (times.begin(), times.end(), t) - times.begin();
+		}
+		return std::lower_bound (times.begin(), times.end(), t) - times.begin();
+	}
+
+	/* @return true if count (t, can_match) would return @param n, without
+	 * searching.
+	 */
+	bool is_count (size_t n, T const & t, bool can_match) const {
+		if (n > times.size()) {
+			return false;
+		}
+		if (can_match) {
+			return (n == 0 || !(t < times[n-1])) && (n == times.size() || t < times[n]);
+		}
+		return (n == 0 || times[n-1] < t) && (n == times.size() || !(times[n] < t));
+	}
+};
+
+/* The times of a sequence of points, in all three time domains */
+struct IndexTimes
+{
+	IndexColumn<superclock_t> sclocks;
+	IndexColumn<Beats>        beats;
+	IndexColumn<BBT_Time>     bbts;
+
+	void reserve (size_t n) {
+		sclocks.times.reserve (n);
+		beats.times.reserve (n);
+		bbts.times.reserve (n);
+	}
+
+	void push_back (Point const & p) {
+		sclocks.push_back (p.sclock());
+		beats.push_back (p.beats());
+		bbts.push_back (p.bbt());
+	}
+
+	IndexColumn<superclock_t> const & column (superclock_t) const { return sclocks; }
+	IndexColumn<Beats> const &        column (Beats const &) const { return beats; }
+	IndexColumn<BBT_Time> const &     column (BBT_Time const &) const { return bbts; }
+};
+
+/* The result of the last search of a TempoMap::Index in this thread.
+ *
+ * Consecutive conversions, e.g. during one process cycle, mostly fall
+ * between the same two points, and can skip the search.
+ */
+struct LastMetric {
+	uint64_t generation;
+	size_t   count;
+};
+
+thread_local LastMetric last_metric = { 0, 0 };
+
+/* Incremented for every index, only while holding the tempo map RCU
+ * write lock (or during ::init())
+ */
+uint64_t index_generation = 0;
+
+} /* anonymous namespace */
+
+struct TempoMap::Index
+{
+	/* unique for each index, and so for each published map */
+	uint64_t generation;
+
+	/* all points, with the tempo and meter in effect at each of them */
+	IndexTimes                     points;
+	std::vector<TempoPoint const*> point_tempos;
+	std::vector<MeterPoint const*> point_meters;
+
+	/* just the tempo and meter points (excluding music time points) */
+	IndexTimes                     tempo_times;
+	std::vector<TempoPoint const*> tempos;
+	IndexTimes                     meter_times;
+	std::vector<MeterPoint const*> meters;
+
+	/* The same result as TempoMap::_get_tempo_and_meter(), as long as the
+	 * points are sorted in the time domain of @param arg.
+	 *
+	 * @return false if the index cannot be used.
+	 */
+	template<typename T> bool get_tempo_and_meter (TempoPoint const *& tp, MeterPoint const *& mp, T const & arg, bool can_match) const {
+		IndexColumn<T> const & c (points.column (arg));
+
+		if (!c.sorted) {
+			return false;
+		}
+
+		/* see TempoMap::_get_tempo_and_meter() */
+		can_match = (can_match || arg == T());
+
+		size_t n;
+
+		if (last_metric.generation == generation && c.is_count (last_metric.count, arg, can_match)) {
+			n = last_metric.count;
+		} else {
+			n = c.count (arg, can_match);
+			last_metric.generation = generation;
+			last_metric.count = n;
+		}
+
+		if (n == 0) {
+			tp = tempos.front();
+			mp = meters.front();
+		} else {
+			tp = point_tempos[n-1];
+			mp = point_meters[n-1];
+		}
+
+		return true;
+	}
+
+	/* The same results as TempoMap::_tempo_at() and TempoMap::_meter_at(),
+	 * or null if the index cannot be used.
+	 */
+	template<typename T> TempoPoint const * tempo_at (T const & arg) const {
+		IndexColumn<T> const & c (tempo_times.column (arg));
+		if (!c.sorted) {
+			return 0;
+		}
+		const size_t n = c.count (arg, false);
+		return n ? tempos[n-1] : tempos.front();
+	}
+
+	template<typename T> MeterPoint const * meter_at (T const & arg) const {
+		IndexColumn<T> const & c (meter_times.column (arg));
+		if (!c.sorted) {
+			return 0;
+		}
+		const size_t n = c.count (arg, false);
+		return n ? meters[n-1] : meters.front();
+	}
+};
+
+void
+TempoMap::build_index ()
+{
+	assert (!_tempos.empty());
+	assert (!_meters.empty());
+
+	Index* index = new Index;
+
+	index->generation = ++index_generation;
+
+	index->points.reserve (_points.size());
+	index->point_tempos.reserve (_points.size());
+	index->point_meters.reserve (_points.size());
+
+	TempoPoint const * tp = &_tempos.front();
+	MeterPoint const * mp = &_meters.front();
+
+	for (Points::const_iterator p = _points.begin(); p != _points.end(); ++p) {
+		TempoPoint const * tpp;
+		MeterPoint const * mpp;
+
+		if ((tpp = dynamic_cast<TempoPoint const *> (&*p)) != 0) {
+			tp = tpp;
+		}
+		if ((mpp = dynamic_cast<MeterPoint const *> (&*p)) != 0) {
+			mp = mpp;
+		}
+
+		index->points.push_back (*p);
+		index->point_tempos.push_back (tp);
+		index->point_meters.push_back (mp);
+	}
+
+	index->tempo_times.reserve (_tempos.size());
+	index->tempos.reserve (_tempos.size());
+
+	for (Tempos::const_iterator t = _tempos.begin(); t != _tempos.end(); ++t) {
+		index->tempo_times.push_back (*t);
+		index->tempos.push_back (&*t);
+	}
+
+	index->meter_times.reserve (_meters.size());
+	index->meters.reserve (_meters.size());
+
+	for (Meters::const_iterator m = _meters.begin(); m != _meters.end(); ++m) {
+		index->meter_times.push_back (*m);
+		index->meters.push_back (&*m);
+	}
+
+	_index.reset (index);
+}
+
 TempoMap::TempoMap (Tempo const & initial_tempo, Meter const & initial_meter)
 	: _time_domain (AudioTime)
 {
@@ -705,6 +916,7 @@ TempoMap&
 TempoMap::operator= (TempoMap const & other)
 {
 	_time_domain = other.time_domain();
+	_index.reset ();
 	copy_points (other);
 	return *this;
 }
@@ -2926,7 +3138,9 @@ TempoMap::metric_at (superclock_t sc, bool can_match) const
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
-	(void) get_tempo_and_meter (tp, mp, sc, can_match, false);
+	if (!_index || !_index->get_tempo_and_meter (tp, mp, sc, can_match)) {
+		(void) get_tempo_and_meter (tp, mp, sc, can_match, false);
+	}
 
 	return TempoMetric (*tp,* mp);
 }
@@ -2937,7 +3151,9 @@ TempoMap::metric_at (Beats const & b, bool can_match) const
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
-	(void) get_tempo_and_meter (tp, mp, b, can_match, false);
+	if (!_index || !_index->get_tempo_and_meter (tp, mp, b, can_match)) {
+		(void) get_tempo_and_meter (tp, mp, b, can_match, false);
+	}
 
 	return TempoMetric (*tp, *mp);
 }
@@ -2948,11 +3164,73 @@ TempoMap::metric_at (BBT_Time const & bbt, bool can_match) const
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
-	(void) get_tempo_and_meter (tp, mp, bbt, can_match, false);
+	if (!_index || !_index->get_tempo_and_meter (tp, mp, bbt, can_match)) {
+		(void) get_tempo_and_meter (tp, mp, bbt, can_match, false);
+	}
 
 	return TempoMetric (*tp, *mp);
 }
 
+TempoPoint const &
+TempoMap::tempo_at (superclock_t sc) const
+{
+	TempoPoint const * tp;
+	if (_index && (tp = _index->tempo_at (sc)) != 0) {
+		return *tp;
+	}
+	return _tempo_at (sc, Point::sclock_comparator());
+}
+
+TempoPoint const &
+TempoMap::tempo_at (Beats const & b) const
+{
+	TempoPoint const * tp;
+	if (_index && (tp = _index->tempo_at (b)) != 0) {
+		return *tp;
+	}
+	return _tempo_at (b, Point::beat_comparator());
+}
+
+TempoPoint const &
+TempoMap::tempo_at (BBT_Time const & bbt) const
+{
+	TempoPoint const * tp;
+	if (_index && (tp = _index->tempo_at (bbt)) != 0) {
+		return *tp;
+	}
+	return _tempo_at (bbt, Point::bbt_comparator());
+}
+
+MeterPoint const &
+TempoMap::meter_at (superclock_t sc) const
+{
+	MeterPoint const * mp;
+	if (_index && (mp = _index->meter_at (sc)) != 0) {
+		return *mp;
+	}
+	return _meter_at (sc, Point::sclock_comparator());
+}
+
+MeterPoint const &
+TempoMap::meter_at (Beats const & b) const
+{
+	MeterPoint const * mp;
+	if (_index && (mp = _index->meter_at (b)) != 0) {
+		return *mp;
+	}
+	return _meter_at (b, Point::beat_comparator());
+}
+
+MeterPoint const &
+TempoMap::meter_at (BBT_Time const & bbt) const
+{
+	MeterPoint const * mp;
+	if (_index && (mp = _index->meter_at (bbt)) != 0) {
+		return *mp;
+	}
+	return _meter_at (bbt, Point::bbt_comparator());
+}
+
 void
 TempoMap::set_ramped (TempoPoint & tp, bool yn)
 {
@@ -3183,6 +3461,7 @@ void
 TempoMap::init ()
 {
 	WritableSharedPtr new_map (new TempoMap (Tempo (120, 4), Meter (4, 4)));
+	new_map->build_index ();
 	_map_mgr.init (new_map);
 	fetch ();
 }
@@ -3196,6 +3475,9 @@ TempoMap::write_copy()
 int
 TempoMap::update (TempoMap::WritableSharedPtr m)
 {
+	/* the map must not be modified after this */
+	m->build_index ();
+
 	if (!_map_mgr.update (m)) {
 		return -1;
 	}
@@ -807,14 +807,14 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 
   public:
 	LIBTEMPORAL_API	MeterPoint const& meter_at (timepos_t const & p) const;
-	LIBTEMPORAL_API	MeterPoint const& meter_at (superclock_t sc) const { return _meter_at (sc, Point::sclock_comparator()); }
-	LIBTEMPORAL_API	MeterPoint const& meter_at (Beats const & b) const { return _meter_at (b, Point::beat_comparator()); }
-	LIBTEMPORAL_API	MeterPoint const& meter_at (BBT_Time const & bbt) const { return _meter_at (bbt, Point::bbt_comparator()); }
+	LIBTEMPORAL_API	MeterPoint const& meter_at (superclock_t sc) const;
+	LIBTEMPORAL_API	MeterPoint const& meter_at (Beats const & b) const;
+	LIBTEMPORAL_API	MeterPoint const& meter_at (BBT_Time const & bbt) const;
 
 	LIBTEMPORAL_API	TempoPoint const& tempo_at (timepos_t const & p) const;
-	LIBTEMPORAL_API	TempoPoint const& tempo_at (superclock_t sc) const { return _tempo_at (sc, Point::sclock_comparator()); }
-	LIBTEMPORAL_API	TempoPoint const& tempo_at (Beats const & b) const { return _tempo_at (b, Point::beat_comparator()); }
-	LIBTEMPORAL_API TempoPoint const& tempo_at (BBT_Time const & bbt) const { return _tempo_at (bbt, Point::bbt_comparator()); }
+	LIBTEMPORAL_API	TempoPoint const& tempo_at (superclock_t sc) const;
+	LIBTEMPORAL_API	TempoPoint const& tempo_at (Beats const & b) const;
+	LIBTEMPORAL_API TempoPoint const& tempo_at (BBT_Time const & bbt) const;
 
 	LIBTEMPORAL_API TempoPoint const* previous_tempo (TempoPoint const &) const;
 
@@ -892,6 +892,20 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 
 	TimeDomain _time_domain;
 
+	/* A sorted, random-access copy of the points for O(log N) lookups in
+	 * each of the three time domains. It is built by ::update() (and
+	 * ::init()) before the map is published, so that it is shared
+	 * read-only by all threads using the map. Maps that are not (yet)
+	 * published have no index, and use the linear searches.
+	 *
+	 * Each thread remembers the result of its last search of an index,
+	 * which is reused while conversions stay between the same two points.
+	 */
+	struct Index;
+	boost::shared_ptr<Index const> _index;
+
+	void build_index ();
+
 	int set_tempos_from_state (XMLNode const &);
 	int set_meters_from_state (XMLNode const &);
 	int set_music_times_from_state (XMLNode const &);
@@ -0,0 +1,167 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+#include <glibmm/thread.h>
+
+#include "pbd/microseconds.h"
+#include "pbd/pbd.h"
+#include "pbd/stateful.h"
+#include "pbd/xml++.h"
+
+#include "temporal/tempo.h"
+#include "temporal/types.h"
+
+using namespace Temporal;
+
+/* Create a map with a tempo change on every bar, like a film score */
+static XMLNode&
+tempo_map_state (int n_tempos)
+{
+	TempoMap::SharedPtr tmap (TempoMap::use ());
+	XMLNode&            state (tmap->get_state ());
+	XMLNode*            tempos = state.child (X_("Tempos"));
+
+	assert (tempos);
+
+	MeterPoint const & meter (tmap->meter_at (superclock_t (0)));
+	TempoPoint         prev (tmap->tempo_at (superclock_t (0)));
+
+	for (int i = 1; i < n_tempos; ++i) {
+		const Beats  b (i * 4, 0);
+		superclock_t sc = TempoMetric (prev, meter).superclock_at (b);
+		TempoPoint   tp (*tmap, Tempo (100 + (i % 40), 4), sc, b, BBT_Time (i + 1, 1, 0));
+
+		tempos->add_child_nocopy (tp.get_state ());
+		prev = tp;
+	}
+
+	return state;
+}
+
+static void
+run (char const* name, TempoMap const & tmap, int lookups, superclock_t len)
+{
+	srand (1);
+
+	int64_t            sum   = 0;
+	PBD::microseconds_t start = PBD::get_microseconds ();
+
+	for (int i = 0; i < lookups; ++i) {
+		const superclock_t sc = (superclock_t) ((rand () / (double) RAND_MAX) * len);
+		sum += tmap.quarters_at_superclock (sc).to_ticks ();
+	}
+
+	PBD::microseconds_t elapsed = PBD::get_microseconds () - start;
+	printf ("%-8s superclock -> beats %10.4f usec/call\n", name, elapsed / (double) lookups);
+
+	/* sequential access, as during playback: 1024 samples at 48kHz per cycle */
+	const superclock_t cycle = samples_to_superclock (1024, 48000);
+
+	start = PBD::get_microseconds ();
+
+	for (int i = 0; i < lookups; ++i) {
+		sum += tmap.quarters_at_superclock ((i * cycle) % len).to_ticks ();
+	}
+
+	elapsed = PBD::get_microseconds () - start;
+	printf ("%-8s superclock -> beats %10.4f usec/call (sequential)\n", name, elapsed / (double) lookups);
+
+	const Beats end (tmap.quarters_at_superclock (len));
+
+	start = PBD::get_microseconds ();
+
+	for (int i = 0; i < lookups; ++i) {
+		const Beats b (Beats::ticks ((int64_t) ((rand () / (double) RAND_MAX) * end.to_ticks ())));
+		sum += tmap.superclock_at (b);
+	}
+
+	elapsed = PBD::get_microseconds () - start;
+	printf ("%-8s beats -> superclock %10.4f usec/call\n", name, elapsed / (double) lookups);
+
+	start = PBD::get_microseconds ();
+
+	for (int i = 0; i < lookups; ++i) {
+		const Beats b (Beats::ticks ((int64_t) ((rand () / (double) RAND_MAX) * end.to_ticks ())));
+		sum += tmap.bbt_at (b).bars;
+	}
+
+	elapsed = PBD::get_microseconds () - start;
+	printf ("%-8s beats -> BBT        %10.4f usec/call\n", name, elapsed / (double) lookups);
+
+	assert (sum != 0);
+}
+
+int
+main (int argc, char* argv[])
+{
+	int n_tempos = 5000;
+	int lookups  = 100000;
+
+	if (argc > 1) {
+		n_tempos = atoi (argv[1]);
+	}
+	if (argc > 2) {
+		lookups = atoi (argv[2]);
+	}
+
+	if (!Glib::thread_supported ()) {
+		Glib::thread_init ();
+	}
+
+	if (!PBD::init ()) {
+		return 1;
+	}
+
+	Temporal::init ();
+
+	XMLNode& state (tempo_map_state (n_tempos));
+
+	printf ("# %d tempos, %d lookups\n", n_tempos, lookups);
+
+	/* a map that is not published uses the linear searches */
+	TempoMap linear (state, PBD::Stateful::current_state_version);
+
+	/* publish a map, which builds the index */
+	TempoMap::WritableSharedPtr indexed (TempoMap::write_copy ());
+	indexed.reset (new TempoMap (state, PBD::Stateful::current_state_version));
+
+	PBD::microseconds_t start = PBD::get_microseconds ();
+	TempoMap::update (indexed);
+	PBD::microseconds_t elapsed = PBD::get_microseconds () - start;
+
+	printf ("publish (build index)     %10.3f msec\n", elapsed / 1000.0);
+
+	const superclock_t len = indexed->superclock_at (Beats (n_tempos * 4, 0));
+
+	/* both must give the same results */
+	for (int i = 0; i < 1000; ++i) {
+		const superclock_t sc = (len / 1000) * i;
+		assert (linear.quarters_at_superclock (sc) == indexed->quarters_at_superclock (sc));
+		assert (linear.bbt_at (Beats (i, 0)) == indexed->bbt_at (Beats (i, 0)));
+		(void) sc;
+	}
+
+	run ("linear", linear, lookups, len);
+	run ("indexed", *indexed, lookups, len);
+
+	delete &state;
+
+	return 0;
+}
@@ -18,6 +18,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include <boost/scoped_array.hpp>
@@ -84,6 +85,7 @@ WaveView::WaveView (Canvas* c, boost::shared_ptr<ARDOUR::AudioRegion> region)
 	, _shape_independent (false)
 	, _logscaled_independent (false)
 	, _gradient_depth_independent (false)
+	, _rendered (false)
 	, _draw_image_in_gui_thread (false)
 	, _always_draw_image_in_gui_thread (false)
 {
@@ -97,6 +99,7 @@ WaveView::WaveView (Item* parent, boost::shared_ptr<ARDOUR::AudioRegion> region)
 	, _shape_independent (false)
 	, _logscaled_independent (false)
 	, _gradient_depth_independent (false)
+	, _rendered (false)
 	, _draw_image_in_gui_thread (false)
 	, _always_draw_image_in_gui_thread (false)
 {
@@ -121,6 +124,8 @@ WaveView::init ()
 
 WaveView::~WaveView ()
 {
+	cancel_draw_requests ();
+
 #ifdef ENABLE_THREADED_WAVEFORM_RENDERING
 	WaveViewThreads::deinitialize ();
 #endif
@@ -265,21 +270,20 @@ WaveView::prepare_for_render (Rect const& area) const
 	required_props.set_sample_positions_from_pixel_offsets (image_start_pixel_offset,
 	                                                        image_end_pixel_offset);
 
-	if (!required_props.is_valid ()) {
+	if (!required_props.is_valid () || required_props.get_length_samples () == 0) {
 		return;
 	}
 
-	if (_image) {
-		if (_image->props.is_equivalent (required_props)) {
-			return;
-		} else {
-			// Image does not contain sample area required
-		}
-	}
+	cancel_stale_draw_requests ();
 
-	boost::shared_ptr<WaveViewDrawRequest> request = create_draw_request (required_props);
+	int64_t const first_tile = required_props.tile_index_at (required_props.get_sample_start ());
+	int64_t const last_tile = required_props.tile_index_at (required_props.get_sample_end () - 1);
 
-	queue_draw_request (request);
+	for (int64_t index = first_tile; index <= last_tile; ++index) {
+		get_tile (index, false);
+	}
+
+	queue_adjacent_draw_requests (first_tile, last_tile);
 }
 
 bool
@@ -329,7 +333,7 @@ WaveView::get_item_and_draw_rect_in_window_coords (Rect const& canvas_rect, Rect
 }
 
 void
-WaveView::queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const& request) const
+WaveView::queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const& request, bool speculative) const
 {
 	// Don't enqueue any requests without a thread to dequeue them.
 	assert (WaveViewThreads::enabled());
@@ -338,30 +342,111 @@ WaveView::queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const& requ
 		return;
 	}
 
-	if (current_request) {
-		current_request->cancel ();
-	}
+	// Add it to the cache so that other WaveViews can refer to the same image
+	// while it is drawn
+	get_cache_group()->add_image (request->image);
 
-	boost::shared_ptr<WaveViewImage> cached_image =
-	    get_cache_group ()->lookup_image (request->image->props);
+	_pending_requests.push_back (request);
 
-	if (cached_image) {
-		// The image may not be finished at this point but that is fine, great in
-		// fact as it means it should only need to be drawn once.
-		request->image = cached_image;
-		current_request = request;
+	if (speculative) {
+		WaveViewThreads::enqueue_speculative_draw_request (_pending_requests.back ());
 	} else {
-		// now we can finally set an optimal image now that we are not using the
-		// properties for comparisons.
-		request->image->props.set_width_samples (optimal_image_width_samples ());
+		WaveViewThreads::enqueue_draw_request (_pending_requests.back ());
+	}
+}
+
+void
+WaveView::queue_adjacent_draw_requests (int64_t first_tile, int64_t last_tile) const
+{
+	/* Prefetch the tiles on either side of the visible ones, so that
+	 * scrolling does not have to wait for them. They are rendered only when
+	 * the drawing threads have nothing else to do and may be evicted from
+	 * the cache before they are ever displayed.
+	 */
+
+	WaveViewProperties const& props (*_props);
+
+	if (first_tile > props.tile_index_at (props.region_start)) {
+		get_tile (first_tile - 1, true);
+	}
+
+	if (props.region_end > 0 && last_tile < props.tile_index_at (props.region_end - 1)) {
+		get_tile (last_tile + 1, true);
+	}
+}
+
+boost::shared_ptr<WaveViewImage>
+WaveView::get_tile (int64_t index, bool speculative) const
+{
+	WaveViewProperties tile_props = *_props;
+	tile_props.set_tile (index);
+
+	boost::shared_ptr<WaveViewImage> image = get_cache_group ()->lookup_image (tile_props);
+
+	if (image) {
+		// The image may not be finished at this point, if it was queued by
+		// this or another WaveView of the same source.
+		if (!speculative && !image->finished ()) {
+			// it is visible now, don't wait for idle drawing threads
+			WaveViewThreads::promote_draw_request (image);
+		}
+		return image;
+	}
+
+	if (!tile_props.is_valid () || tile_props.get_length_samples () == 0) {
+		return image;
+	}
+
+	boost::shared_ptr<WaveViewDrawRequest> const request = create_draw_request (tile_props);
+
+	queue_draw_request (request, speculative);
+
+	return request->image;
+}
 
-		current_request = request;
+void
+WaveView::cancel_draw_request (boost::shared_ptr<WaveViewImage> const& image) const
+{
+	for (std::list<boost::shared_ptr<WaveViewDrawRequest> >::iterator i = _pending_requests.begin (); i != _pending_requests.end (); ++i) {
+		if ((*i)->image == image) {
+			(*i)->cancel ();
+			WaveViewCache::get_instance ()->discard_image (image);
+			_pending_requests.erase (i);
+			return;
+		}
+	}
+}
 
-		// Add it to the cache so that other WaveViews can refer to the same image
-		get_cache_group()->add_image (current_request->image);
+void
+WaveView::cancel_stale_draw_requests () const
+{
+	for (std::list<boost::shared_ptr<WaveViewDrawRequest> >::iterator i = _pending_requests.begin (); i != _pending_requests.end ();) {
+		boost::shared_ptr<WaveViewDrawRequest> const& request (*i);
+
+		if (request->finished ()) {
+			i = _pending_requests.erase (i);
+		} else if (!request->image->props.has_same_appearance (*_props)) {
+			// e.g. the zoom level changed, the image would not be used
+			request->cancel ();
+			WaveViewCache::get_instance ()->discard_image (request->image);
+			i = _pending_requests.erase (i);
+		} else {
+			++i;
+		}
+	}
+}
 
-		WaveViewThreads::enqueue_draw_request (current_request);
+void
+WaveView::cancel_draw_requests () const
+{
+	for (std::list<boost::shared_ptr<WaveViewDrawRequest> >::iterator i = _pending_requests.begin (); i != _pending_requests.end (); ++i) {
+		if ((*i)->finished ()) {
+			continue;
+		}
+		(*i)->cancel ();
+		WaveViewCache::get_instance ()->discard_image ((*i)->image);
 	}
+	_pending_requests.clear ();
 }
 
 void
@@ -797,80 +882,6 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 	context->fill ();
 }
 
-samplecnt_t
-WaveView::optimal_image_width_samples () const
-{
-	/* Compute how wide the image should be in samples.
-	 *
-	 * The resulting image should be wider than the canvas width so that the
-	 * image does not have to be redrawn each time the canvas offset changes, but
-	 * drawing too much unnecessarily, for instance when zooming into the canvas
-	 * the part of the image that is outside of the visible canvas area may never
-	 * be displayed and will just increase apparent render time and reduce
-	 * responsiveness in non-threaded rendering and cause "flashing" waveforms in
-	 * threaded rendering mode.
-	 *
-	 * Another thing to consider is that if there are a number of waveforms on
-	 * the canvas that are the width of the canvas then we don't want to have to
-	 * draw the images for them all at once as it will cause a spike in render
-	 * time, or in threaded rendering mode it will mean all the draw requests will
-	 * the queued during the same sample/expose event. This issue can be
-	 * alleviated by using an element of randomness in selecting the image width.
-	 *
-	 * If the value of samples per pixel is less than 1/10th of a second, use
-	 * 1/10th of a second instead.
-	 */
-
-	samplecnt_t canvas_width_samples = _canvas->visible_area().width() * _props->samples_per_pixel;
-	const samplecnt_t one_tenth_of_second = _region->session().sample_rate() / 10;
-
-	/* If zoomed in where a canvas item interects with the canvas area but
-	 * stretches for many pages either side, to avoid having draw all images when
-	 * the canvas scrolls by a page width the multiplier would have to be a
-	 * randomized amount centered around 3 times the visible canvas width, but
-	 * for other operations like zooming or even with a stationary playhead it is
-	 * a lot of extra drawing that can affect performance.
-	 *
-	 * So without making things too complicated with different widths for
-	 * different operations, try to use a width that is a balance and will work
-	 * well for scrolling(non-page width) so all the images aren't redrawn at the
-	 * same time but also faster for sequential zooming operations.
-	 *
-	 * Canvas items that don't intersect with the edges of the visible canvas
-	 * will of course only draw images that are the pixel width of the item.
-	 *
-	 * It is a perhaps a coincidence that these values are centered roughly
-	 * around the golden ratio but they did work well in my testing.
-	 */
-	const double min_multiplier = 1.4;
-	const double max_multiplier = 1.8;
-
-	/**
-	 * A combination of high resolution screens, high samplerates and high
-	 * zoom levels(1 sample per pixel) can cause 1/10 of a second(in
-	 * pixels) to exceed the cairo image size limit.
-	 */
-	const double cairo_image_limit = 32767.0;
-	const double max_image_width = cairo_image_limit / max_multiplier;
-
-	samplecnt_t max_width_samples = floor (max_image_width / _props->samples_per_pixel);
-
-	const samplecnt_t one_tenth_of_second_limited = std::min (one_tenth_of_second, max_width_samples);
-
-	samplecnt_t new_sample_count = std::max (canvas_width_samples, one_tenth_of_second_limited);
-
-	const double multiplier = g_random_double_range (min_multiplier, max_multiplier);
-
-	return new_sample_count * multiplier;
-}
-
-void
-WaveView::set_image (boost::shared_ptr<WaveViewImage> img) const
-{
-	get_cache_group ()->add_image (img);
-	_image = img;
-}
-
 void
 WaveView::process_draw_request (boost::shared_ptr<WaveViewDrawRequest> req)
 {
@@ -999,141 +1010,195 @@ WaveView::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) cons
 
 	assert (required_props.is_valid());
 
-	boost::shared_ptr<WaveViewImage> image_to_draw;
-
-	if (current_request) {
-		if (!current_request->image->props.is_equivalent (required_props)) {
-			// The WaveView properties may have been updated during recording between
-			// prepare_for_render and render calls and the new required props have
-			// different end sample value.
-			current_request->cancel ();
-			current_request.reset ();
-		} else if (current_request->finished ()) {
-			image_to_draw = current_request->image;
-			current_request.reset ();
-		}
-	} else {
-		// No current Request
-	}
-
-	if (!image_to_draw && _image) {
-		if (_image->props.is_equivalent (required_props)) {
-			// Image contains required properties
-			image_to_draw = _image;
-		} else {
-			// Image does not contain properties required
-		}
+	if (required_props.get_length_samples () == 0) {
+		return;
 	}
 
-	if (!image_to_draw) {
-		image_to_draw = get_cache_group ()->lookup_image (required_props);
-		if (image_to_draw && !image_to_draw->finished ()) {
-			// Found equivalent but unfinished Image in cache
-			image_to_draw.reset ();
-		}
-	}
+	cancel_stale_draw_requests ();
 
-	if (!image_to_draw) {
-		// No existing image to draw
+	bool const in_gui_thread = draw_image_in_gui_thread ();
+	bool incomplete = false;
 
-		boost::shared_ptr<WaveViewDrawRequest> const request = create_draw_request (required_props);
+	int64_t const first_tile = required_props.tile_index_at (required_props.get_sample_start ());
+	int64_t const last_tile = required_props.tile_index_at (required_props.get_sample_end () - 1);
 
-		if (draw_image_in_gui_thread ()) {
-			// now that we have to draw something, draw more than required.
-			request->image->props.set_width_samples (optimal_image_width_samples ());
+	for (int64_t index = first_tile; index <= last_tile; ++index) {
 
-			process_draw_request (request);
+		WaveViewProperties tile_props = *_props;
+		tile_props.set_tile (index);
 
-			image_to_draw = request->image;
+		/* the part of the draw area covered by this tile */
+		Rect tile_area = draw;
+		tile_area.x0 = std::max (draw.x0, sample_to_window_x (self, context, tile_props.get_sample_start ()));
+		tile_area.x1 = std::min (draw.x1, sample_to_window_x (self, context, tile_props.get_sample_end ()));
 
-		} else if (current_request) {
-			if (current_request->finished ()) {
-				// There is a chance the request is now finished since checking above
-				image_to_draw = current_request->image;
-				current_request.reset ();
-			} else if (_canvas->get_microseconds_since_render_start () < 15000) {
-				current_request->cancel ();
-				current_request.reset ();
+		if (tile_area.x0 >= tile_area.x1) {
+			continue;
+		}
 
-				// Drawing image in GUI thread as we have time
+		boost::shared_ptr<WaveViewImage> image;
 
-				// now that we have to draw something, draw more than required.
-				request->image->props.set_width_samples (optimal_image_width_samples ());
+		if (in_gui_thread) {
+			image = get_cache_group ()->lookup_image (tile_props);
+		} else {
+			image = get_tile (index, false);
+		}
 
-				process_draw_request (request);
+		if (image && !image->finished ()) {
+			if (!in_gui_thread) {
+				// Not finished yet, draw what we have at another zoom level
+				if (draw_scaled_tiles (context, self, tile_area, tile_props)) {
+					incomplete = true;
+					continue;
+				}
 
-				image_to_draw = request->image;
-			} else {
-				// Waiting for current request to finish
-				redraw ();
-				return;
+				if (_canvas->get_microseconds_since_render_start () >= 15000) {
+					// Waiting for a thread to draw the tile
+					incomplete = true;
+					continue;
+				}
 			}
-		} else {
-			// Defer the rendering to another thread or perhaps render pass if
-			// a thread cannot generate it in time.
-			queue_draw_request (request);
-			redraw ();
-			return;
-		}
-	}
 
-	/* reset this so that future missing images can be generated in a worker thread. */
-	_draw_image_in_gui_thread = false;
+			// Drawing image in GUI thread as we have time
+			cancel_draw_request (image);
+			image.reset ();
+		}
 
-	assert (image_to_draw);
+		if (!image) {
+			// Drawing image in GUI thread as we have to or have time
 
-	/* compute the first pixel of the image that should be used when we
-	 * render the specified range.
-	 */
+			boost::shared_ptr<WaveViewDrawRequest> const request = create_draw_request (tile_props);
 
-	double image_origin_in_self_coordinates =
-	    (image_to_draw->props.get_sample_start () - _props->region_start) / _props->samples_per_pixel;
+			process_draw_request (request);
 
-	/* the image may only be a best-effort ... it may not span the entire
-	 * range requested, though it is guaranteed to cover the start. So
-	 * determine how many pixels we can actually draw.
-	 */
+			// Does not replace an equivalent image that is still being drawn
+			get_cache_group ()->add_image (request->image);
 
-	const double draw_start_pixel = draw.x0;
-	const double draw_end_pixel = draw.x1;
+			image = request->image;
+		}
 
-	double draw_width_pixels = draw_end_pixel - draw_start_pixel;
+		draw_tile (context, self, tile_area, image);
+	}
 
-	if (image_to_draw != _image) {
+	if (WaveViewThreads::enabled ()) {
+		queue_adjacent_draw_requests (first_tile, last_tile);
+	}
 
-		/* the image is guaranteed to start at or before
-		 * draw_start. But if it starts before draw_start, that reduces
-		 * the maximum available width we can render with.
-		 *
-		 * so .. clamp the draw width to the smaller of what we need to
-		 * draw or the available width of the image.
-		 */
-		draw_width_pixels = min ((double)image_to_draw->cairo_image->get_width (), draw_width_pixels);
+	/* reset this so that future missing images can be generated in a worker thread. */
+	_draw_image_in_gui_thread = false;
+	_rendered = true;
 
-		set_image (image_to_draw);
+	if (incomplete) {
+		redraw ();
 	}
+}
+
+double
+WaveView::sample_to_window_x (Rect const& self, Cairo::RefPtr<Cairo::Context> const& context, samplepos_t sample) const
+{
+	/* round to an exact pixel in device space to avoid blurring, and
+	 * gaps or overlaps between adjacent tiles.
+	 */
 
-	context->rectangle (draw_start_pixel, draw.y0, draw_width_pixels, draw.height());
+	double x = self.x0 + (sample - _props->region_start) / _props->samples_per_pixel;
+	double y = self.y0;
+	context->user_to_device (x, y);
+	x = floor (x);
+	context->device_to_user (x, y);
+	return x;
+}
 
-	/* round image origin position to an exact pixel in device space to
-	 * avoid blurring
+void
+WaveView::draw_tile (Cairo::RefPtr<Cairo::Context> const& context, Rect const& self, Rect const& area,
+                     boost::shared_ptr<WaveViewImage> const& image) const
+{
+	/* the image may be from a different zoom level, in which case it is
+	 * scaled horizontally to match ours.
 	 */
+	double const scale = image->props.samples_per_pixel / _props->samples_per_pixel;
 
-	double x  = self.x0 + image_origin_in_self_coordinates;
-	double y  = self.y0;
+	/* round image origin position to an exact pixel in device space, the
+	 * same way as sample_to_window_x() does.
+	 */
+	double x = self.x0 + (image->props.get_sample_start () - _props->region_start) / _props->samples_per_pixel;
+	double y = self.y0;
 	context->user_to_device (x, y);
 	x = floor (x);
 	y = floor (y);
 	context->device_to_user (x, y);
 
+	context->save ();
+	context->rectangle (area.x0, area.y0, area.width (), area.height ());
+	context->clip ();
+
 	/* the coordinates specify where in "user coordinates" (i.e. what we
 	 * generally call "canvas coordinates" in this code) the image origin
 	 * will appear. So specifying (10,10) will put the upper left corner of
 	 * the image at (10,10) in user space.
 	 */
+	context->translate (x, y);
+	if (scale != 1.0) {
+		context->scale (scale, 1.0);
+	}
+	context->set_source (image->cairo_image, 0, 0);
+	context->paint ();
+	context->restore ();
+}
 
-	context->set_source (image_to_draw->cairo_image, x, y);
-	context->fill ();
+bool
+WaveView::draw_scaled_tiles (Cairo::RefPtr<Cairo::Context> const& context, Rect const& self, Rect const& area,
+                             WaveViewProperties const& tile_props) const
+{
+	/* Find finished tiles of another zoom level, within a factor of two of
+	 * ours, that cover the same samples. Prefer the closest zoom level.
+	 */
+
+	double const spp = _props->samples_per_pixel;
+
+	std::vector<double> spp_candidates;
+	get_cache_group ()->get_samples_per_pixel (spp * 0.5, spp * 2.0, spp_candidates);
+
+	std::vector<std::pair<double, double> > ordered;
+	for (std::vector<double>::const_iterator i = spp_candidates.begin (); i != spp_candidates.end (); ++i) {
+		if (*i != spp) {
+			ordered.push_back (std::make_pair (fabs (log (*i / spp)), *i));
+		}
+	}
+	std::sort (ordered.begin (), ordered.end ());
+
+	for (std::vector<std::pair<double, double> >::const_iterator i = ordered.begin (); i != ordered.end (); ++i) {
+
+		WaveViewProperties props = tile_props;
+		props.samples_per_pixel = i->second;
+
+		int64_t const first_tile = props.tile_index_at (tile_props.get_sample_start ());
+		int64_t const last_tile = props.tile_index_at (tile_props.get_sample_end () - 1);
+
+		std::vector<boost::shared_ptr<WaveViewImage> > images;
+
+		for (int64_t index = first_tile; index <= last_tile; ++index) {
+			props.set_tile (index);
+
+			boost::shared_ptr<WaveViewImage> image = get_cache_group ()->lookup_image (props);
+
+			if (!image || !image->finished ()) {
+				break;
+			}
+			images.push_back (image);
+		}
+
+		if (images.size () != (size_t) (last_tile - first_tile + 1)) {
+			// only use complete coverage, so that no gaps are visible
+			continue;
+		}
+
+		for (std::vector<boost::shared_ptr<WaveViewImage> >::const_iterator im = images.begin (); im != images.end (); ++im) {
+			draw_tile (context, self, area, *im);
+		}
+		return true;
+	}
+
+	return false;
 }
 
 void
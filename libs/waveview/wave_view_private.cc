@@ -59,7 +59,7 @@ WaveViewImage::WaveViewImage (boost::shared_ptr<const ARDOUR::AudioRegion> const
                               WaveViewProperties const& properties)
 	: region (region_ptr)
 	, props (properties)
-	, timestamp (0)
+	, cache_group (0)
 {
 
 }
@@ -90,65 +90,72 @@ WaveViewCacheGroup::add_image (boost::shared_ptr<WaveViewImage> image)
 		return;
 	}
 
-	ImageCache::iterator oldest_image_it = _cached_images.begin();
-	ImageCache::iterator second_oldest_image_it = _cached_images.end();
+	if (image->cache_group) {
+		// Must never be more than one instance of the image in the cache
+		_parent_cache.touch (image);
+		return;
+	}
 
-	for (ImageCache::iterator it = _cached_images.begin (); it != _cached_images.end (); ++it) {
-		if ((*it) == image) {
-			// Must never be more than one instance of the image in the cache
-			(*it)->timestamp = g_get_monotonic_time ();
-			return;
-		} else if ((*it)->props.is_equivalent (image->props)) {
-			// Equivalent Image already in cache, updating timestamp
-			(*it)->timestamp = g_get_monotonic_time ();
+	const size_t hash = image->props.hash ();
+	std::pair<ImageCache::iterator, ImageCache::iterator> range = _cached_images.equal_range (hash);
+
+	for (ImageCache::iterator it = range.first; it != range.second; ++it) {
+		if (it->second->props.is_equivalent (image->props)) {
+			// Equivalent Image already in cache, mark it as recently used
+			_parent_cache.touch (it->second);
 			return;
 		}
+	}
+
+	_cached_images.insert (std::make_pair (hash, image));
+	++_samples_per_pixel[image->props.samples_per_pixel];
+
+	/* may evict images of this or any other group */
+	_parent_cache.insert (this, image);
+}
+
+boost::shared_ptr<WaveViewImage>
+WaveViewCacheGroup::lookup_image (WaveViewProperties const& props)
+{
+	std::pair<ImageCache::iterator, ImageCache::iterator> range = _cached_images.equal_range (props.hash ());
 
-		if ((*it)->timestamp < (*oldest_image_it)->timestamp) {
-			second_oldest_image_it = oldest_image_it;
-			oldest_image_it = it;
+	for (ImageCache::iterator it = range.first; it != range.second; ++it) {
+		if (it->second->props.is_equivalent (props)) {
+			_parent_cache.touch (it->second);
+			return it->second;
 		}
 	}
+	return boost::shared_ptr<WaveViewImage>();
+}
 
-	// no duplicate or equivalent image so we are definitely adding it to cache
-	image->timestamp = g_get_monotonic_time ();
+void
+WaveViewCacheGroup::remove_image (boost::shared_ptr<WaveViewImage> const& image)
+{
+	std::pair<ImageCache::iterator, ImageCache::iterator> range = _cached_images.equal_range (image->props.hash ());
 
-	if (_parent_cache.full () || full ()) {
-		if (oldest_image_it != _cached_images.end()) {
-			// Replacing oldest Image in cache
-			_parent_cache.decrease_size ((*oldest_image_it)->size_in_bytes ());
-			*oldest_image_it = image;
-			_parent_cache.increase_size (image->size_in_bytes ());
+	for (ImageCache::iterator it = range.first; it != range.second; ++it) {
+		if (it->second == image) {
+			_cached_images.erase (it);
 
-			if (second_oldest_image_it != _cached_images.end ()) {
-				// Removing second oldest Image in cache
-				_parent_cache.decrease_size ((*second_oldest_image_it)->size_in_bytes ());
-				_cached_images.erase (second_oldest_image_it);
+			std::map<double, uint32_t>::iterator spp = _samples_per_pixel.find (image->props.samples_per_pixel);
+			assert (spp != _samples_per_pixel.end ());
+			if (--spp->second == 0) {
+				_samples_per_pixel.erase (spp);
 			}
 			return;
-		} else {
-			/**
-			 * Add the image to the cache even if the threshold is exceeded so that
-			 * new WaveViews can still cache images with a full cache, the size of
-			 * the cache will quickly equalize back to the threshold as new images
-			 * are added and the size of the cache is reduced.
-			 */
 		}
 	}
-
-	_cached_images.push_back (image);
-	_parent_cache.increase_size (image->size_in_bytes ());
+	assert (false);
 }
 
-boost::shared_ptr<WaveViewImage>
-WaveViewCacheGroup::lookup_image (WaveViewProperties const& props)
+void
+WaveViewCacheGroup::get_samples_per_pixel (double min, double max, std::vector<double>& spp) const
 {
-	for (ImageCache::iterator i = _cached_images.begin (); i != _cached_images.end (); ++i) {
-		if ((*i)->props.is_equivalent (props)) {
-			return (*i);
-		}
+	std::map<double, uint32_t>::const_iterator i = _samples_per_pixel.lower_bound (min);
+
+	for (; i != _samples_per_pixel.end () && i->first <= max; ++i) {
+		spp.push_back (i->first);
 	}
-	return boost::shared_ptr<WaveViewImage>();
 }
 
 void
@@ -156,9 +163,10 @@ WaveViewCacheGroup::clear_cache ()
 {
 	// Tell the parent cache about the images we are about to drop references to
 	for (ImageCache::iterator it = _cached_images.begin (); it != _cached_images.end (); ++it) {
-		_parent_cache.decrease_size ((*it)->size_in_bytes ());
+		_parent_cache.remove (it->second);
 	}
 	_cached_images.clear ();
+	_samples_per_pixel.clear ();
 }
 
 /*-------------------------------------------------*/
@@ -182,17 +190,54 @@ WaveViewCache::get_instance ()
 }
 
 void
-WaveViewCache::increase_size (uint64_t bytes)
+WaveViewCache::insert (WaveViewCacheGroup* group, boost::shared_ptr<WaveViewImage> const& image)
 {
-	image_cache_size += bytes;
+	assert (!image->cache_group);
+
+	image->cache_group = group;
+	image->lru_position = _lru.insert (_lru.begin (), image);
+	image_cache_size += image->size_in_bytes ();
+
+	evict ();
 }
 
 void
-WaveViewCache::decrease_size (uint64_t bytes)
+WaveViewCache::touch (boost::shared_ptr<WaveViewImage> const& image)
 {
-	assert (bytes > 0);
+	assert (image->cache_group);
+
+	/* move to the front, this does not invalidate the iterator */
+	_lru.splice (_lru.begin (), _lru, image->lru_position);
+}
+
+void
+WaveViewCache::remove (boost::shared_ptr<WaveViewImage> const& image)
+{
+	assert (image->cache_group);
+
+	const size_t bytes = image->size_in_bytes ();
 	assert (bytes <= image_cache_size);
 	image_cache_size -= bytes;
+
+	image->cache_group = 0;
+	_lru.erase (image->lru_position);
+}
+
+void
+WaveViewCache::evict ()
+{
+	/* Drop the least recently used images of any group until the cache fits
+	 * the threshold again. The most recently used image is always kept, so
+	 * that even an image larger than the threshold can be displayed.
+	 * Images that are currently used by a WaveView or draw request are
+	 * kept alive by their owners.
+	 */
+	while (image_cache_size > _image_cache_threshold && _lru.size () > 1) {
+		/* copy, remove() erases the list element */
+		boost::shared_ptr<WaveViewImage> image (_lru.back ());
+		image->cache_group->remove_image (image);
+		remove (image);
+	}
 }
 
 boost::shared_ptr<WaveViewCacheGroup>
@@ -245,12 +290,27 @@ WaveViewCache::clear_cache ()
 	for (CacheGroups::iterator it = cache_group_map.begin (); it != cache_group_map.end (); ++it) {
 		(*it).second->clear_cache ();
 	}
+	assert (_lru.empty ());
+	assert (image_cache_size == 0);
 }
 
 void
 WaveViewCache::set_image_cache_threshold (uint64_t sz)
 {
 	_image_cache_threshold = sz;
+	evict ();
+}
+
+void
+WaveViewCache::discard_image (boost::shared_ptr<WaveViewImage> const& image)
+{
+	if (!image->cache_group) {
+		// already evicted
+		return;
+	}
+
+	image->cache_group->remove_image (image);
+	remove (image);
 }
 
 /*-------------------------------------------------*/
@@ -293,16 +353,69 @@ void
 WaveViewThreads::enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>& request)
 {
 	assert (instance);
-	instance->_enqueue_draw_request (request);
+	instance->_enqueue_draw_request (request, false);
+}
+
+void
+WaveViewThreads::enqueue_speculative_draw_request (boost::shared_ptr<WaveViewDrawRequest>& request)
+{
+	assert (instance);
+	instance->_enqueue_draw_request (request, true);
+}
+
+void
+WaveViewThreads::_enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>& request, bool speculative)
+{
+	boost::shared_ptr<WaveViewDrawRequest> dropped;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_queue_mutex);
+		if (speculative) {
+			/* tiles next to the visible ones are only useful while the view
+			 * stays where it is, drop the oldest when scrolling/zooming
+			 * faster than they can be rendered.
+			 */
+			if (_speculative_queue.size () >= max_speculative_requests) {
+				dropped = _speculative_queue.front ();
+				_speculative_queue.pop_front ();
+			}
+			_speculative_queue.push_back (request);
+		} else {
+			_queue.push_back (request);
+		}
+		/* wake one (random) thread */
+		_cond.signal ();
+	}
+
+	if (dropped) {
+		/* remove the never to be finished image from the cache, so that
+		 * it is requested again if it becomes visible.
+		 */
+		dropped->cancel ();
+		WaveViewCache::get_instance ()->discard_image (dropped->image);
+	}
+}
+
+void
+WaveViewThreads::promote_draw_request (boost::shared_ptr<WaveViewImage> const& image)
+{
+	assert (instance);
+	instance->_promote_draw_request (image);
 }
 
 void
-WaveViewThreads::_enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>& request)
+WaveViewThreads::_promote_draw_request (boost::shared_ptr<WaveViewImage> const& image)
 {
 	Glib::Threads::Mutex::Lock lm (_queue_mutex);
-	_queue.push_back (request);
-	/* wake one (random) thread */
-	_cond.signal ();
+
+	for (DrawRequestQueueType::iterator i = _speculative_queue.begin (); i != _speculative_queue.end (); ++i) {
+		if ((*i)->image == image) {
+			_queue.push_back (*i);
+			_speculative_queue.erase (i);
+			_cond.signal ();
+			return;
+		}
+	}
 }
 
 boost::shared_ptr<WaveViewDrawRequest>
@@ -319,7 +432,7 @@ WaveViewThreads::_dequeue_draw_request ()
 
 	assert (!_queue_mutex.trylock());
 
-	if (_queue.empty()) {
+	if (_queue.empty() && _speculative_queue.empty()) {
 		_cond.wait (_queue_mutex);
 	}
 
@@ -332,6 +445,10 @@ WaveViewThreads::_dequeue_draw_request ()
 	if (!_queue.empty()) {
 		req = _queue.front ();
 		_queue.pop_front ();
+	} else if (!_speculative_queue.empty()) {
+		/* only render images that are not visible yet when idle */
+		req = _speculative_queue.front ();
+		_speculative_queue.pop_front ();
 	}
 
 	return req;
@@ -21,6 +21,8 @@
 #ifndef _WAVEVIEW_WAVE_VIEW_H_
 #define _WAVEVIEW_WAVE_VIEW_H_
 
+#include <list>
+
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
 
@@ -165,8 +167,6 @@ private:
 
 	boost::scoped_ptr<WaveViewProperties> _props;
 
-	mutable boost::shared_ptr<WaveViewImage> _image;
-
 	mutable boost::shared_ptr<WaveViewCacheGroup> _cache_group;
 
 	bool _shape_independent;
@@ -185,10 +185,10 @@ private:
 	 */
 	ARDOUR::samplepos_t region_end () const;
 
-	/**
-	 * _image stays non-null after the first time it is set
-	 */
-	bool rendered () const { return _image.get(); }
+	/** true after the first call to render() */
+	mutable bool _rendered;
+
+	bool rendered () const { return _rendered; }
 
 	bool draw_image_in_gui_thread () const;
 
@@ -205,7 +205,10 @@ private:
 
 	void init();
 
-	mutable boost::shared_ptr<WaveViewDrawRequest> current_request;
+	/** Requests queued by this WaveView, that were not finished yet the
+	 * last time they were checked.
+	 */
+	mutable std::list<boost::shared_ptr<WaveViewDrawRequest> > _pending_requests;
 
 	PBD::ScopedConnectionList invalidation_connection;
 
@@ -238,10 +241,6 @@ private:
 	                        boost::shared_ptr<WaveViewDrawRequest>);
 	static void draw_absent_image (Cairo::RefPtr<Cairo::ImageSurface>&, ARDOUR::PeakData*, int);
 
-	ARDOUR::samplecnt_t optimal_image_width_samples () const;
-
-	void set_image (boost::shared_ptr<WaveViewImage> img) const;
-
 	// @return true if item area intersects with draw area
 	bool get_item_and_draw_rect_in_window_coords (ArdourCanvas::Rect const& canvas_rect,
 	                                              ArdourCanvas::Rect& item_area,
@@ -249,7 +248,36 @@ private:
 
 	boost::shared_ptr<WaveViewDrawRequest> create_draw_request (WaveViewProperties const&) const;
 
-	void queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const&) const;
+	void queue_draw_request (boost::shared_ptr<WaveViewDrawRequest> const&, bool speculative) const;
+
+	void queue_adjacent_draw_requests (int64_t first_tile, int64_t last_tile) const;
+
+	/** @return the cached tile with the given index, which may not be
+	 * finished yet. If the tile is not in the cache, it is queued for
+	 * drawing.
+	 */
+	boost::shared_ptr<WaveViewImage> get_tile (int64_t index, bool speculative) const;
+
+	/** Cancel the requests for tiles that do not match the current
+	 * properties anymore, and forget about finished requests.
+	 */
+	void cancel_stale_draw_requests () const;
+	void cancel_draw_request (boost::shared_ptr<WaveViewImage> const&) const;
+	void cancel_draw_requests () const;
+
+	double sample_to_window_x (ArdourCanvas::Rect const& self, Cairo::RefPtr<Cairo::Context> const&,
+	                           ARDOUR::samplepos_t) const;
+
+	void draw_tile (Cairo::RefPtr<Cairo::Context> const&, ArdourCanvas::Rect const& self,
+	                ArdourCanvas::Rect const& area, boost::shared_ptr<WaveViewImage> const&) const;
+
+	/** Draw tiles of a zoom level within a factor of two of the current
+	 * one, scaled to the current zoom level, while the exact tile is drawn.
+	 *
+	 * @return true if the area of the tile was covered
+	 */
+	bool draw_scaled_tiles (Cairo::RefPtr<Cairo::Context> const&, ArdourCanvas::Rect const& self,
+	                        ArdourCanvas::Rect const& area, WaveViewProperties const& tile_props) const;
 
 	static void process_draw_request (boost::shared_ptr<WaveViewDrawRequest>);
 
@@ -20,6 +20,12 @@
 #define _WAVEVIEW_WAVE_VIEW_PRIVATE_H_
 
 #include <deque>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "pbd/pthread_utils.h"
 #include "waveview/wave_view.h"
@@ -70,18 +76,6 @@ public: // methods
 		return (sample_end != 0 && samples_per_pixel != 0);
 	}
 
-	void set_width_samples (ARDOUR::samplecnt_t const width_samples)
-	{
-		assert (is_valid());
-		assert (width_samples != 0);
-		ARDOUR::samplecnt_t half_width = width_samples / 2;
-		samplepos_t new_sample_start = std::max (region_start, get_center_sample () - half_width);
-		samplepos_t new_sample_end = std::min (get_center_sample () + half_width, region_end);
-		assert (new_sample_start <= new_sample_end);
-		sample_start = new_sample_start;
-		sample_end = new_sample_end;
-	}
-
 	uint64_t get_width_pixels () const
 	{
 		return (uint64_t)std::max (1LL, llrint (ceil (get_length_samples () / samples_per_pixel)));
@@ -145,25 +139,84 @@ public: // methods
 		return sample_start + (get_length_samples() / 2);
 	}
 
+	/* Images are rendered as tiles of a fixed width in pixels, on a grid
+	 * that starts at the beginning of the source, so that regions using
+	 * the same source can share them.
+	 */
+	static const int tile_width_pixels = 512;
+
+	ARDOUR::samplecnt_t tile_length_samples () const
+	{
+		return std::max (1LL, llrint (tile_width_pixels * samples_per_pixel));
+	}
+
+	int64_t tile_index_at (samplepos_t pos) const
+	{
+		return pos / tile_length_samples ();
+	}
+
+	int64_t tile_index () const
+	{
+		return tile_index_at (sample_start);
+	}
+
+	void set_tile (int64_t index)
+	{
+		const ARDOUR::samplecnt_t length = tile_length_samples ();
+		set_sample_offsets (index * length, (index + 1) * length);
+	}
+
 	bool is_equivalent (WaveViewProperties const& other)
 	{
-		return (samples_per_pixel == other.samples_per_pixel &&
-		        contains (other.sample_start, other.sample_end) && channel == other.channel &&
+		return has_same_appearance (other) && contains (other.sample_start, other.sample_end);
+		// region_start && start_shift??
+	}
+
+	/** @return true if images with these properties look the same, for
+	 * the same range of samples.
+	 */
+	bool has_same_appearance (WaveViewProperties const& other) const
+	{
+		return (samples_per_pixel == other.samples_per_pixel && channel == other.channel &&
 		        height == other.height && amplitude == other.amplitude &&
 		        amplitude_above_axis == other.amplitude_above_axis && fill_color == other.fill_color &&
 		        outline_color == other.outline_color && zero_color == other.zero_color &&
 		        clip_color == other.clip_color && show_zero == other.show_zero &&
 		        logscaled == other.logscaled && shape == other.shape &&
 		        gradient_depth == other.gradient_depth);
-		// region_start && start_shift??
 	}
 
 	bool contains (samplepos_t start, samplepos_t end)
 	{
 		return (sample_start <= start && end <= sample_end);
 	}
+
+	/** @return a hash of all properties compared by has_same_appearance()
+	 * and the tile index, so equivalent tiles have the same hash.
+	 */
+	size_t hash () const
+	{
+		size_t seed = 0;
+		boost::hash_combine (seed, tile_index ());
+		boost::hash_combine (seed, samples_per_pixel);
+		boost::hash_combine (seed, channel);
+		boost::hash_combine (seed, height);
+		boost::hash_combine (seed, amplitude);
+		boost::hash_combine (seed, amplitude_above_axis);
+		boost::hash_combine (seed, fill_color);
+		boost::hash_combine (seed, outline_color);
+		boost::hash_combine (seed, zero_color);
+		boost::hash_combine (seed, clip_color);
+		boost::hash_combine (seed, show_zero);
+		boost::hash_combine (seed, logscaled);
+		boost::hash_combine (seed, (int) shape);
+		boost::hash_combine (seed, gradient_depth);
+		return seed;
+	}
 };
 
+class WaveViewCacheGroup;
+
 struct WaveViewImage {
 public: // ctors
 	WaveViewImage (boost::shared_ptr<const ARDOUR::AudioRegion> const& region_ptr,
@@ -175,7 +228,10 @@ public: // member variables
 	boost::weak_ptr<const ARDOUR::AudioRegion> region;
 	WaveViewProperties props;
 	Cairo::RefPtr<Cairo::ImageSurface> cairo_image;
-	uint64_t timestamp;
+
+	/* cache membership, managed by WaveViewCache */
+	WaveViewCacheGroup* cache_group;
+	std::list<boost::shared_ptr<WaveViewImage> >::iterator lru_position;
 
 public: // methods
 	bool finished() { return static_cast<bool>(cairo_image); }
@@ -190,10 +246,13 @@ public: // methods
 		return props.is_valid ();
 	}
 
-	size_t size_in_bytes ()
+	/** @return the size of the image surface, which is the same whether
+	 * or not it has been rendered yet.
+	 */
+	size_t size_in_bytes () const
 	{
-		// 4 = bytes per FORMAT_ARGB32 pixel
-		return props.height * props.get_width_pixels() * 4;
+		const int stride = Cairo::ImageSurface::format_stride_for_width (Cairo::FORMAT_ARGB32, props.get_width_pixels ());
+		return (size_t) stride * (size_t) std::max (0, (int) props.height);
 	}
 };
 
@@ -233,9 +292,10 @@ public:
 
 	void add_image (boost::shared_ptr<WaveViewImage>);
 
-	bool full () const { return _cached_images.size() > max_size(); }
-
-	static uint32_t max_size () { return 16; }
+	/** Get the distinct samples_per_pixel values of the cached images in
+	 * the range [min, max]
+	 */
+	void get_samples_per_pixel (double min, double max, std::vector<double>&) const;
 
 	void clear_cache ();
 
@@ -248,8 +308,16 @@ private:
 	 */
 	WaveViewCache& _parent_cache;
 
-	typedef std::list<boost::shared_ptr<WaveViewImage> > ImageCache;
+	friend class WaveViewCache;
+
+	void remove_image (boost::shared_ptr<WaveViewImage> const&);
+
+	/* images hashed by WaveViewProperties::hash() */
+	typedef boost::unordered_multimap<size_t, boost::shared_ptr<WaveViewImage> > ImageCache;
 	ImageCache _cached_images;
+
+	/* number of cached images for each samples_per_pixel value */
+	std::map<double, uint32_t> _samples_per_pixel;
 };
 
 class WaveViewCache
@@ -260,6 +328,9 @@ public:
 	uint64_t image_cache_threshold () const { return _image_cache_threshold; }
 	void set_image_cache_threshold (uint64_t);
 
+	/** Remove an image that will not be finished from the cache it is in */
+	void discard_image (boost::shared_ptr<WaveViewImage> const&);
+
 	void clear_cache ();
 
 	boost::shared_ptr<WaveViewCacheGroup> get_cache_group (boost::shared_ptr<ARDOUR::AudioSource>);
@@ -276,16 +347,20 @@ private:
 
 	CacheGroups cache_group_map;
 
+	/* all cached images of all groups, most recently used first */
+	typedef std::list<boost::shared_ptr<WaveViewImage> > ImageList;
+	ImageList _lru;
+
 	uint64_t image_cache_size;
 	uint64_t _image_cache_threshold;
 
 private:
 	friend class WaveViewCacheGroup;
 
-	void increase_size (uint64_t bytes);
-	void decrease_size (uint64_t bytes);
-
-	bool full () { return image_cache_size > _image_cache_threshold; }
+	void insert (WaveViewCacheGroup*, boost::shared_ptr<WaveViewImage> const&);
+	void touch (boost::shared_ptr<WaveViewImage> const&);
+	void remove (boost::shared_ptr<WaveViewImage> const&);
+	void evict ();
 };
 
 class WaveViewDrawingThread
@@ -315,6 +390,16 @@ public:
 
 	static void enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>&);
 
+	/** Queue a request for an image which is not visible yet, it is only
+	 * processed when there are no requests for visible images.
+	 */
+	static void enqueue_speculative_draw_request (boost::shared_ptr<WaveViewDrawRequest>&);
+
+	/** Move a speculative request for the given image to the main queue,
+	 * because the image has become visible.
+	 */
+	static void promote_draw_request (boost::shared_ptr<WaveViewImage> const&);
+
 private:
 	friend class WaveViewDrawingThread;
 
@@ -323,7 +408,8 @@ private:
 	static void thread_proc ();
 
 	boost::shared_ptr<WaveViewDrawRequest> _dequeue_draw_request ();
-	void _enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>&);
+	void _enqueue_draw_request (boost::shared_ptr<WaveViewDrawRequest>&, bool speculative);
+	void _promote_draw_request (boost::shared_ptr<WaveViewImage> const&);
 	void _thread_proc ();
 
 	void start_threads ();
@@ -345,6 +431,10 @@ private:
 
 	typedef std::deque<boost::shared_ptr<WaveViewDrawRequest> > DrawRequestQueueType;
 	DrawRequestQueueType _queue;
+	DrawRequestQueueType _speculative_queue;
+
+	/* max. number of queued speculative requests, older ones are dropped */
+	static const size_t max_speculative_requests = 32;
 };
 
 
@@ -0,0 +1,121 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+#include <glibmm.h>
+
+#include "pbd/xml++.h"
+
+using namespace std;
+
+static void usage () {
+	// help2man compatible format (standard GNU help-text)
+	printf (UTILNAME " - convert session state files between XML and binary.\n\n");
+	printf ("Usage: " UTILNAME " [ OPTIONS ] <src> <dst>\n\n");
+
+	printf ("Options:\n\
+  -b, --binary               write <dst> in the binary format\n\
+  -h, --help                 display this help and exit\n\
+  -x, --xml                  write <dst> as XML (default)\n\
+  -V, --version              print version information and exit\n\
+\n");
+
+	printf ("\n\
+This utility converts .ardour, .pending and .history files that were saved\n\
+with the \"binary-session-state\" preference to XML, so that they can be\n\
+edited or opened by older versions, and vice versa.\n\
+<src> may be in either format, <dst> is overwritten.\n\
+\n");
+
+	printf ("Report bugs to <http://tracker.ardour.org/>\n"
+	        "Website: <http://ardour.org/>\n");
+	::exit (EXIT_SUCCESS);
+}
+
+int main (int argc, char* argv[])
+{
+	const char *optstring = "bhxV";
+
+	const struct option longopts[] = {
+		{ "binary",       no_argument,       0, 'b' },
+		{ "help",         no_argument,       0, 'h' },
+		{ "xml",          no_argument,       0, 'x' },
+		{ "version",      no_argument,       0, 'V' },
+		{ 0, 0, 0, 0 },
+	};
+
+	int c = 0;
+	bool binary = false;
+
+	while (EOF != (c = getopt_long (argc, argv,
+					optstring, longopts, (int *) 0))) {
+		switch (c) {
+			case 'b':
+				binary = true;
+				break;
+
+			case 'h':
+				usage ();
+				break;
+
+			case 'x':
+				binary = false;
+				break;
+
+			case 'V':
+				printf ("ardour-utils version %s\n\n", VERSIONSTRING);
+				printf ("License GPLv2+\n");
+				exit (EXIT_SUCCESS);
+				break;
+
+			default:
+				cerr << "Error: unrecognized option. See --help for usage information.\n";
+				::exit (EXIT_FAILURE);
+				break;
+		}
+	}
+
+	if (optind + 2 > argc) {
+		cerr << "Error: Missing parameter. See --help for usage information.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	std::string src = argv[optind];
+	std::string dst = argv[optind + 1];
+
+	if (!Glib::file_test (src, Glib::FILE_TEST_IS_REGULAR)) {
+		fprintf (stderr, "source is not a regular file.\n");
+		exit (EXIT_FAILURE);
+	}
+
+	XMLTree tree;
+
+	if (!tree.read (src) || !tree.root ()) {
+		fprintf (stderr, "cannot read state from '%s'.\n", src.c_str ());
+		exit (EXIT_FAILURE);
+	}
+
+	tree.set_binary (binary);
+
+	if (!tree.write (dst)) {
+		fprintf (stderr, "cannot write state to '%s'.\n", dst.c_str ());
+		exit (EXIT_FAILURE);
+	}
+
+	return 0;
+}